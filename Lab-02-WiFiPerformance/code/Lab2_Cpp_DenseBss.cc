@@ -0,0 +1,545 @@
+// Lab 2: dense multi-BSS infrastructure network — network and simulator scaling
+// ------------------------------------------------------------------------------------
+// WHAT IT MEASURES:
+//   K access points on a square grid (--apSpacing m apart). Each AP has M
+//   stations dropped uniformly within --radius m around it. Each BSS has its
+//   own SSID and a 22 MHz 802.11b channel from --channels, the PHY of the
+//   other Lab 2 programs. Channels are handed out row-major and shifted by two
+//   per row, so with 1, 6, 11 no two horizontal or vertical grid neighbours
+//   share one. With a single channel every BSS is co-channel.
+//   --apSpacing against the propagation range sets how much co-channel BSSs
+//   overlap. The report counts, for every AP, the co-channel APs it hears above
+//   the -82 dBm CCA threshold.
+//
+//   Traffic is saturating UDP, STA -> AP (--direction=up) or AP -> STA (down).
+//   Each BSS is offered --load times the PHY rate, split over its STAs.
+//   Data and control frames use the --rate DSSS mode, as in Scenario 1/2, so
+//   the Bianchi prediction printed per case uses DcfParameters::Dsss(): the
+//   saturation goodput of one isolated BSS (M contenders uplink, the AP alone
+//   downlink). With --load >= 1 and no co-channel neighbour heard, a BSS
+//   should come close to it; the gap shows what the overlap costs.
+//
+//   Per case it prints:
+//     network   : aggregate goodput, per-BSS min/mean/max, Jain's index over
+//                 the BSSs, associated STAs;
+//     simulator : build and run wall time, wall seconds per simulated second,
+//                 events/s, RSS after the build, peak RSS and RSS growth per
+//                 simulated second.
+//   --aps and --stasPerAp take comma lists; every combination is one case, so
+//   one invocation gives a scaling curve (--scalingCsv).
+//
+// HOW TO RUN (from ns-3 root):
+//   ./ns3 run "scratch/Lab2_Cpp_DenseBss"
+//   ./ns3 run "scratch/Lab2_Cpp_DenseBss --aps=4,16,64 --stasPerAp=10 --channels=1,6,11 --scalingCsv=bss_scaling.csv"
+//   ./ns3 run "scratch/Lab2_Cpp_DenseBss --aps=9 --stasPerAp=5,10,20 --channels=1 --phy=spectrum --bssCsv=bss.csv"
+//
+// KEY FLAGS:
+//   --aps        : access points, or comma list (default 4)
+//   --stasPerAp  : STAs per AP, or comma list (default 10)
+//   --channels   : 2.4 GHz channel numbers (1-14) to reuse (default 1,6,11)
+//   --phy        : yans | spectrum (default yans)
+//   --apSpacing  : AP grid spacing in m (default 40)
+//   --radius     : STA drop radius around each AP in m (default 10)
+//   --rate       : 802.11b rate in Mbps, rounded up to 1/2/5.5/11 (default 11)
+//   --load       : offered load per BSS as a multiple of the PHY rate (default 1.0)
+//   --direction  : up | down (default up)
+//   --simTime    : seconds of traffic (default 5), after --startTime (default 1)
+//   --errorTable : use TabulatedErrorRateModel instead of NIST (default 0)
+//   --pool       : serve packets/events from the size-class pool (default 0)
+//   --bssCsv / --scalingCsv : optional per-BSS rows / one row per case
+// ------------------------------------------------------------------------------------
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/spectrum-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-bianchi.h"               // isolated-BSS saturation reference
+#include "lab-pool-allocator.h"        // size-class pool for packets/events (--pool)
+#include "lab-proc-stats.h"            // wall clock + RSS
+#include "lab-scenario.h"              // LabRate, SaturatingOnOff
+#include "lab-tabulated-error-rate.h"  // TabulatedErrorRateModel (--errorTable)
+#include "lab-startup-profiler.h"      // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+LAB_POOL_INSTALL_OPERATORS()
+
+static std::vector<uint32_t>
+ParseUintList(const std::string& csv)
+{
+  std::vector<uint32_t> out;
+  std::stringstream ss(csv);
+  std::string tok;
+  while (std::getline(ss, tok, ','))
+  {
+    if (!tok.empty())
+    {
+      out.push_back(static_cast<uint32_t>(std::stoul(tok)));
+    }
+  }
+  return out;
+}
+
+static double
+JainIndex(const std::vector<double>& x)
+{
+  double s = 0.0, s2 = 0.0;
+  for (double v : x)
+  {
+    s += v;
+    s2 += v * v;
+  }
+  return s2 > 0.0 ? s * s / (x.size() * s2) : 0.0;
+}
+
+// ---------- Scenario description / results ----------
+
+struct ScenarioConfig
+{
+  uint32_t    aps        = 4;
+  uint32_t    stasPerAp  = 10;
+  std::vector<uint32_t> channels{1, 6, 11};
+  std::string phy        = "yans";
+  double      apSpacing  = 40.0;
+  double      radius     = 10.0;
+  LabRate     rate       = LabRate::Dsss11;
+  double      load       = 1.0;
+  std::string direction  = "up";
+  double      simTime    = 5.0;
+  double      startTime  = 1.0;
+  uint32_t    seed       = 1;
+  bool        errorTable = false;
+  double      maxError   = 1e-4;
+};
+
+struct BssStats
+{
+  uint32_t channel;
+  Vector   pos;
+  uint32_t associated;  // STAs associated at the end of the run
+  uint32_t coChannel;   // co-channel APs heard above the CCA threshold
+  uint64_t rxBytes;
+};
+
+struct ScenarioResult
+{
+  uint32_t nodes;
+  double   buildWall;   // topology + install (s)
+  double   runWall;     // Simulator::Run (s)
+  double   simSeconds;  // simulated time (s)
+  uint64_t events;
+  uint64_t buildRssKb;  // RSS when Run starts
+  uint64_t peakRssKb;
+  std::vector<BssStats> perBss;
+};
+
+// Log-distance loss with exponent 3 (the ns-3 default) and the 1 m Friis loss
+// at 2.4 GHz; LogDistancePropagationLossModel's default reference loss is the
+// 5.15 GHz one. 16.0206 dBm is WifiPhy's default TxPowerStart.
+static const double kReferenceLossDb = 40.046;
+static const double kTxPowerDbm      = 16.0206;
+static const double kCcaDbm          = -82.0;
+
+static Ptr<LogDistancePropagationLossModel>
+CreateLoss()
+{
+  Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel>();
+  loss->SetAttribute("ReferenceLoss", DoubleValue(kReferenceLossDb));
+  return loss;
+}
+
+// ---------- One complete simulation ----------
+
+static ScenarioResult
+RunScenario(const ScenarioConfig& cfg)
+{
+  ScenarioResult res{};
+  ResetPeakRss();
+  const double t0 = GetWallClockSeconds();
+
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(cfg.seed);
+
+  const uint32_t k = cfg.aps;
+  const uint32_t m = cfg.stasPerAp;
+  const uint32_t cols = static_cast<uint32_t>(std::ceil(std::sqrt(double(k))));
+  const double simStop = cfg.startTime + cfg.simTime;
+
+  NodeContainer apNodes;
+  apNodes.Create(k);
+  std::vector<NodeContainer> staNodes(k);
+  for (auto& s : staNodes)
+  {
+    s.Create(m);
+  }
+
+  // ---------------- Channel / PHY ----------------
+  YansWifiPhyHelper yansPhy;
+  SpectrumWifiPhyHelper spectrumPhy;
+  if (cfg.phy == "spectrum")
+  {
+    Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->AddPropagationLossModel(CreateLoss());
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+    spectrumPhy.SetChannel(channel);
+  }
+  else
+  {
+    // One channel object for every BSS: YansWifiChannel only delivers a frame
+    // to PHYs tuned to the sender's channel number.
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel>();
+    channel->SetPropagationLossModel(CreateLoss());
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+    yansPhy.SetChannel(channel);
+  }
+  WifiPhyHelper& phy = (cfg.phy == "spectrum") ? static_cast<WifiPhyHelper&>(spectrumPhy)
+                                               : static_cast<WifiPhyHelper&>(yansPhy);
+  if (cfg.errorTable)
+  {
+    phy.SetErrorRateModel("ns3::TabulatedErrorRateModel",
+                          "Reference", StringValue("ns3::NistErrorRateModel"),
+                          "MaxError",  DoubleValue(cfg.maxError));
+  }
+
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_STANDARD_80211b);
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                               "DataMode",    WifiModeValue(ToWifiMode(cfg.rate)),
+                               "ControlMode", WifiModeValue(ToWifiMode(cfg.rate)));
+  WifiMacHelper mac;
+
+  // ---------------- Devices, positions, addresses per BSS ----------------
+  InternetStackHelper stack;
+  stack.Install(apNodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase("10.0.0.0", "255.255.255.0");
+  std::vector<Ipv4InterfaceContainer> apIf(k), staIf(k);
+  res.perBss.resize(k);
+
+  for (uint32_t b = 0; b < k; ++b)
+  {
+    const uint32_t col = b % cols;
+    const uint32_t row = b / cols;
+    BssStats& bss = res.perBss[b];
+    bss.channel = cfg.channels[(col + 2 * row) % cfg.channels.size()];
+    bss.pos = Vector(col * cfg.apSpacing, row * cfg.apSpacing, 0.0);
+
+    std::ostringstream settings;
+    settings << "{" << bss.channel << ", 22, BAND_2_4GHZ, 0}";
+    phy.Set("ChannelSettings", StringValue(settings.str()));
+
+    const Ssid ssid("lab2-bss-" + std::to_string(b));
+    mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+    NetDeviceContainer staDevs = wifi.Install(phy, mac, staNodes[b]);
+    mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+    NetDeviceContainer apDev = wifi.Install(phy, mac, apNodes.Get(b));
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    Ptr<ListPositionAllocator> apPos = CreateObject<ListPositionAllocator>();
+    apPos->Add(bss.pos);
+    mobility.SetPositionAllocator(apPos);
+    mobility.Install(apNodes.Get(b));
+    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
+                                  "X",   DoubleValue(bss.pos.x),
+                                  "Y",   DoubleValue(bss.pos.y),
+                                  "rho", DoubleValue(cfg.radius));
+    mobility.Install(staNodes[b]);
+
+    stack.Install(staNodes[b]);
+    apIf[b] = ipv4.Assign(apDev);
+    staIf[b] = ipv4.Assign(staDevs);
+    ipv4.NewNetwork();
+  }
+  // Static ARP: otherwise every STA starts with an ARP exchange, a burst that
+  // grows with the STA count and is not what this scenario measures.
+  NeighborCacheHelper arp;
+  arp.PopulateNeighborCache();
+
+  // ---------------- Co-channel overlap ----------------
+  Ptr<LogDistancePropagationLossModel> loss = CreateLoss();
+  for (uint32_t a = 0; a < k; ++a)
+  {
+    Ptr<MobilityModel> ma = apNodes.Get(a)->GetObject<MobilityModel>();
+    for (uint32_t b = 0; b < k; ++b)
+    {
+      if (a != b && res.perBss[a].channel == res.perBss[b].channel &&
+          loss->CalcRxPower(kTxPowerDbm, apNodes.Get(b)->GetObject<MobilityModel>(), ma) >= kCcaDbm)
+      {
+        ++res.perBss[a].coChannel;
+      }
+    }
+  }
+
+  // ---------------- Saturating UDP ----------------
+  const double phyBps = Info(cfg.rate).mbps * 1e6;
+  const uint64_t flowBps = static_cast<uint64_t>(cfg.load * phyBps / m);
+  const uint16_t port = 9;
+  PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+  std::vector<ApplicationContainer> sinks(k);
+  ApplicationContainer sources;
+  for (uint32_t b = 0; b < k; ++b)
+  {
+    for (uint32_t i = 0; i < m; ++i)
+    {
+      const bool up = (cfg.direction == "up");
+      Ptr<Node> src = up ? staNodes[b].Get(i) : apNodes.Get(b);
+      const Ipv4Address dst = up ? apIf[b].GetAddress(0) : staIf[b].GetAddress(i);
+      OnOffHelper on = SaturatingOnOff(InetSocketAddress(dst, port), DataRate(flowBps), 1000);
+      ApplicationContainer app = on.Install(src);
+      // Staggered by 10 us so the sources do not all fire in the same instant.
+      app.Start(Seconds(cfg.startTime) + MicroSeconds(10 * ((b * m + i) % 1000)));
+      app.Stop(Seconds(simStop));
+      sources.Add(app);
+      if (up)
+      {
+        if (i == 0)
+        {
+          sinks[b].Add(sinkHelper.Install(apNodes.Get(b)));
+        }
+      }
+      else
+      {
+        sinks[b].Add(sinkHelper.Install(staNodes[b].Get(i)));
+      }
+    }
+  }
+  for (auto& s : sinks)
+  {
+    s.Start(Seconds(0.0));
+  }
+
+  // ---------------- Run ----------------
+  res.nodes = NodeList::GetNNodes();
+  const double t1 = GetWallClockSeconds();
+  res.buildWall = t1 - t0;
+  res.buildRssKb = GetCurrentRssKb();
+  Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
+  Simulator::Run();
+  res.runWall = GetWallClockSeconds() - t1;
+  res.simSeconds = simStop;
+  res.events = Simulator::GetEventCount();
+  res.peakRssKb = GetPeakRssKb();
+
+  for (uint32_t b = 0; b < k; ++b)
+  {
+    BssStats& bss = res.perBss[b];
+    for (uint32_t i = 0; i < sinks[b].GetN(); ++i)
+    {
+      bss.rxBytes += DynamicCast<PacketSink>(sinks[b].Get(i))->GetTotalRx();
+    }
+    for (uint32_t i = 0; i < m; ++i)
+    {
+      Ptr<WifiNetDevice> dev = staNodes[b].Get(i)->GetDevice(0)->GetObject<WifiNetDevice>();
+      Ptr<StaWifiMac> staMac = DynamicCast<StaWifiMac>(dev->GetMac());
+      bss.associated += (staMac && staMac->IsAssociated()) ? 1 : 0;
+    }
+  }
+
+  Simulator::Destroy();
+  // Address pools are process-global; reset them for the next case.
+  Ipv4AddressGenerator::Reset();
+  return res;
+}
+
+// ---------- main: parse CLI, run every (aps, stasPerAp) case ----------
+
+int
+main(int argc, char* argv[])
+{
+  ScenarioConfig cfg;
+  std::string apsCsv      = "4";
+  std::string stasCsv     = "10";
+  std::string channelsCsv = "1,6,11";
+  double      rateMbps    = 11.0;
+  std::string bssCsv      = "";
+  std::string scalingCsv  = "";
+  bool        usePool     = false;
+
+  CommandLine cmd;
+  cmd.AddValue("aps",        "Access points, or comma list for a sweep.",               apsCsv);
+  cmd.AddValue("stasPerAp",  "STAs per AP, or comma list for a sweep.",                 stasCsv);
+  cmd.AddValue("channels",   "2.4 GHz channel numbers (1-14) reused over the grid.",    channelsCsv);
+  cmd.AddValue("phy",        "yans | spectrum.",                                        cfg.phy);
+  cmd.AddValue("apSpacing",  "AP grid spacing (m).",                                    cfg.apSpacing);
+  cmd.AddValue("radius",     "STA drop radius around each AP (m).",                     cfg.radius);
+  cmd.AddValue("rate",       "802.11b rate in Mbps (rounded up to 1, 2, 5.5, 11).",     rateMbps);
+  cmd.AddValue("load",       "Offered load per BSS as a multiple of the PHY rate.",     cfg.load);
+  cmd.AddValue("direction",  "up (STA -> AP) | down (AP -> STA).",                      cfg.direction);
+  cmd.AddValue("simTime",    "Seconds of traffic.",                                     cfg.simTime);
+  cmd.AddValue("startTime",  "Traffic start (s); association happens before.",          cfg.startTime);
+  cmd.AddValue("seed",       "RngRun value.",                                           cfg.seed);
+  cmd.AddValue("errorTable", "Use TabulatedErrorRateModel instead of NIST.",            cfg.errorTable);
+  cmd.AddValue("maxError",   "Table target on the chunk success rate error (--errorTable).", cfg.maxError);
+  cmd.AddValue("pool",       "Serve packets/events from the size-class pool.",          usePool);
+  cmd.AddValue("bssCsv",     "If non-empty, write per-BSS rows here.",                  bssCsv);
+  cmd.AddValue("scalingCsv", "If non-empty, write one scaling row per case here.",      scalingCsv);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
+  cfg.rate = DsssRateAtLeast(rateMbps);
+
+  const std::vector<uint32_t> apCounts = ParseUintList(apsCsv);
+  const std::vector<uint32_t> staCounts = ParseUintList(stasCsv);
+  cfg.channels = ParseUintList(channelsCsv);
+  if (apCounts.empty() || staCounts.empty() || cfg.channels.empty() ||
+      *std::min_element(apCounts.begin(), apCounts.end()) == 0 ||
+      *std::min_element(staCounts.begin(), staCounts.end()) == 0)
+  {
+    std::cerr << "ERROR: need --aps, --stasPerAp and --channels with entries >= 1.\n";
+    return 1;
+  }
+  if (*std::max_element(cfg.channels.begin(), cfg.channels.end()) > 14)
+  {
+    std::cerr << "ERROR: --channels must be 2.4 GHz channel numbers 1-14.\n";
+    return 1;
+  }
+  if (*std::max_element(staCounts.begin(), staCounts.end()) > 250 ||
+      *std::max_element(apCounts.begin(), apCounts.end()) > 65535)
+  {
+    std::cerr << "ERROR: at most 250 STAs per AP (one /24 per BSS) and 65535 APs.\n";
+    return 1;
+  }
+  if (cfg.phy != "yans" && cfg.phy != "spectrum")
+  {
+    std::cerr << "ERROR: --phy must be yans or spectrum.\n";
+    return 1;
+  }
+  if (cfg.direction != "up" && cfg.direction != "down")
+  {
+    std::cerr << "ERROR: --direction must be up or down.\n";
+    return 1;
+  }
+  if (cfg.simTime <= 0 || cfg.startTime < 0 || cfg.load <= 0 || cfg.apSpacing < 0 || cfg.radius < 0)
+  {
+    std::cerr << "ERROR: --simTime and --load must be > 0; --startTime, --apSpacing, --radius >= 0.\n";
+    return 1;
+  }
+  Time::SetResolution(Time::NS);
+
+  std::ofstream bssOfs, scaleOfs;
+  if (!bssCsv.empty())
+  {
+    bssOfs.open(bssCsv, std::ios::out | std::ios::trunc);
+    bssOfs << "phy,aps,stas_per_ap,bss,channel,x,y,co_channel_aps,associated,goodput_Mbps\n";
+  }
+  if (!scalingCsv.empty())
+  {
+    scaleOfs.open(scalingCsv, std::ios::out | std::ios::trunc);
+    scaleOfs << "phy,aps,stas_per_ap,channels,nodes,sim_s,build_s,run_s,wall_per_sim_s,events,"
+                "events_per_s,build_rss_kb,peak_rss_kb,rss_kb_per_sim_s,associated,goodput_Mbps,"
+                "bss_min_Mbps,bss_mean_Mbps,bss_max_Mbps,jain_bss,mean_co_channel_aps,"
+                "bianchi_bss_Mbps\n";
+  }
+
+  const bool single = apCounts.size() == 1 && staCounts.size() == 1;
+  for (uint32_t aps : apCounts)
+  {
+    for (uint32_t stas : staCounts)
+    {
+      cfg.aps = aps;
+      cfg.stasPerAp = stas;
+      std::cout << "\n==== Dense BSS: " << aps << " APs x " << stas << " STAs, " << cfg.channels.size()
+                << " channel(s), " << cfg.phy << ", " << Info(cfg.rate).name << ", " << cfg.direction
+                << "link ====\n";
+
+      const ScenarioResult r = RunScenario(cfg);
+      // One isolated, saturated BSS: every STA contends uplink, the AP alone downlink.
+      const DcfPrediction bianchi = BianchiSaturation(
+          DcfParameters::Dsss(Info(cfg.rate).mbps, 1000, false), cfg.direction == "up" ? stas : 1);
+      const double bianchiMbps = bianchi.throughputBps / 1e6;
+
+      std::vector<double> bssMbps;
+      uint64_t rx = 0;
+      uint32_t assoc = 0;
+      double coChannel = 0.0;
+      for (const BssStats& b : r.perBss)
+      {
+        bssMbps.push_back(b.rxBytes * 8.0 / cfg.simTime / 1e6);
+        rx += b.rxBytes;
+        assoc += b.associated;
+        coChannel += b.coChannel;
+      }
+      coChannel /= r.perBss.size();
+      const double total = rx * 8.0 / cfg.simTime / 1e6;
+      const double bssMin = *std::min_element(bssMbps.begin(), bssMbps.end());
+      const double bssMax = *std::max_element(bssMbps.begin(), bssMbps.end());
+      const double bssMean = total / aps;
+      const double jain = JainIndex(bssMbps);
+      const double wallPerSim = r.runWall / r.simSeconds;
+      const double evRate = r.runWall > 0 ? r.events / r.runWall : 0.0;
+      const double rssPerSim =
+          (r.peakRssKb > r.buildRssKb ? r.peakRssKb - r.buildRssKb : 0) / r.simSeconds;
+
+      std::cout << std::fixed << std::setprecision(3)
+                << "goodput=" << total << " Mb/s  per BSS min/mean/max=" << bssMin << "/" << bssMean
+                << "/" << bssMax << " Mb/s  Jain(BSS)=" << jain << "\n"
+                << "associated=" << assoc << "/" << aps * stas << std::setprecision(2)
+                << "  co-channel APs heard per AP=" << coChannel << "\n"
+                << std::setprecision(3) << "[Bianchi] isolated BSS, " << bianchi.stations
+                << " contender(s): " << bianchiMbps << " Mb/s (p=" << bianchi.p << ")\n"
+                << std::setprecision(3) << "nodes=" << r.nodes << "  build=" << r.buildWall
+                << " s  run=" << r.runWall << " s  wall/sim s=" << wallPerSim
+                << "  events=" << r.events << " (" << std::setprecision(0) << evRate << "/s)\n"
+                << "rss after build=" << r.buildRssKb / 1024 << " MiB  peak=" << r.peakRssKb / 1024
+                << " MiB  growth=" << std::setprecision(1) << rssPerSim / 1024 << " MiB/sim s\n";
+
+      if (single)
+      {
+        std::cout << std::setprecision(3) << "\n bss  chan        x        y  co-ch  assoc   Mb/s\n";
+        for (uint32_t b = 0; b < r.perBss.size(); ++b)
+        {
+          const BssStats& s = r.perBss[b];
+          std::cout << std::setw(4) << b << std::setw(6) << s.channel << std::setprecision(1)
+                    << std::setw(9) << s.pos.x << std::setw(9) << s.pos.y << std::setw(7)
+                    << s.coChannel << std::setw(7) << s.associated << std::setprecision(3)
+                    << std::setw(7) << bssMbps[b] << "\n";
+        }
+      }
+      if (bssOfs.is_open())
+      {
+        for (uint32_t b = 0; b < r.perBss.size(); ++b)
+        {
+          const BssStats& s = r.perBss[b];
+          bssOfs << cfg.phy << "," << aps << "," << stas << "," << b << "," << s.channel << ","
+                 << s.pos.x << "," << s.pos.y << "," << s.coChannel << "," << s.associated << ","
+                 << bssMbps[b] << "\n";
+        }
+      }
+      if (scaleOfs.is_open())
+      {
+        scaleOfs << cfg.phy << "," << aps << "," << stas << "," << cfg.channels.size() << ","
+                 << r.nodes << "," << r.simSeconds << "," << r.buildWall << "," << r.runWall << ","
+                 << wallPerSim << "," << r.events << "," << evRate << "," << r.buildRssKb << ","
+                 << r.peakRssKb << "," << rssPerSim << "," << assoc << "," << total << "," << bssMin
+                 << "," << bssMean << "," << bssMax << "," << jain << "," << coChannel << ","
+                 << bianchiMbps << "\n";
+        scaleOfs.flush();
+      }
+    }
+  }
+  if (!bssCsv.empty())
+  {
+    std::cout << "\nPer-BSS CSV written: " << bssCsv << "\n";
+  }
+  if (!scalingCsv.empty())
+  {
+    std::cout << "Scaling CSV written: " << scalingCsv << "\n";
+  }
+  return 0;
+}
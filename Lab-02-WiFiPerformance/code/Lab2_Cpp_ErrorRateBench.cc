@@ -0,0 +1,332 @@
+// Lab 2: Wi-Fi error-rate model benchmark — analytic vs tabulated chunk success rate
+// ------------------------------------------------------------------------------------
+// WHAT IT MEASURES:
+//   Every received frame is split into SNR chunks, and the PHY asks the
+//   ErrorRateModel for each chunk's success rate. This program compares
+//   NistErrorRateModel with TabulatedErrorRateModel (common/include/
+//   lab-tabulated-error-rate.h), which tabulates the same model per WifiMode.
+//
+//   --bench=chunk : GetChunkSuccessRate on --samples random (SNR, length) pairs,
+//                   SNR uniform in [-5, 35] dB, 1..1500-byte chunks, for every
+//                   802.11a OFDM rate and every 802.11b DSSS rate. Prints ns per
+//                   chunk, the speed-up, the largest |table - analytic| seen,
+//                   and the table's grid, size, build time and the largest
+//                   error Build() found at its sampled SNRs (a check, not a
+//                   proof).
+//                   DSSS rows go through the table's Lookup(). In ns-3.40 the
+//                   PHY sends DSSS chunks to DsssErrorRateModel before any
+//                   ErrorRateModel subclass is called, so only OFDM chunks use
+//                   the table inside a simulation.
+//   --bench=bss   : a dense, saturated 802.11a BSS: one AP and --stas STAs
+//                   dropped uniformly within --radius m, each sending uplink
+//                   UDP (aggregate offered load 2x the PHY rate). Every STA
+//                   hears every frame. The same run (same seed) is made with
+//                   each model. Prints wall time, events, aggregate goodput and
+//                   the speed-up; the goodput difference shows the effect of
+//                   the approximation.
+//   --bench=all   : both (default).
+//
+// HOW TO RUN (from ns-3 root):
+//   ./ns3 run "scratch/Lab2_Cpp_ErrorRateBench"
+//   ./ns3 run "scratch/Lab2_Cpp_ErrorRateBench --bench=bss --stas=100 --mode=OfdmRate24Mbps"
+//   ./ns3 run "scratch/Lab2_Cpp_ErrorRateBench --bench=chunk --maxError=1e-6 --csv=erbench.csv"
+//
+// KEY FLAGS:
+//   --maxError : table target on the chunk success rate error (default 1e-4)
+//   --samples  : chunks per mode in the chunk benchmark (default 1000000)
+//   --stas     : STAs in the BSS benchmark (default 50)
+//   --radius   : drop radius around the AP in m (default 30)
+//   --mode     : 802.11a rate of the BSS benchmark (default OfdmRate54Mbps)
+//   --simTime  : seconds of traffic in the BSS benchmark (default 5)
+//   --repeat   : timed repetitions of the chunk benchmark, fastest kept (default 5)
+//   --csv      : if non-empty, one row per (bench, case, model)
+// ------------------------------------------------------------------------------------
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lab-proc-stats.h"            // wall clock
+#include "lab-tabulated-error-rate.h"  // TabulatedErrorRateModel
+#include "lab-startup-profiler.h"      // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+static volatile double g_sink; // keeps the timed loops from being optimised away
+
+// Fastest of 'repeat' runs of fn(), in seconds.
+template <typename F>
+static double
+BestOf(uint32_t repeat, F&& fn)
+{
+  double best = 1e300;
+  for (uint32_t r = 0; r < repeat; ++r)
+  {
+    const double t0 = GetWallClockSeconds();
+    fn();
+    best = std::min(best, GetWallClockSeconds() - t0);
+  }
+  return best;
+}
+
+// ------------------------------ Chunk benchmark ----------------------------------
+static void
+BenchChunks(double maxError, uint32_t samples, uint32_t repeat, std::ostream* csv)
+{
+  const std::vector<WifiMode> modes = {
+      OfdmPhy::GetOfdmRate6Mbps(),  OfdmPhy::GetOfdmRate9Mbps(),  OfdmPhy::GetOfdmRate12Mbps(),
+      OfdmPhy::GetOfdmRate18Mbps(), OfdmPhy::GetOfdmRate24Mbps(), OfdmPhy::GetOfdmRate36Mbps(),
+      OfdmPhy::GetOfdmRate48Mbps(), OfdmPhy::GetOfdmRate54Mbps(), DsssPhy::GetDsssRate1Mbps(),
+      DsssPhy::GetDsssRate2Mbps(),  DsssPhy::GetDsssRate5_5Mbps(), DsssPhy::GetDsssRate11Mbps()};
+
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> uDb(-5.0, 35.0);
+  std::uniform_int_distribution<uint64_t> uBits(8, 8 * 1500);
+  std::vector<double> snr(samples);
+  std::vector<uint64_t> bits(samples);
+  for (uint32_t i = 0; i < samples; ++i)
+  {
+    snr[i] = std::pow(10.0, uDb(rng) / 10.0);
+    bits[i] = uBits(rng);
+  }
+
+  Ptr<ErrorRateModel> nist = CreateObject<NistErrorRateModel>();
+  Ptr<TabulatedErrorRateModel> tab = CreateObjectWithAttributes<TabulatedErrorRateModel>(
+      "Reference", StringValue("ns3::NistErrorRateModel"), "MaxError", DoubleValue(maxError));
+
+  std::cout << std::left << std::setw(18) << "mode" << std::right << std::setw(11) << "nist ns"
+            << std::setw(11) << "table ns" << std::setw(10) << "speedup" << std::setw(12)
+            << "max err" << std::setw(11) << "sampled" << std::setw(10) << "step dB" << std::setw(9)
+            << "bins" << std::setw(11) << "build ms" << "\n";
+  for (const WifiMode& mode : modes)
+  {
+    WifiTxVector txv;
+    txv.SetMode(mode);
+    txv.SetChannelWidth(mode.GetModulationClass() == WIFI_MOD_CLASS_OFDM ? 20 : 22);
+
+    const double t0 = GetWallClockSeconds();
+    const ErrorRateTable& table = tab->GetTable(mode, txv);
+    const double buildSec = GetWallClockSeconds() - t0;
+
+    const double nistSec = BestOf(repeat, [&] {
+      double acc = 0.0;
+      for (uint32_t i = 0; i < samples; ++i)
+      {
+        acc += nist->GetChunkSuccessRate(mode, txv, snr[i], bits[i]);
+      }
+      g_sink = acc;
+    });
+    const double tabSec = BestOf(repeat, [&] {
+      double acc = 0.0;
+      for (uint32_t i = 0; i < samples; ++i)
+      {
+        acc += tab->Lookup(mode, txv, snr[i], bits[i]);
+      }
+      g_sink = acc;
+    });
+    double err = 0.0;
+    for (uint32_t i = 0; i < samples; ++i)
+    {
+      err = std::max(err, std::abs(tab->Lookup(mode, txv, snr[i], bits[i]) -
+                                   nist->GetChunkSuccessRate(mode, txv, snr[i], bits[i])));
+    }
+    const double nistNs = nistSec * 1e9 / samples;
+    const double tabNs = tabSec * 1e9 / samples;
+    std::cout << std::left << std::setw(18) << mode.GetUniqueName() << std::right << std::fixed
+              << std::setprecision(1) << std::setw(11) << nistNs << std::setw(11) << tabNs
+              << std::setw(9) << nistNs / tabNs << "x" << std::scientific << std::setprecision(2)
+              << std::setw(12) << err << std::setw(11) << table.GetMaxError() << std::fixed
+              << std::setprecision(3) << std::setw(10) << table.GetStepDb() << std::setw(9)
+              << table.GetEntries() << std::setprecision(2) << std::setw(11) << buildSec * 1e3
+              << "\n";
+    if (csv)
+    {
+      (*csv) << "chunk," << mode.GetUniqueName() << ",nist," << nistNs << ",,\n";
+      (*csv) << "chunk," << mode.GetUniqueName() << ",table," << tabNs << "," << err << ",\n";
+    }
+  }
+  std::cout << "shared tables built: " << TabulatedErrorRateModel::GetSharedTables() << "\n";
+}
+
+// ------------------------------- BSS benchmark -----------------------------------
+struct BssResult
+{
+  double   wallSec;
+  uint64_t events;
+  double   goodputMbps;
+};
+
+static BssResult
+RunBss(bool tabulated, uint32_t stas, double radius, const std::string& mode, double simTime,
+       double maxError)
+{
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(1);
+
+  NodeContainer ap;  ap.Create(1);
+  NodeContainer sta; sta.Create(stas);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+  YansWifiPhyHelper phy;
+  phy.SetChannel(channel.Create());
+  if (tabulated)
+  {
+    phy.SetErrorRateModel("ns3::TabulatedErrorRateModel",
+                          "Reference", StringValue("ns3::NistErrorRateModel"),
+                          "MaxError",  DoubleValue(maxError));
+  }
+  else
+  {
+    phy.SetErrorRateModel("ns3::NistErrorRateModel");
+  }
+
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_STANDARD_80211a);
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                               "DataMode",    StringValue(mode),
+                               "ControlMode", StringValue("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  Ssid ssid("lab2-dense");
+  mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+  NetDeviceContainer staDevs = wifi.Install(phy, mac, sta);
+  mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+  NetDeviceContainer apDevs = wifi.Install(phy, mac, ap);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  mobility.Install(ap);
+  mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
+                                "rho", DoubleValue(radius));
+  mobility.Install(sta);
+
+  InternetStackHelper stack;
+  stack.Install(ap);
+  stack.Install(sta);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase("10.2.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer apIf = ipv4.Assign(apDevs);
+  ipv4.Assign(staDevs);
+
+  // Aggregate offered load = 2x the PHY rate, split over the STAs
+  const double phyBps = WifiMode(mode).GetDataRate(20);
+  OnOffHelper on("ns3::UdpSocketFactory", InetSocketAddress(apIf.GetAddress(0), 9));
+  on.SetAttribute("DataRate",   DataRateValue(DataRate(static_cast<uint64_t>(2.0 * phyBps / stas))));
+  on.SetAttribute("PacketSize", UintegerValue(1000));
+  on.SetAttribute("OnTime",     StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+  on.SetAttribute("OffTime",    StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+  ApplicationContainer src = on.Install(sta);
+  src.Start(Seconds(1.0));
+  src.Stop(Seconds(1.0 + simTime));
+
+  PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 9));
+  ApplicationContainer sink = sinkHelper.Install(ap);
+  sink.Start(Seconds(0.0));
+
+  Simulator::Stop(Seconds(1.0 + simTime));
+  const double t0 = GetWallClockSeconds();
+  StartupProfiler::Running();
+  Simulator::Run();
+  BssResult r;
+  r.wallSec = GetWallClockSeconds() - t0;
+  r.events = Simulator::GetEventCount();
+  r.goodputMbps = DynamicCast<PacketSink>(sink.Get(0))->GetTotalRx() * 8.0 / simTime / 1e6;
+  Simulator::Destroy();
+  return r;
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::string bench   = "all";
+  double   maxError   = 1e-4;
+  uint32_t samples    = 1000000;
+  uint32_t stas       = 50;
+  double   radius     = 30.0;
+  std::string mode    = "OfdmRate54Mbps";
+  double   simTime    = 5.0;
+  uint32_t repeat     = 5;
+  std::string csvPath = "";
+
+  CommandLine cmd;
+  cmd.AddValue("bench",    "chunk | bss | all.",                                   bench);
+  cmd.AddValue("maxError", "Table target on the chunk success rate error.",        maxError);
+  cmd.AddValue("samples",  "Chunks per mode in the chunk benchmark.",              samples);
+  cmd.AddValue("stas",     "STAs in the BSS benchmark.",                           stas);
+  cmd.AddValue("radius",   "Drop radius around the AP (m).",                       radius);
+  cmd.AddValue("mode",     "802.11a DataMode of the BSS benchmark.",               mode);
+  cmd.AddValue("simTime",  "Seconds of traffic in the BSS benchmark.",             simTime);
+  cmd.AddValue("repeat",   "Timed repetitions of the chunk benchmark.",            repeat);
+  cmd.AddValue("csv",      "If non-empty, write one row per bench/case/model.",    csvPath);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  if (bench != "chunk" && bench != "bss" && bench != "all")
+  {
+    std::cerr << "ERROR: --bench must be chunk, bss or all.\n";
+    return 1;
+  }
+  if (samples == 0 || stas == 0 || repeat == 0 || simTime <= 0 || maxError <= 0)
+  {
+    std::cerr << "ERROR: counts, --simTime and --maxError must be > 0.\n";
+    return 1;
+  }
+  Time::SetResolution(Time::NS);
+
+  std::ofstream ofs;
+  std::ostream* csv = nullptr;
+  if (!csvPath.empty())
+  {
+    ofs.open(csvPath, std::ios::trunc);
+    if (!ofs.is_open())
+    {
+      std::cerr << "ERROR: cannot open " << csvPath << "\n";
+      return 1;
+    }
+    ofs << "bench,case,model,ns_per_chunk_or_wall_s,max_err_or_goodput_mbps,events\n";
+    csv = &ofs;
+  }
+
+  if (bench == "chunk" || bench == "all")
+  {
+    std::cout << "\n=== Chunk success rate, NIST vs table (MaxError " << maxError << ") ===\n";
+    BenchChunks(maxError, samples, repeat, csv);
+  }
+  if (bench == "bss" || bench == "all")
+  {
+    std::cout << "\n=== Dense saturated BSS: 1 AP + " << stas << " STAs, " << mode << ", "
+              << simTime << " s ===\n";
+    const BssResult a = RunBss(false, stas, radius, mode, simTime, maxError);
+    const BssResult t = RunBss(true, stas, radius, mode, simTime, maxError);
+    for (const auto& row : {std::make_pair("nist", &a), std::make_pair("table", &t)})
+    {
+      const BssResult& r = *row.second;
+      std::cout << std::left << std::setw(8) << row.first << std::right << std::fixed
+                << std::setprecision(3) << "wall=" << r.wallSec << " s  events=" << r.events
+                << "  goodput=" << r.goodputMbps << " Mbps";
+      if (&r == &t)
+      {
+        std::cout << std::setprecision(2) << "  speedup=" << a.wallSec / r.wallSec << "x"
+                  << std::setprecision(3) << "  dGoodput=" << r.goodputMbps - a.goodputMbps
+                  << " Mbps";
+      }
+      std::cout << "\n";
+      if (csv)
+      {
+        (*csv) << "bss," << mode << "/" << stas << "," << row.first << "," << r.wallSec << ","
+               << r.goodputMbps << "," << r.events << "\n";
+      }
+    }
+  }
+  return 0;
+}
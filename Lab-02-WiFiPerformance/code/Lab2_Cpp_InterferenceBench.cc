@@ -0,0 +1,652 @@
+// Lab 2: interference bookkeeping benchmark — NiChange multimap vs flat pruned store
+// ------------------------------------------------------------------------------------
+// WHAT IT MEASURES:
+//   Every Wi-Fi receiver records each signal it hears, and at the end of a frame
+//   it walks those records to get the interference over each SNR chunk. The
+//   program replays the signals every receiver of a dense network hears through
+//   two implementations of that bookkeeping:
+//     multimap : InterferenceHelper's layout. A std::multimap of NiChange
+//                entries, pruned only when a signal arrives while the PHY is
+//                idle.
+//     flat     : InterferenceStore (below). Same entries and arithmetic,
+//                kept in a sorted array and pruned on every Add, so the SNIR
+//                of every chunk is bit-identical to the multimap's.
+//   Each receiver locks onto the first signal above --rxSensitivity that arrives
+//   while it is idle, and its chunks are evaluated at the frame's end. The
+//   program prints the replay time per signal, the speed-up, and the largest
+//   list either store held. It also hashes every chunk (times and SNIR bits) to
+//   show that both stores give the same SNIR sequence.
+//
+//   --trace=bss     : transmissions logged from a saturated 802.11a BSS (one AP,
+//                     --stas STAs within --radius m, uplink UDP at twice the PHY
+//                     rate). Every PHY's PhyTxPsduBegin is traced and the frame
+//                     duration comes from WifiPhy::CalculateTxDuration.
+//   --trace=poisson : hidden-terminal stress. --stas transmitters within
+//                     --radius m send frames of 100..2000 us with no carrier
+//                     sense, as a Poisson process of --load frames per frame time.
+//   --trace=all     : both (default).
+//   Received powers use the log-distance model of YansWifiChannelHelper::Default
+//   (exponent 3, 46.6777 dB at 1 m). The delay is distance / c.
+//
+// SCOPE, read first: this is a replay experiment, not a faster simulation. No
+//   PHY uses the flat store. In ns-3.40 the NiChange maps are private members
+//   of InterferenceHelper and its Add / CalculateSnr path is not virtual, so a
+//   subclass installed with WifiPhy::SetInterferenceHelper would still do the
+//   multimap bookkeeping. Lab2 Scenario 2, the dense BSS and the Lab 3 runs
+//   therefore simulate exactly as before; the numbers here only say what the
+//   layout would save if ns-3 let it in.
+//
+// HOW TO RUN (from ns-3 root):
+//   ./ns3 run "scratch/Lab2_Cpp_InterferenceBench"
+//   ./ns3 run "scratch/Lab2_Cpp_InterferenceBench --trace=poisson --stas=200 --load=4"
+//   ./ns3 run "scratch/Lab2_Cpp_InterferenceBench --trace=bss --stas=100 --csv=ni.csv"
+//
+// KEY FLAGS:
+//   --stas          : STAs / transmitters (default 50)
+//   --radius        : drop radius in m (default 30)
+//   --mode          : 802.11a rate of the bss trace (default OfdmRate54Mbps)
+//   --simTime       : seconds of traffic (default 5)
+//   --load          : poisson trace offered load in frames on the air (default 2)
+//   --receivers     : receivers replayed, 0 = every node (default 0)
+//   --rxSensitivity : lock threshold in dBm (default -101, WifiPhy's default)
+//   --repeat        : timed repetitions, fastest kept (default 3)
+//   --csv           : if non-empty, one row per (trace, store)
+// ------------------------------------------------------------------------------------
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-proc-stats.h"          // wall clock
+#include "lab-startup-profiler.h"    // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+// Fastest of 'repeat' runs of fn(), in seconds.
+template <typename F>
+static double
+BestOf(uint32_t repeat, F&& fn)
+{
+  double best = 1e300;
+  for (uint32_t r = 0; r < repeat; ++r)
+  {
+    const double t0 = GetWallClockSeconds();
+    fn();
+    best = std::min(best, GetWallClockSeconds() - t0);
+  }
+  return best;
+}
+
+// ------------------------------ Flat store ---------------------------------------
+
+// InterferenceHelper's entries and arithmetic in a flat array sorted by time.
+// Each entry's power is the running sum of the +P/-P steps before it,
+// materialised in the order InterferenceHelper adds them (a rebuilt prefix sum
+// or segment tree would change the last bits of the SNIR). Lookups are binary
+// searches; a new signal starts "now", so its entries land near the tail. On
+// every Add, entries older than the frame being received (or "now" when idle)
+// are dropped. Times are integer nanoseconds.
+class InterferenceStore
+{
+public:
+  struct Signal
+  {
+    uint64_t id;
+    int64_t  start;
+    int64_t  end;
+    double   powerW;
+  };
+
+  // Adds a signal on [start, end). Signals arrive in non-decreasing start order.
+  Signal Add(int64_t start, int64_t end, double powerW)
+  {
+    const Signal s{m_nextId++, start, end, powerW};
+    Prune(m_rxing ? m_rx.start : start);
+
+    const size_t first = UpperBound(start);
+    const double powerStart = PowerBefore(first);
+    const size_t endPos = UpperBound(end);
+    const double powerEnd = PowerBefore(endPos);
+
+    m_changes.insert(m_changes.begin() + first, Change{start, powerStart, s.id});
+    const size_t last = endPos + 1; // shifted by the start entry
+    m_changes.insert(m_changes.begin() + last, Change{end, powerEnd, s.id});
+    for (size_t i = first; i < last; ++i)
+    {
+      m_changes[i].power += powerW;
+    }
+    m_peak = std::max(m_peak, m_changes.size() - m_head);
+    return s;
+  }
+
+  void NotifyRxStart(const Signal& s)
+  {
+    m_rxing = true;
+    m_rx = s;
+  }
+
+  void NotifyRxEnd() { m_rxing = false; }
+
+  // Interference seen by 's' (every other signal, no thermal noise) over each
+  // chunk of constant power: fn(chunkStart, chunkEnd, interferenceW).
+  template <typename F>
+  void ForEachChunk(const Signal& s, F&& fn) const
+  {
+    size_t i = LowerBound(s.start);
+    while (i < m_changes.size() && m_changes[i].id != s.id)
+    {
+      ++i;
+    }
+    if (i == m_changes.size())
+    {
+      return; // pruned: the signal was not being received
+    }
+    int64_t t = s.start;
+    double ni = m_changes[i].power - s.powerW;
+    for (++i; i < m_changes.size() && m_changes[i].id != s.id; ++i)
+    {
+      if (m_changes[i].time > t)
+      {
+        fn(t, m_changes[i].time, ni);
+        t = m_changes[i].time;
+      }
+      ni = m_changes[i].power - s.powerW;
+    }
+    if (s.end > t)
+    {
+      fn(t, s.end, ni);
+    }
+  }
+
+  // Entries currently held / largest count so far.
+  size_t GetSize() const { return m_changes.size() - m_head; }
+  size_t GetPeakSize() const { return m_peak; }
+
+private:
+  struct Change
+  {
+    int64_t  time;
+    double   power; // total power on the air from 'time' on
+    uint64_t id;
+  };
+
+  size_t UpperBound(int64_t t) const
+  {
+    return std::upper_bound(m_changes.begin() + m_head, m_changes.end(), t,
+                            [](int64_t v, const Change& c) { return v < c.time; }) -
+           m_changes.begin();
+  }
+
+  size_t LowerBound(int64_t t) const
+  {
+    return std::lower_bound(m_changes.begin() + m_head, m_changes.end(), t,
+                            [](const Change& c, int64_t v) { return c.time < v; }) -
+           m_changes.begin();
+  }
+
+  // Power in effect just before entry 'pos'.
+  double PowerBefore(size_t pos) const { return pos > m_head ? m_changes[pos - 1].power : m_first; }
+
+  // Drops every entry before 'horizon'; the power in effect there is kept.
+  void Prune(int64_t horizon)
+  {
+    const size_t keep = LowerBound(horizon);
+    if (keep == m_head)
+    {
+      return;
+    }
+    m_first = m_changes[keep - 1].power;
+    m_head = keep;
+    if (m_head >= 256 && 2 * m_head >= m_changes.size())
+    {
+      m_changes.erase(m_changes.begin(), m_changes.begin() + m_head);
+      m_head = 0;
+    }
+  }
+
+  std::vector<Change> m_changes; // sorted by time; equal times in insertion order
+  size_t   m_head{0};            // first live entry
+  double   m_first{0.0};         // power in effect before m_changes[m_head]
+  uint64_t m_nextId{1};
+  bool     m_rxing{false};
+  Signal   m_rx{};
+  size_t   m_peak{0};
+};
+
+// ------------------------------ Reference store ----------------------------------
+
+// InterferenceHelper's bookkeeping for one band, same interface as InterferenceStore.
+class NiChangeMultimap
+{
+public:
+  using Signal = InterferenceStore::Signal;
+
+  Signal Add(int64_t start, int64_t end, double powerW)
+  {
+    const Signal s{m_nextId++, start, end, powerW};
+    auto prevStart = Previous(start);
+    const double powerStart = (prevStart == m_changes.end()) ? m_first : prevStart->second.power;
+    auto prevEnd = Previous(end);
+    const double powerEnd = (prevEnd == m_changes.end()) ? m_first : prevEnd->second.power;
+    if (!m_rxing && prevStart != m_changes.end())
+    {
+      m_first = powerStart;
+      m_changes.erase(m_changes.begin(), std::next(prevStart));
+    }
+    auto first = m_changes.insert(m_changes.upper_bound(start), {start, Change{powerStart, s.id}});
+    auto last = m_changes.insert(m_changes.upper_bound(end), {end, Change{powerEnd, s.id}});
+    for (auto i = first; i != last; ++i)
+    {
+      i->second.power += powerW;
+    }
+    m_peak = std::max(m_peak, m_changes.size());
+    return s;
+  }
+
+  void NotifyRxStart(const Signal&) { m_rxing = true; }
+  void NotifyRxEnd() { m_rxing = false; }
+
+  template <typename F>
+  void ForEachChunk(const Signal& s, F&& fn) const
+  {
+    auto i = m_changes.find(s.start);
+    while (i != m_changes.end() && i->second.id != s.id)
+    {
+      ++i;
+    }
+    if (i == m_changes.end())
+    {
+      return;
+    }
+    int64_t t = s.start;
+    double ni = i->second.power - s.powerW;
+    for (++i; i != m_changes.end() && i->second.id != s.id; ++i)
+    {
+      if (i->first > t)
+      {
+        fn(t, i->first, ni);
+        t = i->first;
+      }
+      ni = i->second.power - s.powerW;
+    }
+    if (s.end > t)
+    {
+      fn(t, s.end, ni);
+    }
+  }
+
+  size_t GetPeakSize() const { return m_peak; }
+
+private:
+  struct Change
+  {
+    double   power;
+    uint64_t id;
+  };
+  using Map = std::multimap<int64_t, Change>;
+
+  // Last entry at or before t (InterferenceHelper::GetPreviousPosition).
+  Map::iterator Previous(int64_t t)
+  {
+    auto it = m_changes.upper_bound(t);
+    return it == m_changes.begin() ? m_changes.end() : std::prev(it);
+  }
+
+  Map      m_changes;
+  double   m_first{0.0};
+  uint64_t m_nextId{1};
+  bool     m_rxing{false};
+  size_t   m_peak{0};
+};
+
+// ------------------------------ Traces --------------------------------------------
+
+struct TxRecord
+{
+  int64_t  start;   // ns
+  int64_t  dur;     // ns
+  uint32_t sender;
+  double   txDbm;
+};
+
+struct RxSignal
+{
+  int64_t start;
+  int64_t end;
+  double  powerW;
+};
+
+struct Trace
+{
+  std::vector<Vector>   pos;  // per node
+  std::vector<TxRecord> tx;   // in start order
+};
+
+// YansWifiChannelHelper::Default(): log-distance, exponent 3, 46.6777 dB at 1 m.
+static double
+RxPowerDbm(double txDbm, const Vector& a, const Vector& b)
+{
+  const double d = CalculateDistance(a, b);
+  return d <= 1.0 ? txDbm - 46.6777 : txDbm - 46.6777 - 30.0 * std::log10(d);
+}
+
+// What node 'rx' hears, in arrival order.
+static std::vector<RxSignal>
+SignalsAt(const Trace& trace, uint32_t rx)
+{
+  std::vector<RxSignal> out;
+  out.reserve(trace.tx.size());
+  for (const TxRecord& t : trace.tx)
+  {
+    if (t.sender == rx)
+    {
+      continue;
+    }
+    const Vector& a = trace.pos[t.sender];
+    const Vector& b = trace.pos[rx];
+    const int64_t delay = static_cast<int64_t>(std::llround(CalculateDistance(a, b) / 0.299792458));
+    const double w = std::pow(10.0, (RxPowerDbm(t.txDbm, a, b) - 30.0) / 10.0);
+    out.push_back(RxSignal{t.start + delay, t.start + delay + t.dur, w});
+  }
+  std::stable_sort(out.begin(), out.end(),
+                   [](const RxSignal& x, const RxSignal& y) { return x.start < y.start; });
+  return out;
+}
+
+static void
+OnTxPsdu(Trace* trace, uint32_t sender, Ptr<WifiPhy> phy, WifiConstPsduMap psdus,
+         WifiTxVector txVector, double txPowerW)
+{
+  const Time dur = WifiPhy::CalculateTxDuration(psdus, txVector, phy->GetPhyBand());
+  trace->tx.push_back(TxRecord{Simulator::Now().GetNanoSeconds(), dur.GetNanoSeconds(), sender,
+                               10.0 * std::log10(txPowerW) + 30.0});
+}
+
+// Transmissions of a saturated uplink BSS, as in Lab2_Cpp_ErrorRateBench --bench=bss.
+static Trace
+BssTrace(uint32_t stas, double radius, const std::string& mode, double simTime)
+{
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(1);
+
+  NodeContainer ap;  ap.Create(1);
+  NodeContainer sta; sta.Create(stas);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+  YansWifiPhyHelper phy;
+  phy.SetChannel(channel.Create());
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_STANDARD_80211a);
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                               "DataMode",    StringValue(mode),
+                               "ControlMode", StringValue("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  Ssid ssid("lab2-dense");
+  mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+  NetDeviceContainer staDevs = wifi.Install(phy, mac, sta);
+  mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+  NetDeviceContainer apDevs = wifi.Install(phy, mac, ap);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  mobility.Install(ap);
+  mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator", "rho", DoubleValue(radius));
+  mobility.Install(sta);
+
+  InternetStackHelper stack;
+  stack.Install(ap);
+  stack.Install(sta);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase("10.2.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer apIf = ipv4.Assign(apDevs);
+  ipv4.Assign(staDevs);
+
+  const double phyBps = WifiMode(mode).GetDataRate(20);
+  OnOffHelper on("ns3::UdpSocketFactory", InetSocketAddress(apIf.GetAddress(0), 9));
+  on.SetAttribute("DataRate",   DataRateValue(DataRate(static_cast<uint64_t>(2.0 * phyBps / stas))));
+  on.SetAttribute("PacketSize", UintegerValue(1000));
+  on.SetAttribute("OnTime",     StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+  on.SetAttribute("OffTime",    StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+  ApplicationContainer src = on.Install(sta);
+  src.Start(Seconds(1.0));
+  src.Stop(Seconds(1.0 + simTime));
+  PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 9));
+  sinkHelper.Install(ap).Start(Seconds(0.0));
+
+  Trace trace;
+  NodeContainer all(ap, sta);
+  for (uint32_t i = 0; i < all.GetN(); ++i)
+  {
+    trace.pos.push_back(all.Get(i)->GetObject<MobilityModel>()->GetPosition());
+    Ptr<WifiPhy> p = DynamicCast<WifiNetDevice>(all.Get(i)->GetDevice(0))->GetPhy();
+    p->TraceConnectWithoutContext("PhyTxPsduBegin", MakeBoundCallback(&OnTxPsdu, &trace, i, p));
+  }
+  Simulator::Stop(Seconds(1.0 + simTime));
+  StartupProfiler::Running();
+  Simulator::Run();
+  Simulator::Destroy();
+  return trace;
+}
+
+// Unslotted ALOHA: nobody senses the medium, so frames overlap freely.
+static Trace
+PoissonTrace(uint32_t nodes, double radius, double load, double simTime)
+{
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> u01(0.0, 1.0);
+  Trace trace;
+  for (uint32_t i = 0; i < nodes; ++i)
+  {
+    const double r = radius * std::sqrt(u01(rng));
+    const double a = 2.0 * M_PI * u01(rng);
+    trace.pos.emplace_back(r * std::cos(a), r * std::sin(a), 1.5);
+  }
+  const double meanDurNs = 1050e3; // 100..2000 us
+  std::exponential_distribution<double> gap(load / meanDurNs);
+  std::uniform_int_distribution<int64_t> dur(100000, 2000000);
+  std::uniform_int_distribution<uint32_t> who(0, nodes - 1);
+  for (double t = 0.0; t < simTime * 1e9; t += gap(rng))
+  {
+    trace.tx.push_back(TxRecord{static_cast<int64_t>(t), dur(rng), who(rng), 16.0206});
+  }
+  return trace;
+}
+
+// ------------------------------ Replay --------------------------------------------
+
+struct ReplayResult
+{
+  uint64_t signals{0};
+  uint64_t frames{0};  // frames locked onto and evaluated
+  uint64_t chunks{0};
+  uint64_t hash{1469598103934665603ULL};
+  size_t   peak{0};
+};
+
+static inline void
+Mix(uint64_t& h, uint64_t v)
+{
+  h = (h ^ v) * 1099511628211ULL;
+}
+
+// One receiver's PHY: lock onto the first signal above the threshold while idle,
+// evaluate its chunks when it ends.
+template <typename Store>
+static void
+ReplayReceiver(const std::vector<RxSignal>& sigs, double thresholdW, double noiseW,
+               ReplayResult& res)
+{
+  using Signal = InterferenceStore::Signal;
+  Store store;
+  bool locked = false;
+  Signal rx{};
+  auto finish = [&]() {
+    store.ForEachChunk(rx, [&](int64_t t0, int64_t t1, double ni) {
+      const double snr = rx.powerW / (noiseW + ni);
+      uint64_t bits;
+      std::memcpy(&bits, &snr, sizeof bits);
+      Mix(res.hash, static_cast<uint64_t>(t0));
+      Mix(res.hash, static_cast<uint64_t>(t1));
+      Mix(res.hash, bits);
+      ++res.chunks;
+    });
+    store.NotifyRxEnd();
+    locked = false;
+    ++res.frames;
+  };
+  for (const RxSignal& s : sigs)
+  {
+    if (locked && rx.end <= s.start)
+    {
+      finish();
+    }
+    const Signal added = store.Add(s.start, s.end, s.powerW);
+    if (!locked && s.powerW >= thresholdW)
+    {
+      rx = added;
+      locked = true;
+      store.NotifyRxStart(rx);
+    }
+    ++res.signals;
+  }
+  if (locked)
+  {
+    finish();
+  }
+  res.peak = std::max(res.peak, store.GetPeakSize());
+}
+
+template <typename Store>
+static ReplayResult
+Replay(const std::vector<std::vector<RxSignal>>& perRx, double thresholdW, double noiseW)
+{
+  ReplayResult res;
+  for (const std::vector<RxSignal>& sigs : perRx)
+  {
+    ReplayReceiver<Store>(sigs, thresholdW, noiseW, res);
+  }
+  return res;
+}
+
+static void
+BenchTrace(const std::string& name, const Trace& trace, uint32_t receivers, double rxSensDbm,
+           uint32_t repeat, std::ofstream* csv)
+{
+  const uint32_t n = receivers ? std::min<uint32_t>(receivers, trace.pos.size()) : trace.pos.size();
+  std::vector<std::vector<RxSignal>> perRx;
+  for (uint32_t r = 0; r < n; ++r)
+  {
+    perRx.push_back(SignalsAt(trace, r));
+  }
+  const double thresholdW = std::pow(10.0, (rxSensDbm - 30.0) / 10.0);
+  const double noiseW = std::pow(10.0, (-174.0 + 10.0 * std::log10(20e6) + 7.0 - 30.0) / 10.0);
+
+  ReplayResult a, b;
+  const double ta = BestOf(repeat, [&] { a = Replay<NiChangeMultimap>(perRx, thresholdW, noiseW); });
+  const double tb = BestOf(repeat, [&] { b = Replay<InterferenceStore>(perRx, thresholdW, noiseW); });
+
+  std::cout << "\n[" << name << "] " << trace.tx.size() << " transmissions, " << n
+            << " receivers, " << a.signals << " signals, " << a.frames << " frames, "
+            << a.chunks << " chunks\n";
+  for (const auto& row : {std::make_pair("multimap", std::make_pair(&a, ta)),
+                          std::make_pair("flat", std::make_pair(&b, tb))})
+  {
+    const ReplayResult& r = *row.second.first;
+    const double sec = row.second.second;
+    std::cout << std::left << std::setw(10) << row.first << std::right << std::fixed
+              << std::setprecision(1) << std::setw(8) << sec * 1e9 / r.signals << " ns/signal"
+              << "  peak entries=" << r.peak;
+    if (&r == &b)
+    {
+      std::cout << std::setprecision(2) << "  speedup=" << ta / tb << "x"
+                << "  identical=" << ((a.hash == b.hash && a.chunks == b.chunks) ? "yes" : "NO");
+    }
+    std::cout << "\n";
+    if (csv)
+    {
+      (*csv) << name << "," << row.first << "," << r.signals << "," << r.chunks << ","
+             << sec * 1e9 / r.signals << "," << r.peak << "," << std::hex << r.hash << std::dec
+             << "\n";
+    }
+  }
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::string trace   = "all";
+  uint32_t stas       = 50;
+  double   radius     = 30.0;
+  std::string mode    = "OfdmRate54Mbps";
+  double   simTime    = 5.0;
+  double   load       = 2.0;
+  uint32_t receivers  = 0;
+  double   rxSens     = -101.0;
+  uint32_t repeat     = 3;
+  std::string csvPath = "";
+
+  CommandLine cmd;
+  cmd.AddValue("trace",         "bss | poisson | all.",                                trace);
+  cmd.AddValue("stas",          "STAs / transmitters.",                                stas);
+  cmd.AddValue("radius",        "Drop radius in m.",                                   radius);
+  cmd.AddValue("mode",          "802.11a rate of the bss trace.",                      mode);
+  cmd.AddValue("simTime",       "Seconds of traffic.",                                 simTime);
+  cmd.AddValue("load",          "Poisson trace: mean frames on the air.",              load);
+  cmd.AddValue("receivers",     "Receivers replayed (0 = every node).",                receivers);
+  cmd.AddValue("rxSensitivity", "Lock threshold in dBm.",                              rxSens);
+  cmd.AddValue("repeat",        "Timed repetitions, fastest kept.",                    repeat);
+  cmd.AddValue("csv",           "If non-empty, write one row per (trace, store).",     csvPath);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  if (trace != "bss" && trace != "poisson" && trace != "all")
+  {
+    std::cerr << "ERROR: --trace must be bss, poisson or all.\n";
+    return 1;
+  }
+  if (stas == 0 || repeat == 0 || load <= 0.0)
+  {
+    std::cerr << "ERROR: need --stas >= 1, --repeat >= 1 and --load > 0.\n";
+    return 1;
+  }
+
+  std::ofstream csvOfs;
+  std::ofstream* csv = nullptr;
+  if (!csvPath.empty())
+  {
+    csvOfs.open(csvPath, std::ios::out | std::ios::trunc);
+    csvOfs << "trace,store,signals,chunks,ns_per_signal,peak_entries,chunk_hash\n";
+    csv = &csvOfs;
+  }
+
+  if (trace == "bss" || trace == "all")
+  {
+    BenchTrace("bss " + mode + "/" + std::to_string(stas),
+               BssTrace(stas, radius, mode, simTime), receivers, rxSens, repeat, csv);
+  }
+  if (trace == "poisson" || trace == "all")
+  {
+    std::ostringstream name;
+    name << "poisson " << stas << " load " << load;
+    BenchTrace(name.str(), PoissonTrace(stas, radius, load, simTime), receivers, rxSens, repeat, csv);
+  }
+  if (csv)
+  {
+    std::cout << "CSV written: " << csvPath << "\n";
+  }
+  return 0;
+}
@@ -18,6 +18,22 @@
 //
 // HOW TO RUN (from ns-3 root):
 //   ./ns3 run "scratch/Lab2_Cpp_Scenario1 --rate=11 --seed=2"
+//   ./ns3 run "scratch/Lab2_Cpp_Scenario1 --rate=11 --sampleInterval=0.05 --earlyStop=0.02"
+//
+// OPTIONAL GOODPUT TIME SERIES:
+//   --sampleInterval=S samples the sink every S seconds and prints the detected
+//   warm-up (association/ARP) and the steady-state goodput ± 95 % CI.
+//   --earlyStop=R additionally ends the run once that CI is within R (relative);
+//   the classic number is then computed over the shortened window.
+//
+// ANALYTIC MODEL (common/include/lab-bianchi.h):
+//   --bianchi=1 prints Bianchi's saturation prediction for this topology next to the
+//   simulated goodput. Here the AP relays every packet, so the contenders are the
+//   sender(s) plus the AP and the goodput is the AP's share. A warning is printed
+//   when the two differ by more than --driftTol (default 0.15).
+//   --analyticOnly=1 prints the prediction for --flows such flows and exits
+//   without simulating, e.g. --analyticOnly=1 --flows=50 --rate=11.
+//   --rtsCts=1 turns on RTS/CTS, in the simulation and in the model.
 // ------------------------------------------------------------------------------------
 
 #include "ns3/core-module.h"
@@ -29,18 +45,15 @@
 #include "ns3/flow-monitor-module.h"
 #include "ns3/netanim-module.h"
 
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-goodput-sampler.h"  // goodput time series + warm-up detection (--sampleInterval)
+#include "lab-bianchi.h"          // DCF saturation model (--bianchi / --analyticOnly)
+#include "lab-scenario.h"         // typed rates, BSS builder, saturating OnOff
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
 using namespace ns3;
 
-// --------- Utility: map numeric Mbps to a legal 802.11b WifiMode string ---------
-// IEEE 802.11b supports DSSS/CCK modes at 1, 2, 5.5, and 11 Mbps.
-static std::string
-ModeForB (double rateMbps)
-{
-  if (rateMbps <= 1.0)   return "DsssRate1Mbps";
-  if (rateMbps <= 2.0)   return "DsssRate2Mbps";
-  if (rateMbps <= 5.5)   return "DsssRate5_5Mbps";
-  /* else */             return "DsssRate11Mbps";
-}
+LAB_POOL_INSTALL_OPERATORS()
 
 int
 main (int argc, char *argv[])
@@ -50,10 +63,42 @@ main (int argc, char *argv[])
   // seed:   the RngRun so we can repeat with different contention/backoff timings
   double   rate = 11.0;       // Mbps (valid: 1, 2, 5.5, 11)
   uint32_t seed = 1;          // RngRun index (use 1 and 2 per spec)
+  bool     usePool = false;    // serve packets/events from the size-class pool
+  double   sampleInterval = 0.0;  // goodput sampling period in s (0 = off)
+  double   earlyStop = 0.0;       // stop at this relative CI half-width (0 = off)
+  bool     bianchi = false;       // print the analytic prediction next to the result
+  bool     analyticOnly = false;  // print the prediction for --flows and exit
+  uint32_t flows = 1;              // flows for --analyticOnly
+  bool     rtsCts = false;        // RTS/CTS before every data frame
+  double   driftTol = 0.15;       // relative deviation that triggers a warning
   CommandLine cmd;
   cmd.AddValue("rate", "802.11b PHY data rate in Mbps (1, 2, 5.5, 11 -> rounded up)", rate);
   cmd.AddValue("seed", "RngRun value for repeatability (use 1 and 2 for the lab)", seed);
+  cmd.AddValue("pool", "Serve small allocations (packets, events) from the size-class pool", usePool);
+  cmd.AddValue("sampleInterval", "Goodput sampling period in seconds (0 = off)", sampleInterval);
+  cmd.AddValue("earlyStop", "Stop once the steady-state CI half-width is below this fraction (0 = off)", earlyStop);
+  cmd.AddValue("bianchi", "Print Bianchi's saturation prediction next to the simulated goodput", bianchi);
+  cmd.AddValue("analyticOnly", "Only print the prediction for --flows flows (no simulation)", analyticOnly);
+  cmd.AddValue("flows", "Number of STA->AP->STA flows for --analyticOnly", flows);
+  cmd.AddValue("rtsCts", "Use RTS/CTS for every data frame", rtsCts);
+  cmd.AddValue("driftTol", "Warn when simulation and model differ by more than this fraction", driftTol);
   cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
+
+  // IEEE 802.11b has DSSS/CCK modes at 1, 2, 5.5 and 11 Mbps; --rate is rounded up.
+  const LabRate phyRate = DsssRateAtLeast(rate);
+  const DcfParameters dcf = DcfParameters::Dsss(Info(phyRate).mbps, 1000, rtsCts);
+  if (analyticOnly)
+  {
+    ReportRelayedBss(std::cout, dcf, std::max<uint32_t>(flows, 1));
+    return 0;
+  }
+  if (rtsCts)
+  {
+    Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(0));
+  }
 
   // ----------------------------- Randomization setup -----------------------------
   // Keep the Seed constant across all runs; vary only the Run to randomize per‑trial.
@@ -73,33 +118,14 @@ main (int argc, char *argv[])
   // --------------------------- Channel / PHY configuration ------------------------
   // YansWifiChannelHelper::Default() sets Friis + LogDistance + RandomLoss by default.
   // We keep defaults; the geometry (10 m sides) gives comparable path loss on all links.
-  YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
-  channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-
-  // ns-3.40: create a YansWifiPhyHelper and explicitly bind it to the channel.
-  YansWifiPhyHelper phy;
-  phy.SetChannel(channel.Create());
+  LabWifiBss<LabStandard::k80211b> bss("lab2-ssid");
 
   // ------------------------------- Wi‑Fi MAC & rate -------------------------------
   // Lock the standard to 802.11b and force both Data/Control to the requested mode,
   // so the PHY rate is *constant* during the experiment.
-  WifiHelper wifi;
-  wifi.SetStandard(WIFI_STANDARD_80211b);
-  const std::string mode = ModeForB(rate);
-  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
-                               "DataMode",    StringValue(mode),
-                               "ControlMode", StringValue(mode));
-
-  WifiMacHelper mac;
-  Ssid ssid = Ssid("lab2-ssid");
-
-  // STA devices (non-AP)
-  mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
-  NetDeviceContainer staDevs = wifi.Install(phy, mac, staNodes);
-
-  // AP device
-  mac.SetType("ns3::ApWifiMac",  "Ssid", SsidValue(ssid));
-  NetDeviceContainer apDev  = wifi.Install(phy, mac, apNode);
+  bss.Rates(phyRate, phyRate);
+  NetDeviceContainer staDevs = bss.InstallSta(staNodes);  // STA devices (non-AP)
+  NetDeviceContainer apDev   = bss.InstallAp(apNode);     // AP device
 
   // --------------------------------- Mobility model --------------------------------
   // Place nodes as an EQUILATERAL TRIANGLE with side length = 10 m.
@@ -144,12 +170,9 @@ main (int argc, char *argv[])
   //     to force saturation — per NOTE1 in the spec.
   //   • Packet size is 1000 B (as required).
   //   • The app runs from t=[1s,10s]; we measure goodput over the 9 s active window.
-  OnOffHelper onoff("ns3::UdpSocketFactory",
-                    InetSocketAddress(staIfaces.GetAddress(1), 9)); // -> receiver:port 9
-  onoff.SetAttribute("DataRate",   StringValue("100Mbps"));        // saturating offered load
-  onoff.SetAttribute("PacketSize", UintegerValue(1000));           // payload size
-  onoff.SetAttribute("OnTime",     StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-  onoff.SetAttribute("OffTime",    StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+  OnOffHelper onoff = SaturatingOnOff(InetSocketAddress(staIfaces.GetAddress(1), 9), // -> receiver:port 9
+                                      DataRate(100000000),  // saturating offered load
+                                      1000);                // payload size
 
   ApplicationContainer client = onoff.Install(staNodes.Get(0)); // sender index 0
   client.Start(Seconds(1.0));
@@ -162,6 +185,19 @@ main (int argc, char *argv[])
   server.Start(Seconds(0.0));
   server.Stop (Seconds(10.0));
 
+  // Optional goodput time series at the receiver (steady state vs. warm-up)
+  GoodputSampler sampler(Seconds(sampleInterval > 0 ? sampleInterval : 1.0));
+  if (sampleInterval > 0)
+  {
+    Ptr<PacketSink> sinkApp = DynamicCast<PacketSink>(server.Get(0));
+    sampler.SetBytesSource([sinkApp]() { return sinkApp->GetTotalRx(); });
+    sampler.Start(Seconds(1.0), Seconds(10.0));
+    if (earlyStop > 0)
+    {
+      sampler.EnableEarlyStop(earlyStop);
+    }
+  }
+
   // ---------------------------- FlowMonitor + NetAnim ------------------------------
   FlowMonitorHelper fmHelper;
   Ptr<FlowMonitor> monitor = fmHelper.InstallAll();
@@ -178,6 +214,7 @@ main (int argc, char *argv[])
 
   // ------------------------------- Run the simulation ------------------------------
   Simulator::Stop(Seconds(10.0));
+  StartupProfiler::Running();
   Simulator::Run();
 
   // ------------------------------ Throughput calculation ---------------------------
@@ -191,14 +228,23 @@ main (int argc, char *argv[])
     totalRxBytes += kv.second.rxBytes;
   }
 
-  const double activeSecs = 9.0;  // apps active in [1,10]s
+  // apps active in [1,10]s, unless the sampler ended the run early
+  const double activeSecs = sampler.StoppedEarly() ? sampler.GetStopTime().GetSeconds() - 1.0 : 9.0;
   const double goodput_bps = (totalRxBytes * 8.0) / activeSecs;
 
-  std::cout << "[Scenario1] PHYMode=" << mode
+  std::cout << "[Scenario1] PHYMode=" << Info(phyRate).name
             << "  offered=100Mbps"
             << "  totalRxBytes=" << totalRxBytes
             << "  throughput=" << goodput_bps << " bps (" << goodput_bps/1e6 << " Mbps)"
             << std::endl;
+  if (sampleInterval > 0)
+  {
+    sampler.Report(std::cout);
+  }
+  if (bianchi)
+  {
+    ReportRelayedBss(std::cout, dcf, 1, goodput_bps, driftTol);
+  }
 
   Simulator::Destroy();
   return 0;
@@ -20,6 +20,21 @@
 //
 // HOW TO RUN (from ns-3 root):
 //   ./ns3 run "scratch/Lab2_Cpp_Scenario2 --rate=11 --seed=1"
+//   ./ns3 run "scratch/Lab2_Cpp_Scenario2 --rate=11 --sampleInterval=0.05 --earlyStop=0.02"
+//
+// OPTIONAL GOODPUT TIME SERIES:
+//   --sampleInterval=S samples the aggregate of both sinks every S seconds and prints
+//   the detected warm-up and the steady-state goodput ± 95 % CI.
+//   --earlyStop=R additionally ends the run once that CI is within R (relative).
+//
+// ANALYTIC MODEL (common/include/lab-bianchi.h):
+//   --bianchi=1 prints Bianchi's saturation prediction for this topology next to the
+//   simulated goodput. Here the AP relays every packet, so the contenders are the
+//   sender(s) plus the AP and the goodput is the AP's share. A warning is printed
+//   when the two differ by more than --driftTol (default 0.15).
+//   --analyticOnly=1 prints the prediction for --flows such flows and exits
+//   without simulating, e.g. --analyticOnly=1 --flows=50 --rate=11.
+//   --rtsCts=1 turns on RTS/CTS, in the simulation and in the model.
 // ------------------------------------------------------------------------------------
 
 #include "ns3/core-module.h"
@@ -31,28 +46,58 @@
 #include "ns3/flow-monitor-module.h"
 #include "ns3/netanim-module.h"
 
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-goodput-sampler.h"  // goodput time series + warm-up detection (--sampleInterval)
+#include "lab-bianchi.h"          // DCF saturation model (--bianchi / --analyticOnly)
+#include "lab-scenario.h"         // typed rates, BSS builder, saturating OnOff
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
 using namespace ns3;
 
-// Map numeric Mbps to an 802.11b WifiMode string.
-static std::string
-ModeForB (double rateMbps)
-{
-  if (rateMbps <= 1.0)   return "DsssRate1Mbps";
-  if (rateMbps <= 2.0)   return "DsssRate2Mbps";
-  if (rateMbps <= 5.5)   return "DsssRate5_5Mbps";
-  /* else */             return "DsssRate11Mbps";
-}
+LAB_POOL_INSTALL_OPERATORS()
 
 int
 main (int argc, char *argv[])
 {
   // ------------------------- Simulation parameters (CLI) -------------------------
   double   rate = 11.0;       // PHY data rate (Mbps) to lock
+  double   sampleInterval = 0.0;  // goodput sampling period in s (0 = off)
+  double   earlyStop = 0.0;       // stop at this relative CI half-width (0 = off)
+  bool     bianchi = false;       // print the analytic prediction next to the result
+  bool     analyticOnly = false;  // print the prediction for --flows and exit
+  uint32_t flows = 2;              // flows for --analyticOnly
+  bool     rtsCts = false;        // RTS/CTS before every data frame
+  double   driftTol = 0.15;       // relative deviation that triggers a warning
   uint32_t seed = 1;          // RngRun; use 1 and 2 for the lab
+  bool     usePool = false;    // serve packets/events from the size-class pool
   CommandLine cmd;
   cmd.AddValue("rate", "802.11b PHY data rate in Mbps (1, 2, 5.5, 11 -> rounded up)", rate);
   cmd.AddValue("seed", "RngRun value for repeatability (use 1 and 2 for the lab)", seed);
+  cmd.AddValue("pool", "Serve small allocations (packets, events) from the size-class pool", usePool);
+  cmd.AddValue("sampleInterval", "Goodput sampling period in seconds (0 = off)", sampleInterval);
+  cmd.AddValue("earlyStop", "Stop once the steady-state CI half-width is below this fraction (0 = off)", earlyStop);
+  cmd.AddValue("bianchi", "Print Bianchi's saturation prediction next to the simulated goodput", bianchi);
+  cmd.AddValue("analyticOnly", "Only print the prediction for --flows flows (no simulation)", analyticOnly);
+  cmd.AddValue("flows", "Number of STA->AP->STA flows for --analyticOnly", flows);
+  cmd.AddValue("rtsCts", "Use RTS/CTS for every data frame", rtsCts);
+  cmd.AddValue("driftTol", "Warn when simulation and model differ by more than this fraction", driftTol);
   cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
+
+  // 802.11b rate for --rate, rounded up to 1, 2, 5.5 or 11 Mbps.
+  const LabRate phyRate = DsssRateAtLeast(rate);
+  const DcfParameters dcf = DcfParameters::Dsss(Info(phyRate).mbps, 1000, rtsCts);
+  if (analyticOnly)
+  {
+    ReportRelayedBss(std::cout, dcf, std::max<uint32_t>(flows, 1));
+    return 0;
+  }
+  if (rtsCts)
+  {
+    Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(0));
+  }
 
   // ----------------------------- Randomization setup -----------------------------
   RngSeedManager::SetSeed(1);
@@ -66,31 +111,15 @@ main (int argc, char *argv[])
   NodeContainer apNode;       apNode.Create(1);
 
   // --------------------------- Channel / PHY configuration ------------------------
-  YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
-  channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-
-  YansWifiPhyHelper phy;
-  phy.SetChannel(channel.Create());
+  LabWifiBss<LabStandard::k80211b> bss("lab2-ssid");
 
   // ------------------------------- Wi‑Fi MAC & rate -------------------------------
-  WifiHelper wifi;
-  wifi.SetStandard(WIFI_STANDARD_80211b);
-  const std::string mode = ModeForB(rate);
-  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
-                               "DataMode",    StringValue(mode),
-                               "ControlMode", StringValue(mode));
-
-  WifiMacHelper mac;
-  Ssid ssid = Ssid("lab2-ssid");
-
-  // Install STA devices on senders and receivers (all in the same BSS).
-  mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
-  NetDeviceContainer devSenders   = wifi.Install(phy, mac, staSenders);
-  NetDeviceContainer devReceivers = wifi.Install(phy, mac, staReceivers);
+  bss.Rates(phyRate, phyRate);
 
-  // AP device
-  mac.SetType("ns3::ApWifiMac",  "Ssid", SsidValue(ssid));
-  NetDeviceContainer devAp = wifi.Install(phy, mac, apNode);
+  // Install STA devices on senders and receivers (all in the same BSS), then the AP.
+  NetDeviceContainer devSenders   = bss.InstallSta(staSenders);
+  NetDeviceContainer devReceivers = bss.InstallSta(staReceivers);
+  NetDeviceContainer devAp        = bss.InstallAp(apNode);
 
   // --------------------------------- Mobility model --------------------------------
   // Build TWO equilateral triangles (side = 10 m) that share the AP at the origin.
@@ -141,12 +170,8 @@ main (int argc, char *argv[])
   // -------------------------------- Applications (2 flows) ------------------------
   // Saturating offered load (100 Mbps PER FLOW), payload 1000 B, On in [1,10] s.
   // Flow A: Sender_L -> Receiver_L (port 9)
-  OnOffHelper onoffA("ns3::UdpSocketFactory",
-                     InetSocketAddress(ifReceivers.GetAddress(0), 9));
-  onoffA.SetAttribute("DataRate",   StringValue("100Mbps"));
-  onoffA.SetAttribute("PacketSize", UintegerValue(1000));
-  onoffA.SetAttribute("OnTime",     StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-  onoffA.SetAttribute("OffTime",    StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+  OnOffHelper onoffA = SaturatingOnOff(InetSocketAddress(ifReceivers.GetAddress(0), 9),
+                                       DataRate(100000000), 1000);
   ApplicationContainer appA = onoffA.Install(staSenders.Get(0)); // Left sender
   appA.Start(Seconds(1.0));
   appA.Stop (Seconds(10.0));
@@ -158,12 +183,8 @@ main (int argc, char *argv[])
   srvA.Stop (Seconds(10.0));
 
   // Flow B: Sender_R -> Receiver_R (port 10)
-  OnOffHelper onoffB("ns3::UdpSocketFactory",
-                     InetSocketAddress(ifReceivers.GetAddress(1), 10));
-  onoffB.SetAttribute("DataRate",   StringValue("100Mbps"));
-  onoffB.SetAttribute("PacketSize", UintegerValue(1000));
-  onoffB.SetAttribute("OnTime",     StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-  onoffB.SetAttribute("OffTime",    StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+  OnOffHelper onoffB = SaturatingOnOff(InetSocketAddress(ifReceivers.GetAddress(1), 10),
+                                       DataRate(100000000), 1000);
   ApplicationContainer appB = onoffB.Install(staSenders.Get(1)); // Right sender
   appB.Start(Seconds(1.0));
   appB.Stop (Seconds(10.0));
@@ -174,6 +195,20 @@ main (int argc, char *argv[])
   srvB.Start(Seconds(0.0));
   srvB.Stop (Seconds(10.0));
 
+  // Optional goodput time series over both sinks (steady state vs. warm-up)
+  GoodputSampler sampler(Seconds(sampleInterval > 0 ? sampleInterval : 1.0));
+  if (sampleInterval > 0)
+  {
+    Ptr<PacketSink> sA = DynamicCast<PacketSink>(srvA.Get(0));
+    Ptr<PacketSink> sB = DynamicCast<PacketSink>(srvB.Get(0));
+    sampler.SetBytesSource([sA, sB]() { return sA->GetTotalRx() + sB->GetTotalRx(); });
+    sampler.Start(Seconds(1.0), Seconds(10.0));
+    if (earlyStop > 0)
+    {
+      sampler.EnableEarlyStop(earlyStop);
+    }
+  }
+
   // ---------------------------- FlowMonitor + NetAnim ------------------------------
   FlowMonitorHelper fmHelper;
   Ptr<FlowMonitor> monitor = fmHelper.InstallAll();
@@ -196,6 +231,7 @@ main (int argc, char *argv[])
 
   // ------------------------------- Run the simulation ------------------------------
   Simulator::Stop(Seconds(10.0));
+  StartupProfiler::Running();
   Simulator::Run();
 
   // ------------------------------ Throughput calculation ---------------------------
@@ -214,18 +250,26 @@ main (int argc, char *argv[])
     if (t.destinationPort == 10)  rxPort10 += kv.second.rxBytes;
   }
 
-  const double activeSecs = 9.0;
+  const double activeSecs = sampler.StoppedEarly() ? sampler.GetStopTime().GetSeconds() - 1.0 : 9.0;
   const double thrA = (rxPort9  * 8.0) / activeSecs; // bps
   const double thrB = (rxPort10 * 8.0) / activeSecs; // bps
   const double thrSum = thrA + thrB;
 
-  std::cout << "[Scenario1-Part2] PHYMode=" << mode
+  std::cout << "[Scenario1-Part2] PHYMode=" << Info(phyRate).name
             << "  offered(each)=100Mbps"
             << "  rxBytes(port9)="  << rxPort9
             << "  rxBytes(port10)=" << rxPort10 << std::endl;
   std::cout << "    throughput flowA(port9):  " << thrA    << " bps (" << thrA/1e6    << " Mbps)\n";
   std::cout << "    throughput flowB(port10): " << thrB    << " bps (" << thrB/1e6    << " Mbps)\n";
   std::cout << "    aggregate throughput:      " << thrSum  << " bps (" << thrSum/1e6  << " Mbps)\n";
+  if (sampleInterval > 0)
+  {
+    sampler.Report(std::cout);
+  }
+  if (bianchi)
+  {
+    ReportRelayedBss(std::cout, dcf, 2, thrSum, driftTol);
+  }
 
   Simulator::Destroy();
   return 0;
@@ -27,6 +27,21 @@
  *   --appRate    : OnOff application data rate (default 1Mbps)
  *   --enablePcap : 1→write per-node PCAPs for debugging (default 0)
  *   --enableAnim : 1→write NetAnim XML (default 0)
+ *   --latencyStats : 1→use CountingSink instead of PacketSink and print per-flow
+ *                  one-way delay p50/p99/p99.9, jitter and per-second goodput;
+ *                  FlowMonitor is skipped in this mode (default 0)
+ *   --sampleInterval : >0 → sample sink goodput every S seconds; prints detected
+ *                  warm-up and steady-state goodput ± 95 % CI (MSER-5) (default 0)
+ *   --earlyStop  : >0 → end the run once that CI is within this fraction of the
+ *                  mean (needs --sampleInterval); throughput then uses the
+ *                  shortened window (default 0)
+ *   --fanoutThreads : >0 → compute the rx power of every receiver of a
+ *                  transmission on this many threads (lab-parallel-fanout.h);
+ *                  results are identical to a serial run. The first
+ *                  transmission times both ways and the fan-out stays off
+ *                  unless it is measurably faster; the verdict and timings are
+ *                  printed (see Lab3_Cpp_FanoutBench) (default 0 = off)
+ *   --fanoutMin  : fewer receivers than this stay serial (default 32)
  *
  * Notes:
  *   - TX window is exactly [1s, 10s], so divide bytes by 9 s for throughput.
@@ -44,8 +59,16 @@
 #include "ns3/olsr-helper.h"
 #include "ns3/netanim-module.h"   // only used if --enableAnim=1
 
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-counting-sink.h"    // CountingSink + latency histograms (--latencyStats)
+#include "lab-goodput-sampler.h"  // goodput time series + warm-up detection (--sampleInterval)
+#include "lab-parallel-fanout.h"  // per-receiver loss on a thread pool (--fanoutThreads)
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
 using namespace ns3;
 
+LAB_POOL_INSTALL_OPERATORS()
+
 static void
 Banner(const std::string& title)
 {
@@ -62,6 +85,12 @@ int main(int argc, char* argv[])
   std::string appRate = "1Mbps";          // push traffic to saturate
   bool enablePcap     = false;            // packet traces (pcap) off by default
   bool enableAnim     = false;            // NetAnim XML off by default
+  bool usePool        = false;             // size-class pool for packets/events
+  bool latencyStats   = false;            // CountingSink + delay histograms
+  double sampleInterval = 0.0;            // goodput sampling period (s), 0 = off
+  double earlyStop    = 0.0;              // stop at this relative CI half-width, 0 = off
+  uint32_t fanoutThreads = 0;             // threads for the receiver fan-out, 0 = off
+  uint32_t fanoutMin  = 32;               // minimum receivers before going parallel
 
   // -------- Parse CLI --------
   CommandLine cmd;
@@ -72,7 +101,16 @@ int main(int argc, char* argv[])
   cmd.AddValue("appRate",    "OnOff application data rate.",     appRate);
   cmd.AddValue("enablePcap", "Enable per-node PCAP traces.",     enablePcap);
   cmd.AddValue("enableAnim", "Write NetAnim XML.",               enableAnim);
+  cmd.AddValue("pool",       "Serve packets/events from the size-class pool.", usePool);
+  cmd.AddValue("latencyStats", "Per-flow delay percentiles via CountingSink.", latencyStats);
+  cmd.AddValue("sampleInterval", "Goodput sampling period in seconds (0 = off).", sampleInterval);
+  cmd.AddValue("earlyStop",  "Stop once steady-state CI half-width < this fraction.", earlyStop);
+  cmd.AddValue("fanoutThreads", "Threads for the per-receiver loss fan-out (0 = off).", fanoutThreads);
+  cmd.AddValue("fanoutMin",  "Receivers needed before the fan-out goes parallel.", fanoutMin);
   cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
 
   if (numNodes < 3)
   {
@@ -88,7 +126,7 @@ int main(int argc, char* argv[])
   const double appStart = 1.0;
   const double appStop  = 10.0;
   const double simStop  = 11.0;  // a bit of tail for stats/teardown
-  const double txWindow = appStop - appStart; // should be 9.0 s
+  double txWindow = appStop - appStart;       // should be 9.0 s (unless --earlyStop)
 
   // -------- Create nodes --------
   NodeContainer nodes;
@@ -107,7 +145,13 @@ int main(int argc, char* argv[])
   //channel.AddPropagationLoss("ns3::TwoRayGroundPropagationLossModel", "Frequency",   DoubleValue(2.412e9));
   //channel.AddPropagationLoss("ns3::TwoRayGroundPropagationLossModel", "Frequency",   DoubleValue(2.412e9));
   YansWifiPhyHelper phy;
-  phy.SetChannel(channel.Create());
+  Ptr<YansWifiChannel> wifiChannel = channel.Create();
+  Ptr<ParallelFanoutLossModel> fanout;
+  if (fanoutThreads > 0)
+  {
+    fanout = InstallParallelFanout(wifiChannel, fanoutThreads, fanoutMin);
+  }
+  phy.SetChannel(wifiChannel);
   // FORCE 2.4 GHz (channel 1 = 2412 MHz, 20 MHz)
   //phy.Set("OperatingChannel", StringValue("{1, 0, BAND_2_4GHZ, 0}"));
   // Optional: hold TX power fixed (default is usually fine for this lab)
@@ -166,10 +210,21 @@ int main(int argc, char* argv[])
   // -------- Applications: UDP sink (last node) + OnOff source (node 0) --------
   uint16_t port = 5000;
 
-  // PacketSink (server) to count received bytes.
+  // PacketSink (server) to count received bytes; CountingSink also keeps
+  // delay histograms, fed by timestamps stamped at the source's IP layer.
   Address sinkLocalAddr(InetSocketAddress(Ipv4Address::GetAny(), port));
-  PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", sinkLocalAddr);
-  ApplicationContainer sinkApp = sinkHelper.Install(nodes.Get(numNodes - 1));
+  ApplicationContainer sinkApp;
+  if (latencyStats)
+  {
+    CountingSinkHelper sinkHelper("ns3::UdpSocketFactory", sinkLocalAddr);
+    sinkApp = sinkHelper.Install(nodes.Get(numNodes - 1));
+    LatencyTagger::Install(nodes.Get(0));
+  }
+  else
+  {
+    PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", sinkLocalAddr);
+    sinkApp = sinkHelper.Install(nodes.Get(numNodes - 1));
+  }
   sinkApp.Start(Seconds(0.0));
   sinkApp.Stop(Seconds(simStop));
 
@@ -183,9 +238,21 @@ int main(int argc, char* argv[])
   srcApp.Start(Seconds(appStart));
   srcApp.Stop(Seconds(appStop));
 
+  // -------- Optional goodput time series (warm-up vs steady state) --------
+  GoodputSampler sampler(Seconds(sampleInterval > 0 ? sampleInterval : 1.0));
+  if (sampleInterval > 0)
+  {
+    sampler.SetBytesSource([&sinkApp]() { return GetSinkTotalRx(sinkApp.Get(0)); });
+    sampler.Start(Seconds(appStart), Seconds(appStop));
+    if (earlyStop > 0)
+    {
+      sampler.EnableEarlyStop(earlyStop);
+    }
+  }
+
   // -------- FlowMonitor (secondary stats; nice for debugging) --------
   FlowMonitorHelper fmHelper;
-  Ptr<FlowMonitor> monitor = fmHelper.InstallAll();
+  Ptr<FlowMonitor> monitor = latencyStats ? nullptr : fmHelper.InstallAll();
 
   // -------- NetAnim (optional visualization) --------
   AnimationInterface* anim = nullptr;
@@ -202,41 +269,70 @@ int main(int argc, char* argv[])
 
   // -------- Run --------
   Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
   Simulator::Run();
 
+  if (fanout)
+  {
+    std::cout << "Receiver fan-out: " << (fanout->IsParallel() ? "parallel" : "serial")
+              << " (timed: serial " << fanout->GetSerialBatchUs() << " us, batch "
+              << fanout->GetParallelBatchUs() << " us per transmission), "
+              << fanout->GetBatches() << " batches, " << fanout->GetServed()
+              << " rx powers served\n";
+  }
+
+  // An early stop shortens the measurement window.
+  if (sampler.StoppedEarly())
+  {
+    txWindow = sampler.GetStopTime().GetSeconds() - appStart;
+  }
+
   // -------- Compute throughput over the real TX window (authoritative) --------
   // Use the sink app's byte counter — simplest and most robust.
   uint64_t rxBytes = 0;
-  {
-    Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApp.Get(0));
-    rxBytes = sink ? sink->GetTotalRx() : 0;
-  }
+  rxBytes = GetSinkTotalRx(sinkApp.Get(0));
   double throughput_bps   = (rxBytes * 8.0) / txWindow;
   double throughput_mbps  = throughput_bps / 1e6;
+  if (sampleInterval > 0)
+  {
+    Banner("Goodput time series");
+    std::cout << "Sink throughput: " << throughput_mbps << " Mb/s over " << txWindow << " s\n";
+    sampler.Report(std::cout);
+  }
 
- // -------- Also print FlowMonitor's view (sanity check) --------
-monitor->CheckForLostPackets();
-auto stats = monitor->GetFlowStats();
-Ptr<Ipv4FlowClassifier> classifier =
-    DynamicCast<Ipv4FlowClassifier>(fmHelper.GetClassifier());
+ // -------- Latency view (CountingSink) --------
+if (latencyStats)
+{
+  Banner("CountingSink (per-flow latency)");
+  DynamicCast<CountingSink>(sinkApp.Get(0))->Report(std::cout, appStart);
+}
 
-Banner("FlowMonitor (per-flow) — informational");
-for (const auto& kv : stats)
+ // -------- Also print FlowMonitor's view (sanity check) --------
+if (monitor)
 {
-  FlowId id = kv.first;
-  const FlowMonitor::FlowStats& s = kv.second;
-
-  // ns-3.40 API: FindFlow(flowId) -> FiveTuple
-  Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(id);
-
-  std::cout << "Flow " << id
-            << "  " << t.sourceAddress << ":" << t.sourcePort
-            << " -> " << t.destinationAddress << ":" << t.destinationPort
-            << " | rxBytes=" << s.rxBytes
-            << " | rxPackets=" << s.rxPackets
-            << " | delaySum=" << s.delaySum.GetSeconds() << " s"
-            << " | lost=" << s.lostPackets
-            << "\n";
+  monitor->CheckForLostPackets();
+  auto stats = monitor->GetFlowStats();
+  Ptr<Ipv4FlowClassifier> classifier =
+      DynamicCast<Ipv4FlowClassifier>(fmHelper.GetClassifier());
+
+  Banner("FlowMonitor (per-flow) — informational");
+  for (const auto& kv : stats)
+  {
+    FlowId id = kv.first;
+    const FlowMonitor::FlowStats& s = kv.second;
+
+    // ns-3.40 API: FindFlow(flowId) -> FiveTuple
+    Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(id);
+
+    std::cout << "Flow " << id
+              << "  " << t.sourceAddress << ":" << t.sourcePort
+              << " -> " << t.destinationAddress << ":" << t.destinationPort
+              << " | rxBytes=" << s.rxBytes
+              << " | rxPackets=" << s.rxPackets
+              << " | delaySum=" << s.delaySum.GetSeconds() << " s"
+              << " | lost=" << s.lostPackets
+              << "\n";
+  }
 }
 
 
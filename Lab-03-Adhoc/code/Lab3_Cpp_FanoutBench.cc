@@ -0,0 +1,220 @@
+// Lab 3: receiver fan-out benchmark — serial loss chain vs ParallelFanoutLossModel batch
+// ------------------------------------------------------------------------------------
+// WHAT IT MEASURES:
+//   For every transmission YansWifiChannel::Send evaluates the loss chain once
+//   per receiver. --fanoutThreads in Lab3_Cpp_Adhoc replaces that loop by a
+//   parallel batch (common/include/lab-parallel-fanout.h), which first copies
+//   every position on the simulator thread and then wakes the worker threads.
+//   Whether that pays off depends on the chain, the number of receivers and the
+//   machine, so the model times both on the first transmission and keeps the
+//   faster one.
+//
+//   This program builds ad-hoc channels of each size in --nodes with each chain
+//   in --loss, triggers that timing and prints it: best serial time and best
+//   batch time for all receivers of one transmission, the speed-up, the serial
+//   cost per receiver and which way the model chose. The smallest size that
+//   turns "parallel" is the threshold on this machine; use it for --fanoutMin.
+//   Nodes sit on a square grid with 10 m spacing; the geometry does not change
+//   the cost of these chains.
+//
+// HOW TO RUN (from ns-3 root):
+//   ./ns3 run "scratch/Lab3_Cpp_FanoutBench"
+//   ./ns3 run "scratch/Lab3_Cpp_FanoutBench --nodes=100,400,1600 --loss=friis --threads=8"
+//   ./ns3 run "scratch/Lab3_Cpp_FanoutBench --csv=fanout.csv"
+//
+// KEY FLAGS:
+//   --nodes      : comma-separated channel sizes (default 32,100,200,400,1000,2000)
+//   --loss       : comma-separated chains: friis, tworay, logdistance, threelog,
+//                  cost231, okumura (default friis,logdistance,cost231)
+//   --threads    : pool threads including the caller, 0 = all cores (default 0)
+//   --minSpeedup : batch must beat the serial chain by this factor (default 1.2)
+//   --csv        : if non-empty, one row per (chain, size)
+// ------------------------------------------------------------------------------------
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-parallel-fanout.h"     // ParallelFanoutLossModel
+#include "lab-startup-profiler.h"    // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+static std::vector<std::string>
+SplitList(const std::string& s)
+{
+  std::vector<std::string> out;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    if (!item.empty())
+    {
+      out.push_back(item);
+    }
+  }
+  return out;
+}
+
+struct BenchRow
+{
+  std::string loss;
+  uint32_t    nodes;
+  uint32_t    threads;
+  double      serialUs;
+  double      batchUs;
+  bool        parallel;
+};
+
+// One channel of 'n' nodes with 'lossType', timed by the fan-out model.
+static BenchRow
+RunOne(const std::string& loss, const std::string& lossType, uint32_t n, uint32_t threads,
+       double minSpeedup)
+{
+  NodeContainer nodes;
+  nodes.Create(n);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                "DeltaX", DoubleValue(10.0),
+                                "DeltaY", DoubleValue(10.0),
+                                "GridWidth", UintegerValue(static_cast<uint32_t>(std::ceil(std::sqrt(n)))),
+                                "LayoutType", StringValue("RowFirst"));
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  mobility.Install(nodes);
+
+  YansWifiChannelHelper channel;
+  channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+  channel.AddPropagationLoss(lossType);
+  Ptr<YansWifiChannel> wifiChannel = channel.Create();
+  Ptr<ParallelFanoutLossModel> fanout = InstallParallelFanout(wifiChannel, threads, 1);
+  fanout->SetAttribute("MinSpeedup", DoubleValue(minSpeedup));
+
+  YansWifiPhyHelper phy;
+  phy.SetChannel(wifiChannel);
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_STANDARD_80211a);
+  WifiMacHelper mac;
+  mac.SetType("ns3::AdhocWifiMac");
+  wifi.Install(phy, mac, nodes);
+
+  // The first rx power of a transmission sets the model up and times it.
+  fanout->CalcRxPower(16.0, nodes.Get(0)->GetObject<MobilityModel>(),
+                      nodes.Get(1)->GetObject<MobilityModel>());
+
+  BenchRow row{loss, n, threads, fanout->GetSerialBatchUs(), fanout->GetParallelBatchUs(),
+               fanout->IsParallel()};
+  Simulator::Destroy();
+  return row;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string nodesList = "32,100,200,400,1000,2000";
+  std::string lossList  = "friis,logdistance,cost231";
+  uint32_t threads      = 0;
+  double minSpeedup     = 1.2;
+  std::string csvPath   = "";
+
+  CommandLine cmd;
+  cmd.AddValue("nodes",      "Comma-separated channel sizes.",                       nodesList);
+  cmd.AddValue("loss",       "Comma-separated chains (friis, tworay, logdistance, threelog, cost231, okumura).", lossList);
+  cmd.AddValue("threads",    "Pool threads including the caller (0 = all cores).",   threads);
+  cmd.AddValue("minSpeedup", "Batch must beat the serial chain by this factor.",     minSpeedup);
+  cmd.AddValue("csv",        "If non-empty, write one row per (chain, size).",       csvPath);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  const std::map<std::string, std::string> chains = {
+      {"friis",       "ns3::FriisPropagationLossModel"},
+      {"tworay",      "ns3::TwoRayGroundPropagationLossModel"},
+      {"logdistance", "ns3::LogDistancePropagationLossModel"},
+      {"threelog",    "ns3::ThreeLogDistancePropagationLossModel"},
+      {"cost231",     "ns3::Cost231PropagationLossModel"},
+      {"okumura",     "ns3::OkumuraHataPropagationLossModel"}};
+
+  std::vector<uint32_t> sizes;
+  for (const std::string& s : SplitList(nodesList))
+  {
+    const long v = std::strtol(s.c_str(), nullptr, 10);
+    if (v < 2)
+    {
+      std::cerr << "ERROR: every --nodes entry must be >= 2 (got '" << s << "').\n";
+      return 1;
+    }
+    sizes.push_back(static_cast<uint32_t>(v));
+  }
+  const std::vector<std::string> losses = SplitList(lossList);
+  for (const std::string& l : losses)
+  {
+    if (chains.count(l) == 0)
+    {
+      std::cerr << "ERROR: unknown --loss '" << l << "'.\n";
+      return 1;
+    }
+  }
+  if (sizes.empty() || losses.empty())
+  {
+    std::cerr << "ERROR: --nodes and --loss must not be empty.\n";
+    return 1;
+  }
+
+  std::cout << "==== Receiver fan-out: serial chain vs parallel batch (best of "
+            << ParallelFanoutLossModel::kCalibrationRounds << ") ====\n"
+            << std::left << std::setw(12) << "loss" << std::right << std::setw(7) << "nodes"
+            << std::setw(14) << "serial_us" << std::setw(14) << "batch_us" << std::setw(10)
+            << "speedup" << std::setw(14) << "ns/receiver" << "  choice\n";
+
+  std::vector<BenchRow> rows;
+  for (const std::string& l : losses)
+  {
+    for (uint32_t n : sizes)
+    {
+      const BenchRow r = RunOne(l, chains.at(l), n, threads, minSpeedup);
+      rows.push_back(r);
+      std::cout << std::left << std::setw(12) << r.loss << std::right << std::setw(7) << r.nodes
+                << std::fixed << std::setprecision(2);
+      if (r.serialUs > 0.0)
+      {
+        std::cout << std::setw(14) << r.serialUs << std::setw(14) << r.batchUs << std::setw(10)
+                  << r.serialUs / r.batchUs << std::setw(14) << r.serialUs * 1e3 / (r.nodes - 1);
+      }
+      else
+      {
+        // One thread, or a chain the model will not run in parallel: nothing to time.
+        std::cout << std::setw(14) << "n/a" << std::setw(14) << "n/a" << std::setw(10) << "n/a"
+                  << std::setw(14) << "n/a";
+      }
+      std::cout << "  " << (r.parallel ? "parallel" : "serial") << "\n";
+      std::cout.unsetf(std::ios::fixed);
+    }
+  }
+
+  if (!csvPath.empty())
+  {
+    std::ofstream ofs(csvPath);
+    if (!ofs.is_open())
+    {
+      std::cerr << "ERROR: cannot open " << csvPath << "\n";
+      return 1;
+    }
+    ofs << "loss,nodes,threads,serial_us,batch_us,parallel\n";
+    for (const BenchRow& r : rows)
+    {
+      ofs << r.loss << "," << r.nodes << "," << r.threads << "," << r.serialUs << ","
+          << r.batchUs << "," << (r.parallel ? 1 : 0) << "\n";
+    }
+    std::cout << "CSV written: " << csvPath << "\n";
+  }
+  return 0;
+}
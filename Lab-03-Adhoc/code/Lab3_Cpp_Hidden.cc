@@ -40,6 +40,15 @@
  *   --enablePcap   : 1→write per-node 802.11 Radiotap PCAPs (promisc)
  *   --enableAnim   : 1→write NetAnim XML (Lab3_Hidden.xml)
  *   --csv          : optional CSV path (append mode); if empty, prints to stdout
+ *   --results      : result directory (lab-results.h); the same row as a typed,
+ *                    schema-versioned record (schema lab3-hidden), safe with many
+ *                    concurrent runs. Read it with common/scripts/labcol.py
+ *   --latencyStats : 1→CountingSink sinks; also prints per-flow one-way delay
+ *                    p50/p99/p99.9, jitter and per-second goodput (default 0)
+ *   --sampleInterval : >0 → sample the total goodput of both sinks every S seconds;
+ *                    prints warm-up and steady-state goodput ± 95 % CI (default 0)
+ *   --earlyStop    : >0 → end the run once that CI is within this fraction of the
+ *                    mean; throughputs then use the shortened window (default 0)
  *
  * CSV columns (one row per run):
  *   rtsCts,distance,pktSize,seed,thr_sta0_Mbps,thr_sta1_Mbps,thr_total_Mbps,
@@ -60,8 +69,16 @@
 #include <iostream>
 #include <iomanip>
 
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-counting-sink.h"    // CountingSink + latency histograms (--latencyStats)
+#include "lab-goodput-sampler.h"  // goodput time series + warm-up detection (--sampleInterval)
+#include "lab-results.h"          // typed result rows (--results)
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
 using namespace ns3;
 
+LAB_POOL_INSTALL_OPERATORS()
+
 static void Banner(const std::string& title)
 {
   std::cout << "\n==== " << title << " ====\n";
@@ -78,6 +95,11 @@ int main(int argc, char* argv[])
   bool enablePcap   = false;     // packet capture off by default
   bool enableAnim   = false;     // NetAnim off by default
   std::string csvPath = "";      // append CSV here if non-empty
+  std::string resultsDir = "";   // lab-results.h store if non-empty
+  bool usePool        = false;             // size-class pool for packets/events
+  bool latencyStats   = false;            // CountingSink + delay histograms
+  double sampleInterval = 0.0;            // goodput sampling period (s), 0 = off
+  double earlyStop    = 0.0;              // stop at this relative CI half-width, 0 = off
 
   CommandLine cmd;
   cmd.AddValue("enableRtsCts", "0→disable RTS/CTS, 1→enable RTS/CTS.", enableRtsCts);
@@ -88,11 +110,19 @@ int main(int argc, char* argv[])
   cmd.AddValue("enablePcap",   "Enable per-node PCAP traces.",            enablePcap);
   cmd.AddValue("enableAnim",   "Write NetAnim XML.",                      enableAnim);
   cmd.AddValue("csv",          "Append one CSV line to this path.",       csvPath);
+  cmd.AddValue("results",      "Result directory (lab-results.h).",       resultsDir);
+  cmd.AddValue("pool",       "Serve packets/events from the size-class pool.", usePool);
+  cmd.AddValue("latencyStats", "Per-flow delay percentiles via CountingSink.", latencyStats);
+  cmd.AddValue("sampleInterval", "Goodput sampling period in seconds (0 = off).", sampleInterval);
+  cmd.AddValue("earlyStop",  "Stop once steady-state CI half-width < this fraction.", earlyStop);
   cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
 
   // Timing
   const double appStart = 1.0, appStop = 10.0, simStop = 11.0;
-  const double txWindow = appStop - appStart; // 9 s
+  double txWindow = appStop - appStart;       // 9 s (unless --earlyStop)
 
   // Seed/run
   RngSeedManager::SetSeed(1);
@@ -173,18 +203,34 @@ int main(int argc, char* argv[])
   const uint16_t port0 = 9000, port1 = 9001;
 
   // Keep explicit pointers to the two sinks (ns-3.40 PacketSink has no GetSocket()).
-  Ptr<PacketSink> sink0Ptr, sink1Ptr;
+  // Either PacketSink or CountingSink; GetSinkTotalRx() reads both.
+  Ptr<Application> sink0Ptr, sink1Ptr;
   {
-    PacketSinkHelper sink0("ns3::UdpSocketFactory",
-                           InetSocketAddress(Ipv4Address::GetAny(), port0));
-    PacketSinkHelper sink1("ns3::UdpSocketFactory",
-                           InetSocketAddress(Ipv4Address::GetAny(), port1));
-    ApplicationContainer a0 = sink0.Install(ap.Get(0));
-    ApplicationContainer a1 = sink1.Install(ap.Get(0));
+    ApplicationContainer a0, a1;
+    if (latencyStats)
+    {
+      CountingSinkHelper sink0("ns3::UdpSocketFactory",
+                               InetSocketAddress(Ipv4Address::GetAny(), port0));
+      CountingSinkHelper sink1("ns3::UdpSocketFactory",
+                               InetSocketAddress(Ipv4Address::GetAny(), port1));
+      a0 = sink0.Install(ap.Get(0));
+      a1 = sink1.Install(ap.Get(0));
+      LatencyTagger::Install(sta0);
+      LatencyTagger::Install(sta1);
+    }
+    else
+    {
+      PacketSinkHelper sink0("ns3::UdpSocketFactory",
+                             InetSocketAddress(Ipv4Address::GetAny(), port0));
+      PacketSinkHelper sink1("ns3::UdpSocketFactory",
+                             InetSocketAddress(Ipv4Address::GetAny(), port1));
+      a0 = sink0.Install(ap.Get(0));
+      a1 = sink1.Install(ap.Get(0));
+    }
     a0.Start(Seconds(0.0)); a0.Stop(Seconds(simStop));
     a1.Start(Seconds(0.0)); a1.Stop(Seconds(simStop));
-    sink0Ptr = DynamicCast<PacketSink>(a0.Get(0));
-    sink1Ptr = DynamicCast<PacketSink>(a1.Get(0));
+    sink0Ptr = a0.Get(0);
+    sink1Ptr = a1.Get(0);
   }
 
   Address apAddr0(InetSocketAddress(ifAp.GetAddress(0), port0));
@@ -200,6 +246,18 @@ int main(int argc, char* argv[])
   src0.Start(Seconds(appStart)); src0.Stop(Seconds(appStop));
   src1.Start(Seconds(appStart)); src1.Stop(Seconds(appStop));
 
+  // -------- Optional goodput time series (warm-up vs steady state) --------
+  GoodputSampler sampler(Seconds(sampleInterval > 0 ? sampleInterval : 1.0));
+  if (sampleInterval > 0)
+  {
+    sampler.SetBytesSource([sink0Ptr, sink1Ptr]() { return GetSinkTotalRx(sink0Ptr) + GetSinkTotalRx(sink1Ptr); });
+    sampler.Start(Seconds(appStart), Seconds(appStop));
+    if (earlyStop > 0)
+    {
+      sampler.EnableEarlyStop(earlyStop);
+    }
+  }
+
   // -------- FlowMonitor (for PDR) --------
   FlowMonitorHelper fmHelper; Ptr<FlowMonitor> monitor = fmHelper.InstallAll();
 
@@ -218,11 +276,18 @@ int main(int argc, char* argv[])
 
   // -------- Run --------
   Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
   Simulator::Run();
 
+  // An early stop shortens the measurement window.
+  if (sampler.StoppedEarly())
+  {
+    txWindow = sampler.GetStopTime().GetSeconds() - appStart;
+  }
+
   // -------- Per-flow throughput from sink pointers --------
-  uint64_t rxBytes0 = sink0Ptr ? sink0Ptr->GetTotalRx() : 0;
-  uint64_t rxBytes1 = sink1Ptr ? sink1Ptr->GetTotalRx() : 0;
+  uint64_t rxBytes0 = sink0Ptr ? GetSinkTotalRx(sink0Ptr) : 0;
+  uint64_t rxBytes1 = sink1Ptr ? GetSinkTotalRx(sink1Ptr) : 0;
   const double thr0_Mbps = (rxBytes0 * 8.0 / txWindow) / 1e6;
   const double thr1_Mbps = (rxBytes1 * 8.0 / txWindow) / 1e6;
   const double thrT_Mbps = thr0_Mbps + thr1_Mbps;
@@ -266,6 +331,20 @@ int main(int argc, char* argv[])
   std::cout << "PDR STA1 (rx/tx)   : " << rx1 << "/" << tx1
             << " = " << (pdr1 * 100.0) << "%\n";
 
+  if (sampleInterval > 0)
+  {
+    sampler.Report(std::cout);
+  }
+
+  if (latencyStats)
+  {
+    Banner("Per-flow latency (CountingSink)");
+    std::cout << "-- STA0 sink (port " << port0 << ")\n";
+    DynamicCast<CountingSink>(sink0Ptr)->Report(std::cout, appStart);
+    std::cout << "-- STA1 sink (port " << port1 << ")\n";
+    DynamicCast<CountingSink>(sink1Ptr)->Report(std::cout, appStart);
+  }
+
   // -------- Optional CSV append --------
   if (!csvPath.empty())
   {
@@ -294,6 +373,49 @@ int main(int argc, char* argv[])
     }
   }
 
+  // -------- Optional typed result row --------
+  if (!resultsDir.empty())
+  {
+    ResultsSink results(resultsDir, "lab3-hidden", 1);
+    const uint32_t cRts  = results.AddColumn("rts_cts",        ColumnarTable::U32);
+    const uint32_t cDist = results.AddColumn("distance_m",     ColumnarTable::F64);
+    const uint32_t cPkt  = results.AddColumn("pkt_size",       ColumnarTable::U32);
+    const uint32_t cSeed = results.AddColumn("seed",           ColumnarTable::U32);
+    const uint32_t cRate = results.AddColumn("app_rate",       ColumnarTable::STR);
+    const uint32_t cThr0 = results.AddColumn("thr_sta0_mbps",  ColumnarTable::F64);
+    const uint32_t cThr1 = results.AddColumn("thr_sta1_mbps",  ColumnarTable::F64);
+    const uint32_t cThrT = results.AddColumn("thr_total_mbps", ColumnarTable::F64);
+    const uint32_t cPdr0 = results.AddColumn("pdr_sta0",       ColumnarTable::F64);
+    const uint32_t cPdr1 = results.AddColumn("pdr_sta1",       ColumnarTable::F64);
+    const uint32_t cTx0  = results.AddColumn("tx0",            ColumnarTable::U64);
+    const uint32_t cRx0  = results.AddColumn("rx0",            ColumnarTable::U64);
+    const uint32_t cTx1  = results.AddColumn("tx1",            ColumnarTable::U64);
+    const uint32_t cRx1  = results.AddColumn("rx1",            ColumnarTable::U64);
+    results.Set(cRts,  uint64_t(enableRtsCts ? 1 : 0));
+    results.Set(cDist, distance);
+    results.Set(cPkt,  uint64_t(pktSize));
+    results.Set(cSeed, uint64_t(seedRun));
+    results.Set(cRate, appRate);
+    results.Set(cThr0, thr0_Mbps);
+    results.Set(cThr1, thr1_Mbps);
+    results.Set(cThrT, thrT_Mbps);
+    results.Set(cPdr0, pdr0);
+    results.Set(cPdr1, pdr1);
+    results.Set(cTx0,  tx0);
+    results.Set(cRx0,  rx0);
+    results.Set(cTx1,  tx1);
+    results.Set(cRx1,  rx1);
+    results.EndRow();
+    if (results.Close())
+    {
+      std::cout << "Result row written: " << results.GetSegmentPath() << "\n";
+    }
+    else
+    {
+      std::cerr << "ERROR: cannot write results to " << resultsDir << "\n";
+    }
+  }
+
   if (enableAnim) { delete anim; anim = nullptr; }
   Simulator::Destroy();
   return 0;
@@ -25,14 +25,42 @@
  *   # change spacing or app rate; enable NetAnim/pcap for debugging:
  *   --run "scratch/Lab3_Cpp_PayloadSweep --distance=200 --appRate=1Mbps --enableAnim=0 --enablePcap=0"
  *
+ *   # per-case memory report (peak RSS + pool counters), run with --pool=0 and
+ *   # --pool=1 to compare:
+ *   --run "scratch/Lab3_Cpp_PayloadSweep --memStats=1 --pool=1"
+ *
+ *   # steady-state goodput (OLSR warm-up excluded), stop each case once converged:
+ *   --run "scratch/Lab3_Cpp_PayloadSweep --sampleInterval=0.05 --earlyStop=0.03"
+ *
+ *   # big grid: progress every 5 s, give up on any case after 2 min or 2 GiB:
+ *   --run "scratch/Lab3_Cpp_PayloadSweep --nodes=3,6,10,20 --progress=5 --maxWall=120 --maxRssMb=2048"
+ *
  * CSV columns:
  *   nodes,pktSize,seed,rxBytes,throughput_Mbps
+ *   (+ steady_Mbps,steady_ci_Mbps,warmup_s,transient_Mbps,window_s with --sampleInterval)
+ *   (+ status: ok | timeout | memory, only when --maxWall or --maxRssMb is set)
  *
  * Notes:
  *   - If you see zero throughput: check that routing is enabled (OLSR here) and
  *     that spacing keeps only NEIGHBORS in range (Two-Ray + 200 m spacing).
  *   - We lock both DataMode and ControlMode to DsssRate1Mbps (no rate control).
  *   - Each (nodes, pktSize, seed) is its own fresh simulation (init→run→destroy).
+ *   - With --pool=1, packets, buffers, tags and events come from a size-class
+ *     pool (lab-pool-allocator.h) whose slabs are reused from case to case. The
+ *     default is --pool=0 (plain malloc): the pool stays opt-in until a
+ *     before/after --memStats comparison shows it lowers peak RSS.
+ *     Copy common/include/*.h next to this file (scripts/stage_scratch.sh does it).
+ *   - --sampleInterval samples the sink goodput per interval and finds the OLSR
+ *     warm-up with MSER-5 (lab-goodput-sampler.h). throughput_Mbps stays the
+ *     classic bytes/window figure; steady_Mbps excludes the warm-up. With
+ *     --earlyStop a case ends as soon as steady_Mbps is known to that relative
+ *     precision, and window_s records how long it actually ran.
+ *   - Progress lines ([progress] sim time, wall time, events/s, ETA) go to stderr
+ *     every --progress wall seconds, so only slow cases print them. A case that
+ *     exceeds --maxWall or --maxRssMb is stopped cleanly, its partial numbers are
+ *     written with status=timeout/memory, and the grid moves on. Its
+ *     throughput_Mbps is over the part of the window that ran (nan if it
+ *     stopped before the traffic started).
  */
 
 #include "ns3/core-module.h"
@@ -50,9 +78,18 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <limits>
+
+#include "lab-pool-allocator.h"
+#include "lab-proc-stats.h"
+#include "lab-goodput-sampler.h"
+#include "lab-progress.h"
+#include "lab-startup-profiler.h"
 
 using namespace ns3;
 
+LAB_POOL_INSTALL_OPERATORS()
+
 // ------------ small helpers for CLI parsing & banner ------------
 
 static std::vector<uint32_t> ParseUintList(const std::string& csv)
@@ -70,9 +107,18 @@ static std::vector<uint32_t> ParseUintList(const std::string& csv)
   return out;
 }
 
-static void CsvPrintHeader(std::ostream& os)
+static void CsvPrintHeader(std::ostream& os, bool sampled, bool budget)
 {
-  os << "nodes,pktSize,seed,rxBytes,throughput_Mbps\n";
+  os << "nodes,pktSize,seed,rxBytes,throughput_Mbps";
+  if (sampled)
+  {
+    os << ",steady_Mbps,steady_ci_Mbps,warmup_s,transient_Mbps,window_s";
+  }
+  if (budget)
+  {
+    os << ",status";
+  }
+  os << "\n";
 }
 
 static void Banner(const std::string& s)
@@ -89,6 +135,13 @@ struct CaseResult
   uint32_t seed;
   uint64_t rxBytes;
   double throughputMbps;
+  // Goodput time series (--sampleInterval); windowSeconds < 9 after an early stop
+  GoodputSampler::Result series;
+  double windowSeconds;
+  std::string status;     // "ok", or why the budget stopped the case
+  // Memory diagnostics (printed with --memStats, not part of the CSV)
+  uint64_t peakRssKb;
+  PoolAllocator::Stats pool;
 };
 
 static CaseResult RunOneCase(uint32_t nodesCount,
@@ -97,18 +150,27 @@ static CaseResult RunOneCase(uint32_t nodesCount,
                              double distance,
                              const std::string& appRate,
                              bool enablePcap,
-                             bool enableAnim)
+                             bool enableAnim,
+                             double sampleInterval,
+                             double earlyStop,
+                             double progressEvery,
+                             double maxWall,
+                             uint64_t maxRssMb)
 {
   // FIXED lab timing: send 1..10 s, stop at 11 s.
   const double appStart = 1.0;
   const double appStop  = 10.0;
   const double simStop  = 11.0;
-  const double txWindow = appStop - appStart; // = 9.0
+  double txWindow = appStop - appStart;       // = 9.0 (unless stopped early)
 
   // Deterministic seed + variable run (matches Lab convention).
   RngSeedManager::SetSeed(1);
   RngSeedManager::SetRun(seedRun);
 
+  // Per-case peak RSS; pool counters are closed when the simulator is destroyed.
+  ResetPeakRss();
+  Simulator::ScheduleDestroy(&PoolAllocator::EndCase);
+
   // ---------------- nodes ----------------
   NodeContainer nodes;
   nodes.Create(nodesCount);
@@ -180,6 +242,19 @@ static CaseResult RunOneCase(uint32_t nodesCount,
   srcApp.Start(Seconds(appStart));
   srcApp.Stop(Seconds(appStop));
 
+  // ---------------- optional goodput time series ----------------
+  GoodputSampler sampler(Seconds(sampleInterval > 0 ? sampleInterval : 1.0));
+  if (sampleInterval > 0)
+  {
+    Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApp.Get(0));
+    sampler.SetBytesSource([sink]() { return sink->GetTotalRx(); });
+    sampler.Start(Seconds(appStart), Seconds(appStop));
+    if (earlyStop > 0)
+    {
+      sampler.EnableEarlyStop(earlyStop);
+    }
+  }
+
   // ---------------- optional NetAnim ----------------
   AnimationInterface* anim = nullptr;
   if (enableAnim)
@@ -198,8 +273,17 @@ static CaseResult RunOneCase(uint32_t nodesCount,
     }
   }
 
+  // ---------------- progress + budget ----------------
+  std::ostringstream label;
+  label << "n=" << nodesCount << " p=" << pktSize << " s=" << seedRun;
+  ProgressMonitor progress(Seconds(simStop), label.str());
+  progress.SetReportInterval(progressEvery);
+  progress.SetBudget(maxWall, maxRssMb);
+  progress.Start();
+
   // ---------------- run ----------------
   Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
   Simulator::Run();
 
   // ---------------- metrics (authoritative via sink) ----------------
@@ -208,12 +292,26 @@ static CaseResult RunOneCase(uint32_t nodesCount,
     Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApp.Get(0));
     rxBytes = sink ? sink->GetTotalRx() : 0;
   }
-  const double throughputMbps = (rxBytes * 8.0 / txWindow) / 1e6;
+  if (sampler.StoppedEarly())
+  {
+    txWindow = sampler.GetStopTime().GetSeconds() - appStart;
+  }
+  else if (progress.Aborted())
+  {
+    // Cut short by --maxWall / --maxRssMb: only the traffic that had time to run.
+    txWindow = std::min(Simulator::Now().GetSeconds(), appStop) - appStart;
+  }
+  // NaN when the run stopped before any traffic was offered.
+  const double throughputMbps = txWindow > 0.0 ? (rxBytes * 8.0 / txWindow) / 1e6
+                                               : std::numeric_limits<double>::quiet_NaN();
+  const GoodputSampler::Result series = sampler.Analyse();
+  const PoolAllocator::Stats poolStats = PoolAllocator::GetStats();
 
   if (anim) { delete anim; anim = nullptr; }
   Simulator::Destroy();
 
-  return CaseResult{nodesCount, pktSize, seedRun, rxBytes, throughputMbps};
+  return CaseResult{nodesCount, pktSize, seedRun, rxBytes, throughputMbps,
+                    series, txWindow, progress.Status(), GetPeakRssKb(), poolStats};
 }
 
 // ------------ main: parse CLI, loop grid, emit CSV ------------
@@ -229,6 +327,13 @@ int main(int argc, char* argv[])
   bool enablePcap      = false;
   bool enableAnim      = false;
   std::string csvPath  = "";           // empty → print to stdout
+  bool usePool         = false;         // size-class pool for packets/events
+  bool memStats        = false;        // print per-case peak RSS + pool counters
+  double sampleInterval = 0.0;         // goodput sampling period (s), 0 = off
+  double earlyStop     = 0.0;          // per-case stop at this relative CI, 0 = off
+  double progressEvery = 10.0;         // wall seconds between [progress] lines, 0 = off
+  double maxWall       = 0.0;          // per-case wall-time budget (s), 0 = unlimited
+  uint64_t maxRssMb    = 0;            // per-case RSS budget (MiB), 0 = unlimited
 
   CommandLine cmd;
   cmd.AddValue("nodes",      "Comma-separated list of node counts (e.g., 3,4,5,6).", nodesCsv);
@@ -239,7 +344,17 @@ int main(int argc, char* argv[])
   cmd.AddValue("enablePcap", "Enable PCAP (promisc) dumps for debugging.",          enablePcap);
   cmd.AddValue("enableAnim", "Write NetAnim XML per run.",                           enableAnim);
   cmd.AddValue("csv",        "If non-empty, write CSV to this path; otherwise stdout.", csvPath);
+  cmd.AddValue("pool",       "Serve small allocations from the size-class pool.",   usePool);
+  cmd.AddValue("memStats",   "Print per-case peak RSS and pool counters.",          memStats);
+  cmd.AddValue("sampleInterval", "Goodput sampling period in seconds (0 = off).",   sampleInterval);
+  cmd.AddValue("earlyStop",  "End a case once steady-state CI < this fraction.",     earlyStop);
+  cmd.AddValue("progress",   "Wall seconds between progress lines on stderr (0 = off).", progressEvery);
+  cmd.AddValue("maxWall",    "Per-case wall-time budget in seconds (0 = unlimited).", maxWall);
+  cmd.AddValue("maxRssMb",   "Per-case resident memory budget in MiB (0 = unlimited).", maxRssMb);
   cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
 
   // Parse lists
   std::vector<uint32_t> nodesList = ParseUintList(nodesCsv);
@@ -266,7 +381,9 @@ int main(int argc, char* argv[])
     out = &ofs;
   }
 
-  CsvPrintHeader(*out);
+  // The status column only exists when a budget can stop a case.
+  const bool budget = maxWall > 0.0 || maxRssMb > 0;
+  CsvPrintHeader(*out, sampleInterval > 0, budget);
 
   // Fixed order: for stable diffs/logs
   for (uint32_t n : nodesList)
@@ -284,15 +401,40 @@ int main(int argc, char* argv[])
                " pkt=" + std::to_string(p) +
                " seed=" + std::to_string(s));
 
-        CaseResult r = RunOneCase(n, p, s, distance, appRate, enablePcap, enableAnim);
+        CaseResult r = RunOneCase(n, p, s, distance, appRate, enablePcap, enableAnim,
+                                  sampleInterval, earlyStop,
+                                  progressEvery, maxWall, maxRssMb);
 
         // CSV line
         (*out) << r.nodes << ","
                << r.pktSize << ","
                << r.seed << ","
                << r.rxBytes << ","
-               << r.throughputMbps << "\n";
+               << r.throughputMbps;
+        if (sampleInterval > 0)
+        {
+          (*out) << "," << r.series.steadyBps / 1e6
+                 << "," << r.series.ciHalfBps / 1e6
+                 << "," << r.series.warmupSeconds
+                 << "," << r.series.transientBps / 1e6
+                 << "," << r.windowSeconds;
+        }
+        if (budget)
+        {
+          (*out) << "," << r.status;
+        }
+        (*out) << "\n";
         out->flush();
+
+        if (memStats)
+        {
+          std::cout << "[mem] peakRss=" << r.peakRssKb << " KiB"
+                    << "  pooled=" << r.pool.pooledAllocs
+                    << " (reused " << r.pool.reusedBlocks << ")"
+                    << "  malloc=" << r.pool.systemAllocs
+                    << "  slabs=" << r.pool.slabs
+                    << " (" << (r.pool.slabs * PoolAllocator::kSlabBytes / 1024) << " KiB)\n";
+        }
       }
     }
   }
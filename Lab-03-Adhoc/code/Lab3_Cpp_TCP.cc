@@ -32,6 +32,18 @@
  *   --enablePcap : 1 → write PCAPs (promiscuous) for all nodes
  *   --enableAnim : 1 → write NetAnim XML (Lab3_TCP.xml)
  *   --csv        : optional CSV path; if empty, prints to stdout
+ *   --results    : result directory (lab-results.h); the same row as a typed,
+ *                  schema-versioned record (schema lab3-tcp), safe with many
+ *                  concurrent runs. Read it with common/scripts/labcol.py
+ *   --latencyStats : 1 → CountingSink instead of PacketSink; prints one-way delay
+ *                  p50/p99/p99.9, jitter and per-second goodput (default 0).
+ *                  For TCP the delay is measured from the LAST transmission of
+ *                  the segment (retransmissions restart the clock).
+ *   --sampleInterval : >0 → sample sink goodput every S seconds; prints detected
+ *                  warm-up (slow start, OLSR) and steady-state goodput ± 95 % CI (MSER-5) (default 0)
+ *   --earlyStop  : >0 → end the run once that CI is within this fraction of the
+ *                  mean (needs --sampleInterval); throughput then uses the
+ *                  shortened window (default 0)
  *
  * CSV columns:
  *   pktSize,seed,rxBytes,throughput_Mbps
@@ -54,8 +66,16 @@
 #include <string>
 #include <iostream>
 
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-counting-sink.h"    // CountingSink + latency histograms (--latencyStats)
+#include "lab-goodput-sampler.h"  // goodput time series + warm-up detection (--sampleInterval)
+#include "lab-results.h"          // typed result rows (--results)
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
 using namespace ns3;
 
+LAB_POOL_INSTALL_OPERATORS()
+
 static void
 Banner(const std::string& title)
 {
@@ -72,6 +92,11 @@ int main(int argc, char* argv[])
   bool enablePcap     = false;   // PCAP off by default
   bool enableAnim     = false;   // NetAnim off by default
   std::string csvPath = "";      // empty → print results to stdout
+  std::string resultsDir = "";   // lab-results.h store if non-empty
+  bool usePool        = false;             // size-class pool for packets/events
+  bool latencyStats   = false;            // CountingSink + delay histograms
+  double sampleInterval = 0.0;            // goodput sampling period (s), 0 = off
+  double earlyStop    = 0.0;              // stop at this relative CI half-width, 0 = off
 
   CommandLine cmd;
   cmd.AddValue("pktSize",    "TCP segment size (bytes).", pktSize);
@@ -81,7 +106,15 @@ int main(int argc, char* argv[])
   cmd.AddValue("enablePcap", "Enable per-node PCAP traces.", enablePcap);
   cmd.AddValue("enableAnim", "Write NetAnim XML.",           enableAnim);
   cmd.AddValue("csv",        "If non-empty, write CSV to this path.", csvPath);
+  cmd.AddValue("results",    "Result directory (lab-results.h).",     resultsDir);
+  cmd.AddValue("pool",       "Serve packets/events from the size-class pool.", usePool);
+  cmd.AddValue("latencyStats", "Per-flow delay percentiles via CountingSink.", latencyStats);
+  cmd.AddValue("sampleInterval", "Goodput sampling period in seconds (0 = off).", sampleInterval);
+  cmd.AddValue("earlyStop",  "Stop once steady-state CI half-width < this fraction.", earlyStop);
   cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
 
   // Sanity
   if (pktSize < 64)
@@ -97,7 +130,7 @@ int main(int argc, char* argv[])
   const double appStart = 1.0;
   const double appStop  = 10.0;
   const double simStop  = 11.0;
-  const double txWindow = appStop - appStart; // should be 9.0
+  double txWindow = appStop - appStart;       // should be 9.0 (unless --earlyStop)
 
   // -------- Topology: 3 nodes line (0 m, d, 2d) --------
   NodeContainer nodes;
@@ -166,8 +199,18 @@ int main(int argc, char* argv[])
 
   // Sink (server) to count received bytes at the application layer
   Address sinkLocalAddr(InetSocketAddress(Ipv4Address::GetAny(), port));
-  PacketSinkHelper sinkHelper("ns3::TcpSocketFactory", sinkLocalAddr);
-  ApplicationContainer sinkApp = sinkHelper.Install(nodes.Get(2));
+  ApplicationContainer sinkApp;
+  if (latencyStats)
+  {
+    CountingSinkHelper sinkHelper("ns3::TcpSocketFactory", sinkLocalAddr);
+    sinkApp = sinkHelper.Install(nodes.Get(2));
+    LatencyTagger::Install(nodes.Get(0));
+  }
+  else
+  {
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory", sinkLocalAddr);
+    sinkApp = sinkHelper.Install(nodes.Get(2));
+  }
   sinkApp.Start(Seconds(0.0));
   sinkApp.Stop(Seconds(simStop));
 
@@ -180,6 +223,18 @@ int main(int argc, char* argv[])
   srcApp.Start(Seconds(appStart));
   srcApp.Stop(Seconds(appStop));
 
+  // -------- Optional goodput time series (warm-up vs steady state) --------
+  GoodputSampler sampler(Seconds(sampleInterval > 0 ? sampleInterval : 1.0));
+  if (sampleInterval > 0)
+  {
+    sampler.SetBytesSource([&sinkApp]() { return GetSinkTotalRx(sinkApp.Get(0)); });
+    sampler.Start(Seconds(appStart), Seconds(appStop));
+    if (earlyStop > 0)
+    {
+      sampler.EnableEarlyStop(earlyStop);
+    }
+  }
+
   // -------- FlowMonitor (informational; handy for debugging) --------
   FlowMonitorHelper fmHelper;
   Ptr<FlowMonitor> monitor = fmHelper.InstallAll();
@@ -198,14 +253,17 @@ int main(int argc, char* argv[])
 
   // -------- Run --------
   Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
   Simulator::Run();
 
-  // -------- Primary metric: sink-based throughput over 9 s window --------
-  uint64_t rxBytes = 0;
+  // An early stop shortens the measurement window.
+  if (sampler.StoppedEarly())
   {
-    Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApp.Get(0));
-    rxBytes = sink ? sink->GetTotalRx() : 0;
+    txWindow = sampler.GetStopTime().GetSeconds() - appStart;
   }
+
+  // -------- Primary metric: sink-based throughput over 9 s window --------
+  uint64_t rxBytes = GetSinkTotalRx(sinkApp.Get(0));
   const double throughputMbps = (rxBytes * 8.0 / txWindow) / 1e6;
 
   // -------- FlowMonitor: print per-flow stats (ns-3.40 API) --------
@@ -241,6 +299,17 @@ int main(int argc, char* argv[])
             << throughputMbps << " Mb/s"
             << "  (" << rxBytes << " bytes over " << txWindow << " s)\n";
 
+  if (sampleInterval > 0)
+  {
+    sampler.Report(std::cout);
+  }
+
+  if (latencyStats)
+  {
+    Banner("Per-flow latency (CountingSink)");
+    DynamicCast<CountingSink>(sinkApp.Get(0))->Report(std::cout, appStart);
+  }
+
   // -------- Optional CSV output (one line) --------
   if (!csvPath.empty())
   {
@@ -258,6 +327,33 @@ int main(int argc, char* argv[])
     }
   }
 
+  // -------- Optional typed result row --------
+  if (!resultsDir.empty())
+  {
+    ResultsSink results(resultsDir, "lab3-tcp", 1);
+    const uint32_t cPkt  = results.AddColumn("pkt_size",        ColumnarTable::U32);
+    const uint32_t cSeed = results.AddColumn("seed",            ColumnarTable::U32);
+    const uint32_t cDist = results.AddColumn("distance_m",      ColumnarTable::F64);
+    const uint32_t cRate = results.AddColumn("app_rate",        ColumnarTable::STR);
+    const uint32_t cRx   = results.AddColumn("rxBytes",         ColumnarTable::U64);
+    const uint32_t cThr  = results.AddColumn("throughput_mbps", ColumnarTable::F64);
+    results.Set(cPkt,  uint64_t(pktSize));
+    results.Set(cSeed, uint64_t(seedRun));
+    results.Set(cDist, distance);
+    results.Set(cRate, appRate);
+    results.Set(cRx,   rxBytes);
+    results.Set(cThr,  throughputMbps);
+    results.EndRow();
+    if (results.Close())
+    {
+      std::cout << "Result row written: " << results.GetSegmentPath() << "\n";
+    }
+    else
+    {
+      std::cerr << "ERROR: cannot write results to " << resultsDir << "\n";
+    }
+  }
+
   // -------- Cleanup --------
   if (anim) { delete anim; anim = nullptr; }
   Simulator::Destroy();
@@ -0,0 +1,868 @@
+/*
+ * Lab 04 — Multi-cell / multi-UE LTE scaling scenario (hex grid, EPC)
+ * -------------------------------------------------------------------
+ * What this program builds:
+ *   N sites on a hexagonal grid, each with 1 or 3 sectors (cells), and U UEs
+ *   dropped uniformly over the grid. One remote host sits behind the PGW.
+ *
+ *        site (3 sectors @ 0/120/240 deg)        UE ... UE
+ *            \   |   /                              |
+ *             eNB cells  <--S1-U-->  PGW  <---->  Remote host
+ *
+ *   - Every UE receives a downlink UDP flow (--dlRate).
+ *   - A fraction of the UEs (--ulFraction) also sends an uplink UDP flow (--ulRate).
+ *   - Same radio configuration as Lab4_Cpp_LTE: PiroEW2010 AMC, EARFCN 100/18100,
+ *     50 RBs, frequency reuse 1; scheduler selectable (default PfFfMacScheduler).
+ *
+ * Why this exists:
+ *   Lab4_Cpp_LTE.cc is one eNB, one UE. For capacity planning we need tens of
+ *   eNBs and hundreds of UEs, plus numbers on how wall time and memory scale with
+ *   the UE count. The scenario is built in bulk: one InstallEnbDevice call per
+ *   sector orientation, one InstallUeDevice, one AssignUeIpv4Address and one
+ *   AttachToClosestEnb for all UEs. No traces are written.
+ *
+ * Hex grid:
+ *   Sites are laid out row by row, GridWidth per row, odd rows shifted by ISD/2,
+ *   rows ISD*sqrt(3)/2 apart (the same layout as LteHexGridEnbTopologyHelper).
+ *   With --sectors=3 each site gets three cells whose antennas point at 0, 120
+ *   and 240 degrees. The antennas sit 0.5 m from the mast towards their boresight,
+ *   so "closest eNB" attachment picks the sector facing the UE.
+ *   Sectorisation needs a directional antenna: --antenna=cosine or parabolic.
+ *
+ * Output:
+ *   - per-case summary line: cells, UEs attached, DL/UL totals, build/run wall time,
+ *     events, events/s and peak RSS;
+ *   - per-cell table (--cellCsv, also printed when a single case runs);
+ *   - per-UE rows (--ueCsv): cell, position, DL/UL goodput;
+ *   - scaling rows (--scalingCsv), one per entry of --ues.
+ *     Lab-04-LTE/code/plot_lte_scaling.py plots them.
+ *   - Jain fairness index and 5th-percentile UE goodput (DL), always printed.
+ *
+ * Scheduler benchmark (--schedulers=pf,rr,tdmt,tta,pss,cqa):
+ *   Runs every scheduler at every --ues entry, with the scheduler wrapped in
+ *   InstrumentedFfMacScheduler (common/include/lab-scheduler-probe.h). Per case
+ *   it reports, per direction: UEs considered / scheduled and RBGs (DL) or RBs
+ *   (UL) per busy TTI, and the allocation wall time per TTI (mean / p99 / max).
+ *   It also reports the scheduler's share of the run's wall time. A share that
+ *   grows with the UE count marks a scheduler that becomes the simulation
+ *   bottleneck. --schedCsv collects one row per case; --schedProbe=1 adds the
+ *   same report to a normal run.
+ *
+ * CLI examples:
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_MultiCell --sites=7 --sectors=3 --ues=105"
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_MultiCell --sites=19 --ues=50,100,200,400 --simTime=3 --scalingCsv=scaling.csv"
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_MultiCell --sites=7 --sectors=1 --antenna=isotropic --ues=70 --ueCsv=ues.csv"
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_MultiCell --sites=7 --ues=42,105,210 --simTime=2 --schedulers=pf,rr,tdmt,tta,pss,cqa --schedCsv=sched.csv"
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_MultiCell --sites=19 --ues=200,400 --fastAttach=1 --scalingCsv=scaling.csv"
+ *
+ * Key CLI flags:
+ *   --sites       : number of sites on the hex grid (default 7)
+ *   --gridWidth   : sites per row (0 → ceil(sqrt(sites)))
+ *   --isd         : inter-site distance in meters (default 500)
+ *   --sectors     : 1 or 3 cells per site (default 3)
+ *   --antenna     : cosine | parabolic | isotropic (default parabolic)
+ *   --ues         : UE count, or a comma list for a scaling sweep (default 105)
+ *   --ulFraction  : fraction of UEs that also send uplink (default 0.3)
+ *   --dlRate / --ulRate : per-UE offered load (default 2Mbps / 512kbps)
+ *   --simTime     : seconds of traffic (apps run [1, 1+simTime]) (default 5)
+ *   --scheduler   : pf | rr | tdmt | fdmt | tta | tdbet | fdbet | tdtbfq | fdtbfq | pss | cqa,
+ *                   or a full TypeId (default pf)
+ *   --schedProbe  : time every scheduler trigger and print the per-TTI cost (default 0)
+ *   --schedulers  : benchmark list (implies --schedProbe=1)
+ *   --seed        : RNG run number
+ *   --cellCsv / --ueCsv / --scalingCsv / --schedCsv : optional CSV outputs
+ *   --traces      : PDCP/RLC stats: none (default) | binary | text | both.
+ *                   binary aggregates per-bearer bytes/PDUs/delay quantiles in
+ *                   memory (lab-bearer-stats.h) and writes one columnar file per
+ *                   case (--statsFile, --statsEpoch); text is the LTE helper's
+ *                   *PdcpStats.txt / *RlcStats.txt and costs I/O with many UEs.
+ *   --antennaTable: tabulate the eNB antenna pattern on this initial grid in
+ *                   degrees (lab-tabulated-antenna.h); 0 = analytic (default)
+ *   --antennaMaxError : error bound of the table in dB (default 0.05)
+ *   --fastAttach  : ideal RRC, SIB2 every 10 ms, 64 RA preambles
+ *                   (lab-fast-attach.h), and traffic starts at --attachTime
+ *                   (default 0.2 s) instead of 1 s. Prints how many UEs had
+ *                   their bearer up by then.
+ *   --pool        : serve packets/events from the size-class pool (default 0)
+ *
+ * Notes:
+ *   - Up to 320 UEs per cell (LteEnbRrc SRS periodicity limit); the program picks
+ *     the smallest SRS periodicity that fits the busiest cell of the drop.
+ *   - Handover is off (NoOpHandoverAlgorithm), so the serving cell is the one
+ *     chosen at attach time.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-proc-stats.h"       // wall clock + peak RSS per case
+#include "lab-scheduler-probe.h"  // per-TTI scheduler cost (--schedProbe / --schedulers)
+#include "lab-bearer-stats.h"     // in-memory PDCP/RLC stats → .labcol (--traces=binary)
+#include "lab-tabulated-antenna.h" // antenna gain tables (--antennaTable)
+#include "lab-fast-attach.h"      // short attach phase (--fastAttach)
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+LAB_POOL_INSTALL_OPERATORS()
+
+// ---------- Small helpers ----------
+
+// Same mapping as Lab4_Cpp_LTE.cc.
+static std::string
+ResolveAntennaTypeId(const std::string& user)
+{
+  std::string s = user;
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return std::tolower(c); });
+  if (s == "isotropic") return "ns3::IsotropicAntennaModel";
+  if (s == "cosine")    return "ns3::CosineAntennaModel";
+  if (s == "parabolic") return "ns3::ParabolicAntennaModel";
+  return "ns3::IsotropicAntennaModel";
+}
+
+static void
+Banner(const std::string& title)
+{
+  std::cout << "\n==== " << title << " ====\n";
+}
+
+static std::vector<uint32_t>
+ParseUintList(const std::string& csv)
+{
+  std::vector<uint32_t> out;
+  std::stringstream ss(csv);
+  std::string tok;
+  while (std::getline(ss, tok, ','))
+  {
+    if (!tok.empty())
+    {
+      out.push_back(static_cast<uint32_t>(std::stoul(tok)));
+    }
+  }
+  return out;
+}
+
+// Hexagonal site grid: row-major, odd rows shifted by isd/2.
+static std::vector<Vector>
+HexGridSites(uint32_t nSites, double isd, uint32_t gridWidth, double height)
+{
+  std::vector<Vector> sites;
+  sites.reserve(nSites);
+  const double rowStep = isd * std::sqrt(3.0) / 2.0;
+  for (uint32_t i = 0; i < nSites; ++i)
+  {
+    const uint32_t row = i / gridWidth;
+    const uint32_t col = i % gridWidth;
+    const double x = col * isd + ((row % 2) ? isd / 2.0 : 0.0);
+    sites.emplace_back(x, row * rowStep, height);
+  }
+  return sites;
+}
+
+// Smallest LteEnbRrc::SrsPeriodicity that accommodates 'ues' UEs in one cell.
+static uint32_t
+SrsPeriodicityFor(uint32_t ues)
+{
+  for (uint32_t p : {2u, 5u, 10u, 20u, 40u, 80u, 160u, 320u})
+  {
+    if (ues < p)
+    {
+      return p;
+    }
+  }
+  return 320;
+}
+
+// Most UEs AttachToClosestEnb will put in one cell: every UE goes to the
+// nearest eNB, ties to the first in install order (sector by sector, the
+// order 'sectorNodes' is installed in). Needs the mobility models in place.
+static uint32_t
+MaxUesPerCell(const std::vector<NodeContainer>& sectorNodes, const NodeContainer& ueNodes)
+{
+  std::vector<Ptr<MobilityModel>> enbs;
+  for (const NodeContainer& nodes : sectorNodes)
+  {
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+      enbs.push_back(nodes.Get(i)->GetObject<MobilityModel>());
+    }
+  }
+  std::vector<uint32_t> perCell(enbs.size(), 0);
+  for (uint32_t u = 0; u < ueNodes.GetN(); ++u)
+  {
+    Ptr<MobilityModel> ue = ueNodes.Get(u)->GetObject<MobilityModel>();
+    size_t closest = 0;
+    double minDistance = std::numeric_limits<double>::infinity();
+    for (size_t e = 0; e < enbs.size(); ++e)
+    {
+      const double d = enbs[e]->GetDistanceFrom(ue);
+      if (d < minDistance)
+      {
+        minDistance = d;
+        closest = e;
+      }
+    }
+    ++perCell[closest];
+  }
+  return perCell.empty() ? 0 : *std::max_element(perCell.begin(), perCell.end());
+}
+
+// Jain's fairness index (sum x)^2 / (n sum x^2); 1 = perfectly fair.
+static double
+JainIndex(const std::vector<double>& x)
+{
+  double s = 0.0, s2 = 0.0;
+  for (double v : x)
+  {
+    s += v;
+    s2 += v * v;
+  }
+  return s2 > 0.0 ? s * s / (x.size() * s2) : 0.0;
+}
+
+// ---------- Scenario description / results ----------
+
+struct ScenarioConfig
+{
+  uint32_t    sites      = 7;
+  uint32_t    gridWidth  = 0;        // 0 → ceil(sqrt(sites))
+  double      isd        = 500.0;    // inter-site distance (m)
+  uint32_t    sectors    = 3;        // 1 or 3 cells per site
+  std::string antenna    = "parabolic";
+  double      antennaTable    = 0.0;  // tabulated eNB pattern grid (deg), 0 = analytic
+  double      antennaMaxError = 0.05; // dB
+  uint32_t    ues        = 105;
+  double      ulFraction = 0.3;
+  std::string dlRate     = "2Mbps";
+  std::string ulRate     = "512kbps";
+  uint32_t    pktSize    = 1024;
+  double      simTime    = 5.0;
+  std::string scheduler  = "pf";     // short name or TypeId
+  bool        schedProbe = false;    // wrap the scheduler in InstrumentedFfMacScheduler
+  std::string traces     = "none";   // PDCP/RLC stats: text | binary | both | none
+  std::string statsFile  = "";       // .labcol output of --traces=binary
+  double      statsEpoch = 0.0;      // binary stats epoch (s), 0 = whole run
+  bool        fastAttach = false;    // short attach phase (lab-fast-attach.h)
+  double      attachTime = 0.2;      // traffic start with --fastAttach (s)
+  uint32_t    seed       = 1;
+};
+
+struct UeStats
+{
+  uint32_t cellId;
+  Vector   pos;
+  uint64_t dlBytes;
+  uint64_t ulBytes;
+  bool     hasUl;
+};
+
+struct CellStats
+{
+  uint32_t site;
+  uint32_t sector;
+  uint32_t ues;
+  uint64_t dlBytes;
+  uint64_t ulBytes;
+};
+
+struct ScenarioResult
+{
+  uint32_t cells;
+  uint32_t attached;          // UEs with a serving cell at the end of the run
+  double   window;            // traffic window (s)
+  double   buildWall;         // topology + install (s)
+  double   runWall;           // Simulator::Run (s)
+  uint64_t events;
+  uint64_t peakRssKb;
+  std::vector<UeStats> perUe;
+  std::map<uint32_t, CellStats> perCell;  // keyed by cellId
+  SchedulerProbeStats schedDl;            // summed over all cells (--schedProbe)
+  SchedulerProbeStats schedUl;
+};
+
+// ---------- One complete simulation ----------
+
+static ScenarioResult
+RunScenario(const ScenarioConfig& cfg)
+{
+  ScenarioResult res{};
+  ResetPeakRss();
+  const double t0 = GetWallClockSeconds();
+
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(cfg.seed);
+
+  const double appStart = cfg.fastAttach ? cfg.attachTime : 1.0;
+  const double sinkStart = std::min(0.5, appStart);
+  const double appStop  = appStart + cfg.simTime;
+  const double simStop  = appStop + 0.1;
+  res.window = appStop - appStart;
+
+  // ---------------- LTE/EPC (same radio config as Lab4_Cpp_LTE) ----------------
+  Config::SetDefault("ns3::LteAmc::AmcModel", EnumValue(LteAmc::PiroEW2010));
+
+  Ptr<LteHelper> lte = CreateObject<LteHelper>();
+  Ptr<PointToPointEpcHelper> epc = CreateObject<PointToPointEpcHelper>();
+  lte->SetEpcHelper(epc);
+  if (cfg.fastAttach)
+  {
+    ConfigureFastAttach(lte);
+  }
+  if (cfg.schedProbe)
+  {
+    lte->SetSchedulerType("ns3::InstrumentedFfMacScheduler");
+    lte->SetSchedulerAttribute("Scheduler", StringValue(ResolveSchedulerTypeId(cfg.scheduler)));
+  }
+  else
+  {
+    lte->SetSchedulerType(ResolveSchedulerTypeId(cfg.scheduler));
+  }
+  lte->SetEnbDeviceAttribute("DlEarfcn",    UintegerValue(100));
+  lte->SetEnbDeviceAttribute("UlEarfcn",    UintegerValue(18100));
+  lte->SetEnbDeviceAttribute("DlBandwidth", UintegerValue(50));
+  lte->SetEnbDeviceAttribute("UlBandwidth", UintegerValue(50));
+
+  const std::string antTypeId = ResolveAntennaTypeId(cfg.antenna);
+  const bool tabulate = cfg.antennaTable > 0.0 && antTypeId != "ns3::IsotropicAntennaModel";
+  if (tabulate)
+  {
+    // Same pattern, read from a gain table shared by every sector
+    lte->SetEnbAntennaModelType("ns3::TabulatedAntennaModel");
+    lte->SetEnbAntennaModelAttribute("Pattern",  StringValue(antTypeId));
+    lte->SetEnbAntennaModelAttribute("Step",     DoubleValue(cfg.antennaTable));
+    lte->SetEnbAntennaModelAttribute("MaxError", DoubleValue(cfg.antennaMaxError));
+  }
+  else
+  {
+    lte->SetEnbAntennaModelType(antTypeId);
+  }
+  if (cfg.sectors == 3)
+  {
+    // 3GPP-style sector patterns
+    if (antTypeId == "ns3::ParabolicAntennaModel")
+    {
+      lte->SetEnbAntennaModelAttribute("Beamwidth",      DoubleValue(70.0));
+      lte->SetEnbAntennaModelAttribute("MaxAttenuation", DoubleValue(20.0));
+    }
+    else if (antTypeId == "ns3::CosineAntennaModel")
+    {
+      lte->SetEnbAntennaModelAttribute(tabulate ? "Beamwidth" : "HorizontalBeamwidth",
+                                       DoubleValue(65.0));
+    }
+  }
+
+  // ---------------- Nodes ----------------
+  const uint32_t gridWidth =
+      cfg.gridWidth ? cfg.gridWidth : static_cast<uint32_t>(std::ceil(std::sqrt(double(cfg.sites))));
+  const std::vector<Vector> sites = HexGridSites(cfg.sites, cfg.isd, gridWidth, 30.0);
+
+  // One NodeContainer per sector orientation → one bulk InstallEnbDevice per orientation.
+  std::vector<NodeContainer> sectorNodes(cfg.sectors);
+  for (uint32_t s = 0; s < cfg.sectors; ++s)
+  {
+    sectorNodes[s].Create(cfg.sites);
+  }
+  NodeContainer ueNodes; ueNodes.Create(cfg.ues);
+  Ptr<Node> pgw = epc->GetPgwNode();
+  NodeContainer remoteHostCont; remoteHostCont.Create(1);
+  Ptr<Node> remoteHost = remoteHostCont.Get(0);
+
+  InternetStackHelper internet;
+  internet.Install(remoteHostCont);
+  internet.Install(ueNodes);
+
+  // ---------------- Mobility ----------------
+  MobilityHelper mobility;
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  for (uint32_t s = 0; s < cfg.sectors; ++s)
+  {
+    const double orient = 360.0 * s / cfg.sectors;
+    const double offset = (cfg.sectors > 1) ? 0.5 : 0.0;
+    Ptr<ListPositionAllocator> pos = CreateObject<ListPositionAllocator>();
+    for (const Vector& v : sites)
+    {
+      pos->Add(Vector(v.x + offset * std::cos(orient * M_PI / 180.0),
+                      v.y + offset * std::sin(orient * M_PI / 180.0), v.z));
+    }
+    mobility.SetPositionAllocator(pos);
+    mobility.Install(sectorNodes[s]);
+  }
+
+  // UEs uniformly over the grid's bounding box (+ half an ISD margin).
+  double minX = sites[0].x, maxX = sites[0].x, minY = sites[0].y, maxY = sites[0].y;
+  for (const Vector& v : sites)
+  {
+    minX = std::min(minX, v.x); maxX = std::max(maxX, v.x);
+    minY = std::min(minY, v.y); maxY = std::max(maxY, v.y);
+  }
+  const double margin = cfg.isd / 2.0;
+  Ptr<RandomBoxPositionAllocator> uePos = CreateObject<RandomBoxPositionAllocator>();
+  uePos->SetX(CreateObjectWithAttributes<UniformRandomVariable>(
+      "Min", DoubleValue(minX - margin), "Max", DoubleValue(maxX + margin)));
+  uePos->SetY(CreateObjectWithAttributes<UniformRandomVariable>(
+      "Min", DoubleValue(minY - margin), "Max", DoubleValue(maxY + margin)));
+  uePos->SetZ(CreateObjectWithAttributes<ConstantRandomVariable>("Constant", DoubleValue(1.5)));
+  mobility.SetPositionAllocator(uePos);
+  mobility.Install(ueNodes);
+
+  // ---------------- LTE devices (bulk) ----------------
+  // SRS periodicity sized for the busiest cell; every eNB RRC reads it when
+  // it is installed below.
+  Config::SetDefault("ns3::LteEnbRrc::SrsPeriodicity",
+                     UintegerValue(SrsPeriodicityFor(MaxUesPerCell(sectorNodes, ueNodes))));
+  NetDeviceContainer enbDevs;
+  std::map<uint32_t, std::pair<uint32_t, uint32_t>> cellSite; // cellId → (site, sector)
+  for (uint32_t s = 0; s < cfg.sectors; ++s)
+  {
+    if (cfg.sectors > 1)
+    {
+      lte->SetEnbAntennaModelAttribute("Orientation", DoubleValue(360.0 * s / cfg.sectors));
+    }
+    NetDeviceContainer devs = lte->InstallEnbDevice(sectorNodes[s]);
+    for (uint32_t i = 0; i < devs.GetN(); ++i)
+    {
+      const uint32_t cellId = DynamicCast<LteEnbNetDevice>(devs.Get(i))->GetCellId();
+      cellSite[cellId] = {i, s};
+    }
+    enbDevs.Add(devs);
+  }
+  if (cfg.fastAttach)
+  {
+    ConfigureFastAttachEnbs(enbDevs);
+  }
+  NetDeviceContainer ueDevs = lte->InstallUeDevice(ueNodes);
+
+  Ipv4InterfaceContainer ueIfaces = epc->AssignUeIpv4Address(ueDevs);
+  lte->AttachToClosestEnb(ueDevs, enbDevs);
+
+  // ---------------- Core: PGW <-> remote host ----------------
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue("100Gbps"));
+  p2p.SetChannelAttribute("Delay",    StringValue("5ms"));
+  NetDeviceContainer internetDevs = p2p.Install(pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIfs = ipv4h.Assign(internetDevs);
+  const Ipv4Address remoteAddr = internetIfs.GetAddress(1);
+
+  Ipv4StaticRoutingHelper srt;
+  srt.GetStaticRouting(remoteHost->GetObject<Ipv4>())
+      ->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"),
+                          internetIfs.GetAddress(0), 1);
+  for (uint32_t i = 0; i < ueNodes.GetN(); ++i)
+  {
+    srt.GetStaticRouting(ueNodes.Get(i)->GetObject<Ipv4>())
+        ->SetDefaultRoute(epc->GetUeDefaultGatewayAddress(), 1);
+  }
+
+  // ---------------- Applications: DL for every UE, UL for a fraction ----------------
+  const uint16_t dlPort = 10000;
+  const uint16_t ulPortBase = 20000;
+
+  PacketSinkHelper dlSinkH("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), dlPort));
+  ApplicationContainer dlSinks = dlSinkH.Install(ueNodes);
+  dlSinks.Start(Seconds(sinkStart));
+  dlSinks.Stop(Seconds(simStop));
+
+  std::vector<Ptr<PacketSink>> ulSinkOf(cfg.ues);
+  ApplicationContainer sources;
+  for (uint32_t i = 0; i < cfg.ues; ++i)
+  {
+    // Stagger starts by 1 ms per UE (mod 100) so flows do not start in lock-step.
+    const double start = appStart + (i % 100) * 1e-3;
+
+    OnOffHelper dl("ns3::UdpSocketFactory", InetSocketAddress(ueIfaces.GetAddress(i), dlPort));
+    dl.SetConstantRate(DataRate(cfg.dlRate), cfg.pktSize);
+    ApplicationContainer a = dl.Install(remoteHost);
+    a.Start(Seconds(start));
+    a.Stop(Seconds(appStop));
+    sources.Add(a);
+
+    // Spread UL UEs evenly: UE i has UL when floor((i+1)f) > floor(i f).
+    const bool hasUl = std::floor((i + 1) * cfg.ulFraction) > std::floor(i * cfg.ulFraction);
+    if (hasUl)
+    {
+      const uint16_t port = static_cast<uint16_t>(ulPortBase + i);
+      PacketSinkHelper ulSinkH("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+      ApplicationContainer s = ulSinkH.Install(remoteHost);
+      s.Start(Seconds(sinkStart));
+      s.Stop(Seconds(simStop));
+      ulSinkOf[i] = DynamicCast<PacketSink>(s.Get(0));
+
+      OnOffHelper ul("ns3::UdpSocketFactory", InetSocketAddress(remoteAddr, port));
+      ul.SetConstantRate(DataRate(cfg.ulRate), cfg.pktSize);
+      ApplicationContainer u = ul.Install(ueNodes.Get(i));
+      u.Start(Seconds(start));
+      u.Stop(Seconds(appStop));
+      sources.Add(u);
+    }
+  }
+
+  // ---------------- PDCP/RLC statistics ----------------
+  if (cfg.traces == "text" || cfg.traces == "both")
+  {
+    lte->EnablePdcpTraces();
+    lte->EnableRlcTraces();
+  }
+  const bool binaryTraces = (cfg.traces == "binary" || cfg.traces == "both");
+  BearerStatsCollector bearerStats;
+  if (binaryTraces)
+  {
+    bearerStats.SetEpoch(Seconds(cfg.statsEpoch));
+    bearerStats.Start(Seconds(appStart));
+  }
+
+  if (tabulate)
+  {
+    Ptr<LteEnbNetDevice> enb0 = DynamicCast<LteEnbNetDevice>(enbDevs.Get(0));
+    Ptr<TabulatedAntennaModel> ant = DynamicCast<TabulatedAntennaModel>(
+        enb0->GetPhy()->GetDownlinkSpectrumPhy()->GetAntenna());
+    const AntennaGainTable& table = ant->GetTable();
+    std::cout << "[antenna] " << antTypeId << " tabulated: step=" << table.GetStepDeg()
+              << " deg, " << table.GetEntries() << " bins, max error "
+              << table.GetMaxErrorDb() << " dB\n";
+  }
+
+  AttachTracker attach;
+  if (cfg.fastAttach)
+  {
+    attach.Start();
+  }
+
+  // ---------------- Run ----------------
+  const double t1 = GetWallClockSeconds();
+  res.buildWall = t1 - t0;
+  Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
+  Simulator::Run();
+  res.runWall = GetWallClockSeconds() - t1;
+  res.events = Simulator::GetEventCount();
+  if (cfg.fastAttach)
+  {
+    attach.Report(std::cout, cfg.ues, Seconds(appStart));
+  }
+
+  // ---------------- Per-UE / per-cell statistics ----------------
+  res.cells = enbDevs.GetN();
+  for (const auto& kv : cellSite)
+  {
+    res.perCell[kv.first] = CellStats{kv.second.first, kv.second.second, 0, 0, 0};
+  }
+  res.perUe.reserve(cfg.ues);
+  for (uint32_t i = 0; i < cfg.ues; ++i)
+  {
+    Ptr<LteUeNetDevice> ueDev = DynamicCast<LteUeNetDevice>(ueDevs.Get(i));
+    const uint32_t cellId = ueDev->GetRrc()->GetCellId();
+    UeStats u{};
+    u.cellId = cellId;
+    u.pos = ueNodes.Get(i)->GetObject<MobilityModel>()->GetPosition();
+    u.dlBytes = DynamicCast<PacketSink>(dlSinks.Get(i))->GetTotalRx();
+    u.hasUl = ulSinkOf[i] ? true : false;
+    u.ulBytes = u.hasUl ? ulSinkOf[i]->GetTotalRx() : 0;
+    res.perUe.push_back(u);
+
+    auto it = res.perCell.find(cellId);
+    if (it != res.perCell.end())
+    {
+      ++res.attached;
+      it->second.ues++;
+      it->second.dlBytes += u.dlBytes;
+      it->second.ulBytes += u.ulBytes;
+    }
+  }
+
+  if (cfg.schedProbe)
+  {
+    CollectSchedulerProbes(enbDevs, res.schedDl, res.schedUl);
+  }
+  if (binaryTraces)
+  {
+    bearerStats.Finish();
+    bearerStats.Report(std::cout);
+    if (bearerStats.Write(cfg.statsFile))
+    {
+      std::cout << "Bearer stats written: " << cfg.statsFile << "\n";
+    }
+    else
+    {
+      std::cerr << "ERROR: cannot write " << cfg.statsFile << "\n";
+    }
+  }
+
+  Simulator::Destroy();
+  // EPC address pools are process-global; reset them for the next case.
+  Ipv4AddressGenerator::Reset();
+  res.peakRssKb = GetPeakRssKb();
+  return res;
+}
+
+// ---------- main: parse CLI, run one or more UE counts ----------
+
+int main(int argc, char* argv[])
+{
+  ScenarioConfig cfg;
+  std::string uesCsv     = "105";
+  std::string cellCsv    = "";
+  std::string ueCsv      = "";
+  std::string scalingCsv = "";
+  std::string schedulers = "";
+  std::string schedCsv   = "";
+  std::string statsFile  = "LteBearerStats.labcol";
+  bool usePool           = false;
+
+  CommandLine cmd;
+  cmd.AddValue("sites",      "Number of sites on the hex grid.",                         cfg.sites);
+  cmd.AddValue("gridWidth",  "Sites per hex-grid row (0 = ceil(sqrt(sites))).",          cfg.gridWidth);
+  cmd.AddValue("isd",        "Inter-site distance in meters.",                           cfg.isd);
+  cmd.AddValue("sectors",    "Cells per site: 1 or 3.",                                  cfg.sectors);
+  cmd.AddValue("antenna",    "eNB antenna: cosine | parabolic | isotropic.",             cfg.antenna);
+  cmd.AddValue("ues",        "UE count, or comma list for a scaling sweep.",             uesCsv);
+  cmd.AddValue("ulFraction", "Fraction of UEs that also send uplink traffic.",           cfg.ulFraction);
+  cmd.AddValue("dlRate",     "Per-UE downlink offered load (DataRate string).",          cfg.dlRate);
+  cmd.AddValue("ulRate",     "Per-UE uplink offered load (DataRate string).",            cfg.ulRate);
+  cmd.AddValue("pktSize",    "UDP payload bytes for all flows.",                         cfg.pktSize);
+  cmd.AddValue("simTime",    "Seconds of traffic (apps run [1, 1+simTime]).",            cfg.simTime);
+  cmd.AddValue("scheduler",  "MAC scheduler: pf | rr | tdmt | tta | pss | cqa | ... or TypeId.", cfg.scheduler);
+  cmd.AddValue("schedProbe", "Time every scheduler trigger (per-TTI cost report).",      cfg.schedProbe);
+  cmd.AddValue("schedulers", "Benchmark: comma list of schedulers x every --ues entry.", schedulers);
+  cmd.AddValue("schedCsv",   "If non-empty, write one fairness/cost row per case here.", schedCsv);
+  cmd.AddValue("traces",     "PDCP/RLC stats: text | binary | both | none.",             cfg.traces);
+  cmd.AddValue("statsFile",  "Output of --traces=binary (per-case suffix if several).",  statsFile);
+  cmd.AddValue("statsEpoch", "Epoch of the binary stats in seconds (0 = whole run).",    cfg.statsEpoch);
+  cmd.AddValue("seed",       "RNG run number.",                                          cfg.seed);
+  cmd.AddValue("cellCsv",    "If non-empty, write per-cell rows here.",                  cellCsv);
+  cmd.AddValue("ueCsv",      "If non-empty, write per-UE rows here.",                    ueCsv);
+  cmd.AddValue("scalingCsv", "If non-empty, write one scaling row per UE count here.",   scalingCsv);
+  cmd.AddValue("antennaTable", "Tabulate the eNB pattern on this grid in deg (0 = analytic).", cfg.antennaTable);
+  cmd.AddValue("antennaMaxError", "Error bound of --antennaTable in dB.",                cfg.antennaMaxError);
+  cmd.AddValue("fastAttach", "Short attach phase; traffic starts at --attachTime.",      cfg.fastAttach);
+  cmd.AddValue("attachTime", "Traffic start with --fastAttach (s).",                     cfg.attachTime);
+  cmd.AddValue("pool",       "Serve packets/events from the size-class pool.",           usePool);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
+
+  const std::vector<uint32_t> ueCounts = ParseUintList(uesCsv);
+  std::vector<std::string> schedList;
+  {
+    std::stringstream ss(schedulers);
+    std::string tok;
+    while (std::getline(ss, tok, ','))
+    {
+      if (!tok.empty())
+      {
+        schedList.push_back(tok);
+      }
+    }
+  }
+  if (schedList.empty())
+  {
+    schedList.push_back(cfg.scheduler);
+  }
+  else
+  {
+    cfg.schedProbe = true; // the benchmark is about scheduler cost
+  }
+  if (ueCounts.empty() || cfg.sites == 0 || (cfg.sectors != 1 && cfg.sectors != 3))
+  {
+    std::cerr << "ERROR: need --ues >= 1 entry, --sites >= 1 and --sectors 1 or 3.\n";
+    return 1;
+  }
+  if (cfg.traces != "text" && cfg.traces != "binary" && cfg.traces != "both" &&
+      cfg.traces != "none")
+  {
+    std::cerr << "ERROR: --traces must be text, binary, both or none.\n";
+    return 1;
+  }
+  if (cfg.fastAttach && cfg.attachTime <= 0.0)
+  {
+    std::cerr << "ERROR: --attachTime must be > 0.\n";
+    return 1;
+  }
+  if (cfg.sectors == 3 && ResolveAntennaTypeId(cfg.antenna) == "ns3::IsotropicAntennaModel")
+  {
+    std::cerr << "ERROR: --sectors=3 needs a directional antenna (cosine or parabolic).\n";
+    return 1;
+  }
+
+  std::ofstream cellOfs, ueOfs, scaleOfs;
+  if (!cellCsv.empty())
+  {
+    cellOfs.open(cellCsv, std::ios::out | std::ios::trunc);
+    cellOfs << "scheduler,ues,cell,site,sector,cell_ues,dl_Mbps,ul_Mbps\n";
+  }
+  if (!ueCsv.empty())
+  {
+    ueOfs.open(ueCsv, std::ios::out | std::ios::trunc);
+    ueOfs << "scheduler,ues,ue,cell,x,y,dl_Mbps,ul_Mbps\n";
+  }
+  if (!scalingCsv.empty())
+  {
+    scaleOfs.open(scalingCsv, std::ios::out | std::ios::trunc);
+    scaleOfs << "scheduler,sites,sectors,cells,ues,attached,sim_s,build_s,run_s,events,events_per_s,"
+                "peak_rss_kb,dl_Mbps,ul_Mbps\n";
+  }
+  std::ofstream schedOfs;
+  if (!schedCsv.empty())
+  {
+    schedOfs.open(schedCsv, std::ios::out | std::ios::trunc);
+    schedOfs << "scheduler,ues,cells,dl_Mbps,ul_Mbps,jain_dl,dl_p5_Mbps,run_s,"
+                "dl_ttis,dl_ues_considered,dl_ues_scheduled,dl_rbgs,dl_cost_mean_us,"
+                "dl_cost_p99_us,dl_cost_max_us,ul_ttis,ul_ues_considered,ul_ues_scheduled,"
+                "ul_rbs,ul_cost_mean_us,ul_cost_p99_us,ul_cost_max_us,sched_share\n";
+  }
+
+  // Cases: every scheduler x every UE count.
+  std::vector<std::pair<std::string, uint32_t>> cases;
+  for (const std::string& sched : schedList)
+  {
+    for (uint32_t n : ueCounts)
+    {
+      cases.emplace_back(sched, n);
+    }
+  }
+
+  for (const auto& c : cases)
+  {
+    const std::string& sched = c.first;
+    const uint32_t n = c.second;
+    cfg.scheduler = sched;
+    cfg.ues = n;
+    cfg.statsFile = statsFile;
+    if (cases.size() > 1)
+    {
+      // LteBearerStats.labcol → LteBearerStats-pf-105.labcol
+      const size_t dot = statsFile.rfind('.');
+      const std::string tag = "-" + sched + "-" + std::to_string(n);
+      cfg.statsFile = (dot == std::string::npos) ? statsFile + tag
+                                                 : statsFile.substr(0, dot) + tag + statsFile.substr(dot);
+    }
+    Banner("Multi-cell LTE: sites=" + std::to_string(cfg.sites) +
+           " sectors=" + std::to_string(cfg.sectors) + " ues=" + std::to_string(n) +
+           " scheduler=" + sched);
+
+    const ScenarioResult r = RunScenario(cfg);
+
+    uint64_t dl = 0, ul = 0;
+    for (const UeStats& u : r.perUe)
+    {
+      dl += u.dlBytes;
+      ul += u.ulBytes;
+    }
+    const double dlMbps = dl * 8.0 / r.window / 1e6;
+    const double ulMbps = ul * 8.0 / r.window / 1e6;
+    const double evRate = r.runWall > 0 ? r.events / r.runWall : 0.0;
+
+    // Radio fairness over the per-UE downlink goodput.
+    std::vector<double> ueDl;
+    ueDl.reserve(r.perUe.size());
+    for (const UeStats& u : r.perUe)
+    {
+      ueDl.push_back(u.dlBytes * 8.0 / r.window / 1e6);
+    }
+    const double jain = JainIndex(ueDl);
+    std::sort(ueDl.begin(), ueDl.end());
+    const double dlP5 = ueDl.empty() ? 0.0 : ueDl[static_cast<size_t>(0.05 * (ueDl.size() - 1))];
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "cells=" << r.cells << "  ues=" << n << " (attached " << r.attached << ")"
+              << "  DL=" << dlMbps << " Mb/s  UL=" << ulMbps << " Mb/s\n"
+              << "build=" << r.buildWall << " s  run=" << r.runWall << " s"
+              << "  events=" << r.events << " (" << std::setprecision(0) << evRate << "/s)"
+              << "  peakRss=" << r.peakRssKb / 1024 << " MiB\n"
+              << std::setprecision(3) << "Jain(DL)=" << jain << "  5th pct UE DL=" << dlP5
+              << " Mb/s\n";
+    const double schedShare =
+        r.runWall > 0 ? (r.schedDl.TotalCostSeconds() + r.schedUl.TotalCostSeconds()) / r.runWall
+                      : 0.0;
+    if (cfg.schedProbe)
+    {
+      r.schedDl.Report(std::cout, "DL");
+      r.schedUl.Report(std::cout, "UL");
+      std::cout << std::setprecision(1) << "scheduler share of run wall time: "
+                << 100.0 * schedShare << " %\n";
+    }
+
+    if (cases.size() == 1)
+    {
+      std::cout << std::setprecision(3) << "\ncell  site sector  ues   DL Mb/s   UL Mb/s\n";
+      for (const auto& kv : r.perCell)
+      {
+        const CellStats& c = kv.second;
+        std::cout << std::setw(4) << kv.first << std::setw(6) << c.site << std::setw(7) << c.sector
+                  << std::setw(5) << c.ues
+                  << std::setw(10) << c.dlBytes * 8.0 / r.window / 1e6
+                  << std::setw(10) << c.ulBytes * 8.0 / r.window / 1e6 << "\n";
+      }
+    }
+
+    if (cellOfs.is_open())
+    {
+      for (const auto& kv : r.perCell)
+      {
+        const CellStats& c = kv.second;
+        cellOfs << sched << "," << n << "," << kv.first << "," << c.site << "," << c.sector << "," << c.ues
+                << "," << c.dlBytes * 8.0 / r.window / 1e6
+                << "," << c.ulBytes * 8.0 / r.window / 1e6 << "\n";
+      }
+    }
+    if (ueOfs.is_open())
+    {
+      for (uint32_t i = 0; i < r.perUe.size(); ++i)
+      {
+        const UeStats& u = r.perUe[i];
+        ueOfs << sched << "," << n << "," << i << "," << u.cellId << "," << u.pos.x << "," << u.pos.y
+              << "," << u.dlBytes * 8.0 / r.window / 1e6
+              << "," << u.ulBytes * 8.0 / r.window / 1e6 << "\n";
+      }
+    }
+    if (scaleOfs.is_open())
+    {
+      scaleOfs << sched << "," << cfg.sites << "," << cfg.sectors << "," << r.cells << "," << n << ","
+               << r.attached << "," << r.window << "," << r.buildWall << "," << r.runWall << ","
+               << r.events << "," << evRate << "," << r.peakRssKb << ","
+               << dlMbps << "," << ulMbps << "\n";
+      scaleOfs.flush();
+    }
+    if (schedOfs.is_open())
+    {
+      const SchedulerProbeStats& d = r.schedDl;
+      const SchedulerProbeStats& u = r.schedUl;
+      const double dBusy = d.busyTtis ? double(d.busyTtis) : 1.0;
+      const double uBusy = u.busyTtis ? double(u.busyTtis) : 1.0;
+      schedOfs << sched << "," << n << "," << r.cells << "," << dlMbps << "," << ulMbps << ","
+               << jain << "," << dlP5 << "," << r.runWall << ","
+               << d.ttis << "," << d.uesConsidered / dBusy << "," << d.uesScheduled / dBusy << ","
+               << d.resources / dBusy << "," << d.costNs.GetMean() / 1e3 << ","
+               << d.costNs.Quantile(0.99) / 1e3 << "," << d.costNs.GetMax() / 1e3 << ","
+               << u.ttis << "," << u.uesConsidered / uBusy << "," << u.uesScheduled / uBusy << ","
+               << u.resources / uBusy << "," << u.costNs.GetMean() / 1e3 << ","
+               << u.costNs.Quantile(0.99) / 1e3 << "," << u.costNs.GetMax() / 1e3 << ","
+               << schedShare << "\n";
+      schedOfs.flush();
+    }
+  }
+
+  if (cellOfs.is_open())  { cellOfs.close();  std::cout << "CSV written: " << cellCsv << "\n"; }
+  if (ueOfs.is_open())    { ueOfs.close();    std::cout << "CSV written: " << ueCsv << "\n"; }
+  if (scaleOfs.is_open()) { scaleOfs.close(); std::cout << "CSV written: " << scalingCsv << "\n"; }
+  if (schedOfs.is_open()) { schedOfs.close(); std::cout << "CSV written: " << schedCsv << "\n"; }
+  return 0;
+}
@@ -0,0 +1,597 @@
+/*
+ * Lab 04 — Multi-cluster LTE/EPC, sharded over independent processes
+ * -------------------------------------------------------------------
+ * LIMITATION, read first: this is a DIFFERENT scenario from the coupled
+ * multi-cell network, not a faster way to run it. Clusters do NOT interfere
+ * with each other: each has its own spectrum channel, so a UE near a cluster
+ * edge sees no interference from the neighbouring cluster's cells, and its
+ * SINR and throughput are optimistic. Within a cluster, interference is
+ * modelled as usual.
+ *   - Results are NOT equivalent to Lab4_Cpp_LTE_MultiCell (or any single
+ *     network) with the same total number of sites and UEs, and no tolerance
+ *     between the two is claimed. Do not report sharded throughput as
+ *     multi-cell throughput.
+ *   - The equivalence that IS checked is across shard counts: R processes
+ *     give the same per-UE rows as R = 1 of this program (see below). The
+ *     speed-up run_lte_sharded.py reports is against that R = 1 run, not
+ *     against Lab4_Cpp_LTE_MultiCell.
+ * Use Lab4_Cpp_LTE_MultiCell whenever interference between all cells matters.
+ *
+ * What this program builds:
+ *   C clusters. Each cluster is a small hex grid of sites (1 or 3 sectors) with
+ *   its own UEs, its own LTE radio channel and its own EPC segment:
+ *
+ *     cluster k:  UEs <--LTE--> eNBs <--S1-U p2p--> SGW/PGW <--100 Gbps p2p--> server k
+ *
+ *   Every UE receives a downlink UDP flow; a fraction also sends uplink, exactly
+ *   as in Lab4_Cpp_LTE_MultiCell. The clusters share no channel and no node,
+ *   so they model separate regions of one operator.
+ *
+ * Why this exists:
+ *   Multi-eNB runs are single-threaded. Here a cluster plus its EPC segment is
+ *   the unit of work. R processes (shards) each take the clusters k with
+ *   k % R == rank and build and simulate only those. This is plain sharding,
+ *   not a distributed simulation: no MPI library is linked, ns-3's distributed
+ *   simulator (--enable-mpi) is not used, and the processes never exchange a
+ *   message. `mpirun -np R` is merely a convenient launcher. ns-3's MPI
+ *   partitions could not split this scenario anyway: they meet only at
+ *   point-to-point links, the EPC helper creates SGW/PGW/MME with system id 0,
+ *   and one LTE spectrum channel cannot span processes.
+ *
+ *   Per-UE results are meant not to depend on R. Every cluster draws from its
+ *   own fixed block of RNG streams: UE drop, LTE devices, the IP stacks of
+ *   every node the cluster creates (UEs, eNBs, SGW, PGW, MME, server) and the
+ *   apps. IMSIs, cell ids and addresses are numbered per cluster.
+ *   run_lte_sharded.py runs R = 1 and each requested R, merges the --ueCsv
+ *   shards and fails if any per-UE row differs, so every scaling run checks
+ *   the claim.
+ *
+ * Ranks:
+ *   Rank and size come from the launcher's environment (Open MPI, MPICH/Hydra,
+ *   MVAPICH, Slurm); --rank/--ranks override it, so plain background
+ *   processes work too.
+ *
+ * CLI examples:
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_Sharded --clusters=8 --uesPerCluster=40 --ueCsv=ues.csv"
+ *   ./ns3 run "scratch/Lab4_Cpp_LTE_Sharded --clusters=8 --uesPerCluster=40 --ueCsv=ues.csv" \
+ *       --command-template="mpirun -np 4 %s"
+ *   python3 Lab-04-LTE/code/run_lte_sharded.py --ranks=1,2,4 -- --clusters=8 --uesPerCluster=40
+ *
+ * Key CLI flags:
+ *   --clusters      : number of clusters (default 8)
+ *   --sites         : sites per cluster (default 3)
+ *   --sectors       : 1 or 3 cells per site (default 3)
+ *   --antenna       : cosine | parabolic | isotropic (default parabolic)
+ *   --isd           : inter-site distance in meters (default 500)
+ *   --uesPerCluster : UEs dropped uniformly over each cluster (default 30)
+ *   --ulFraction    : fraction of UEs that also send uplink (default 0.3)
+ *   --dlRate / --ulRate : per-UE offered load (default 2Mbps / 512kbps)
+ *   --simTime       : seconds of traffic (apps run [1, 1+simTime]) (default 3)
+ *   --seed          : RNG run number
+ *   --rank / --ranks: partition by hand (default: from the MPI environment, else 0/1)
+ *   --ueCsv         : per-UE rows cluster,imsi,cell,x,y,dl_Mbps,ul_Mbps; with R > 1
+ *                     every rank writes <name>.rank<r>.<ext>
+ *   --timingCsv     : one row per rank: wall times, events, peak RSS (same naming)
+ *   --pool          : serve packets/events from the size-class pool (default 0)
+ *
+ * Notes:
+ *   - Every cluster reuses the EPC's fixed address plan (7.0.0.0/8 for UEs,
+ *     10/13/14.0.0.0 inside the core). ns-3 treats reused addresses as a fatal
+ *     collision, so the generator is put in its collision-tolerant mode. The
+ *     plans never meet because the clusters share no node.
+ *   - Inter-cluster interference is not modeled, so results differ from the
+ *     coupled multi-cell run (see the top of this file).
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-pool-allocator.h"   // size-class pool for packets/events (--pool)
+#include "lab-proc-stats.h"       // wall clock + peak RSS per rank
+#include "lab-startup-profiler.h" // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+LAB_POOL_INSTALL_OPERATORS()
+
+// ---------- Small helpers ----------
+
+// Same mapping as Lab4_Cpp_LTE.cc.
+static std::string
+ResolveAntennaTypeId(const std::string& user)
+{
+  std::string s = user;
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return std::tolower(c); });
+  if (s == "isotropic") return "ns3::IsotropicAntennaModel";
+  if (s == "cosine")    return "ns3::CosineAntennaModel";
+  if (s == "parabolic") return "ns3::ParabolicAntennaModel";
+  return "ns3::IsotropicAntennaModel";
+}
+
+static void
+Banner(const std::string& title)
+{
+  std::cout << "\n==== " << title << " ====\n";
+}
+
+// Same layout as Lab4_Cpp_LTE_MultiCell: row-major, odd rows shifted by isd/2.
+static std::vector<Vector>
+HexGridSites(uint32_t nSites, double isd, double x0, double height)
+{
+  const uint32_t gridWidth = static_cast<uint32_t>(std::ceil(std::sqrt(double(nSites))));
+  const double rowStep = isd * std::sqrt(3.0) / 2.0;
+  std::vector<Vector> sites;
+  sites.reserve(nSites);
+  for (uint32_t i = 0; i < nSites; ++i)
+  {
+    const uint32_t row = i / gridWidth;
+    const uint32_t col = i % gridWidth;
+    sites.emplace_back(x0 + col * isd + ((row % 2) ? isd / 2.0 : 0.0), row * rowStep, height);
+  }
+  return sites;
+}
+
+// Smallest LteEnbRrc::SrsPeriodicity that accommodates 'ues' UEs in one cell.
+static uint32_t
+SrsPeriodicityFor(uint32_t ues)
+{
+  for (uint32_t p : {2u, 5u, 10u, 20u, 40u, 80u, 160u, 320u})
+  {
+    if (ues < p)
+    {
+      return p;
+    }
+  }
+  return 320;
+}
+
+// Most UEs AttachToClosestEnb will put in one cell: every UE goes to the
+// nearest eNB, ties to the first in install order (sector by sector, the
+// order 'sectorNodes' is installed in). Needs the mobility models in place.
+static uint32_t
+MaxUesPerCell(const std::vector<NodeContainer>& sectorNodes, const NodeContainer& ueNodes)
+{
+  std::vector<Ptr<MobilityModel>> enbs;
+  for (const NodeContainer& nodes : sectorNodes)
+  {
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+      enbs.push_back(nodes.Get(i)->GetObject<MobilityModel>());
+    }
+  }
+  std::vector<uint32_t> perCell(enbs.size(), 0);
+  for (uint32_t u = 0; u < ueNodes.GetN(); ++u)
+  {
+    Ptr<MobilityModel> ue = ueNodes.Get(u)->GetObject<MobilityModel>();
+    size_t closest = 0;
+    double minDistance = std::numeric_limits<double>::infinity();
+    for (size_t e = 0; e < enbs.size(); ++e)
+    {
+      const double d = enbs[e]->GetDistanceFrom(ue);
+      if (d < minDistance)
+      {
+        minDistance = d;
+        closest = e;
+      }
+    }
+    ++perCell[closest];
+  }
+  return perCell.empty() ? 0 : *std::max_element(perCell.begin(), perCell.end());
+}
+
+// Rank and size as exported by the common MPI launchers; false if none is set.
+static bool
+RankFromEnvironment(uint32_t& rank, uint32_t& ranks)
+{
+  static const char* vars[][2] = {{"OMPI_COMM_WORLD_RANK", "OMPI_COMM_WORLD_SIZE"},
+                                  {"PMI_RANK", "PMI_SIZE"},
+                                  {"MV2_COMM_WORLD_RANK", "MV2_COMM_WORLD_SIZE"},
+                                  {"SLURM_PROCID", "SLURM_NTASKS"}};
+  for (const auto& v : vars)
+  {
+    const char* r = std::getenv(v[0]);
+    const char* n = std::getenv(v[1]);
+    if (r && n)
+    {
+      rank = static_cast<uint32_t>(std::strtoul(r, nullptr, 10));
+      ranks = static_cast<uint32_t>(std::strtoul(n, nullptr, 10));
+      return true;
+    }
+  }
+  return false;
+}
+
+// ues.csv → ues.rank2.csv when several ranks write their own share.
+static std::string
+RankFileName(const std::string& path, uint32_t rank, uint32_t ranks)
+{
+  if (ranks <= 1)
+  {
+    return path;
+  }
+  const std::string tag = ".rank" + std::to_string(rank);
+  const size_t slash = path.rfind('/');
+  const size_t dot = path.rfind('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+  {
+    return path + tag;
+  }
+  return path.substr(0, dot) + tag + path.substr(dot);
+}
+
+// ---------- Scenario description ----------
+
+struct ClusterConfig
+{
+  uint32_t    sites      = 3;
+  uint32_t    sectors    = 3;
+  std::string antenna    = "parabolic";
+  double      isd        = 500.0;
+  double      spacing    = 10000.0;  // x offset between cluster origins (m)
+  uint32_t    ues        = 30;       // per cluster
+  double      ulFraction = 0.3;
+  std::string dlRate     = "2Mbps";
+  std::string ulRate     = "512kbps";
+  uint32_t    pktSize    = 1024;
+  double      simTime    = 3.0;
+};
+
+// RNG streams reserved for one cluster; far more than one cluster consumes.
+static const int64_t kStreamsPerCluster = 100000;
+
+struct Cluster
+{
+  uint32_t id;
+  Ptr<LteHelper> lte;
+  Ptr<PointToPointEpcHelper> epc;
+  NodeContainer ueNodes;
+  NetDeviceContainer enbDevs;
+  NetDeviceContainer ueDevs;
+  ApplicationContainer dlSinks;
+  std::vector<Ptr<PacketSink>> ulSinkOf;
+};
+
+// ---------- One cluster: radio, EPC segment, server and traffic ----------
+
+static void
+BuildCluster(const ClusterConfig& cfg, Cluster& c, double appStart, double appStop, double simStop)
+{
+  const int64_t streamBase = 1000 + int64_t(c.id) * kStreamsPerCluster;
+  const double sinkStart = 0.5;
+  // Every node from here on belongs to this cluster, including the SGW, PGW
+  // and MME the EPC helper creates and the eNB stacks it installs.
+  const uint32_t firstNode = NodeList::GetNNodes();
+
+  c.lte = CreateObject<LteHelper>();
+  c.epc = CreateObject<PointToPointEpcHelper>();
+  c.lte->SetEpcHelper(c.epc);
+  c.lte->SetSchedulerType("ns3::PfFfMacScheduler");
+  c.lte->SetEnbDeviceAttribute("DlEarfcn",    UintegerValue(100));
+  c.lte->SetEnbDeviceAttribute("UlEarfcn",    UintegerValue(18100));
+  c.lte->SetEnbDeviceAttribute("DlBandwidth", UintegerValue(50));
+  c.lte->SetEnbDeviceAttribute("UlBandwidth", UintegerValue(50));
+
+  const std::string antTypeId = ResolveAntennaTypeId(cfg.antenna);
+  c.lte->SetEnbAntennaModelType(antTypeId);
+  if (cfg.sectors == 3)
+  {
+    if (antTypeId == "ns3::ParabolicAntennaModel")
+    {
+      c.lte->SetEnbAntennaModelAttribute("Beamwidth",      DoubleValue(70.0));
+      c.lte->SetEnbAntennaModelAttribute("MaxAttenuation", DoubleValue(20.0));
+    }
+    else if (antTypeId == "ns3::CosineAntennaModel")
+    {
+      c.lte->SetEnbAntennaModelAttribute("HorizontalBeamwidth", DoubleValue(65.0));
+    }
+  }
+
+  // ---------------- Nodes + mobility ----------------
+  const std::vector<Vector> sites = HexGridSites(cfg.sites, cfg.isd, c.id * cfg.spacing, 30.0);
+  std::vector<NodeContainer> sectorNodes(cfg.sectors);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  for (uint32_t s = 0; s < cfg.sectors; ++s)
+  {
+    sectorNodes[s].Create(cfg.sites);
+    const double orient = 360.0 * s / cfg.sectors;
+    const double offset = (cfg.sectors > 1) ? 0.5 : 0.0;
+    Ptr<ListPositionAllocator> pos = CreateObject<ListPositionAllocator>();
+    for (const Vector& v : sites)
+    {
+      pos->Add(Vector(v.x + offset * std::cos(orient * M_PI / 180.0),
+                      v.y + offset * std::sin(orient * M_PI / 180.0), v.z));
+    }
+    mobility.SetPositionAllocator(pos);
+    mobility.Install(sectorNodes[s]);
+  }
+
+  c.ueNodes.Create(cfg.ues);
+  double minX = sites[0].x, maxX = sites[0].x, minY = sites[0].y, maxY = sites[0].y;
+  for (const Vector& v : sites)
+  {
+    minX = std::min(minX, v.x); maxX = std::max(maxX, v.x);
+    minY = std::min(minY, v.y); maxY = std::max(maxY, v.y);
+  }
+  const double margin = cfg.isd / 2.0;
+  Ptr<RandomBoxPositionAllocator> uePos = CreateObject<RandomBoxPositionAllocator>();
+  uePos->SetX(CreateObjectWithAttributes<UniformRandomVariable>(
+      "Min", DoubleValue(minX - margin), "Max", DoubleValue(maxX + margin)));
+  uePos->SetY(CreateObjectWithAttributes<UniformRandomVariable>(
+      "Min", DoubleValue(minY - margin), "Max", DoubleValue(maxY + margin)));
+  uePos->SetZ(CreateObjectWithAttributes<ConstantRandomVariable>("Constant", DoubleValue(1.5)));
+  int64_t stream = streamBase;
+  stream += uePos->AssignStreams(stream);
+  mobility.SetPositionAllocator(uePos);
+  mobility.Install(c.ueNodes);
+
+  NodeContainer serverCont; serverCont.Create(1);
+  Ptr<Node> server = serverCont.Get(0);
+  InternetStackHelper internet;
+  internet.Install(serverCont);
+  internet.Install(c.ueNodes);
+
+  // ---------------- LTE devices ----------------
+  // SRS periodicity sized for this cluster's busiest cell; the eNB RRCs
+  // installed below read it, so each cluster gets its own.
+  Config::SetDefault("ns3::LteEnbRrc::SrsPeriodicity",
+                     UintegerValue(SrsPeriodicityFor(MaxUesPerCell(sectorNodes, c.ueNodes))));
+  for (uint32_t s = 0; s < cfg.sectors; ++s)
+  {
+    if (cfg.sectors > 1)
+    {
+      c.lte->SetEnbAntennaModelAttribute("Orientation", DoubleValue(360.0 * s / cfg.sectors));
+    }
+    c.enbDevs.Add(c.lte->InstallEnbDevice(sectorNodes[s]));
+  }
+  c.ueDevs = c.lte->InstallUeDevice(c.ueNodes);
+  stream += c.lte->AssignStreams(c.enbDevs, stream);
+  stream += c.lte->AssignStreams(c.ueDevs, stream);
+
+  Ipv4InterfaceContainer ueIfaces = c.epc->AssignUeIpv4Address(c.ueDevs);
+  c.lte->AttachToClosestEnb(c.ueDevs, c.enbDevs);
+
+  // ---------------- EPC segment: PGW <-> this cluster's server ----------------
+  Ptr<Node> pgw = c.epc->GetPgwNode();
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue("100Gbps"));
+  p2p.SetChannelAttribute("Delay",    StringValue("5ms"));
+  NetDeviceContainer internetDevs = p2p.Install(pgw, server);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIfs = ipv4h.Assign(internetDevs);
+  const Ipv4Address serverAddr = internetIfs.GetAddress(1);
+
+  Ipv4StaticRoutingHelper srt;
+  srt.GetStaticRouting(server->GetObject<Ipv4>())
+      ->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"),
+                          internetIfs.GetAddress(0), 1);
+  for (uint32_t i = 0; i < c.ueNodes.GetN(); ++i)
+  {
+    srt.GetStaticRouting(c.ueNodes.Get(i)->GetObject<Ipv4>())
+        ->SetDefaultRoute(c.epc->GetUeDefaultGatewayAddress(), 1);
+  }
+  NodeContainer ipNodes(serverCont, c.ueNodes);
+  NodeContainer clusterNodes;
+  for (uint32_t n = firstNode; n < NodeList::GetNNodes(); ++n)
+  {
+    clusterNodes.Add(NodeList::GetNode(n));
+  }
+  stream += internet.AssignStreams(clusterNodes, stream);
+
+  // ---------------- Applications (as in Lab4_Cpp_LTE_MultiCell) ----------------
+  const uint16_t dlPort = 10000;
+  const uint16_t ulPortBase = 20000;
+
+  PacketSinkHelper dlSinkH("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), dlPort));
+  c.dlSinks = dlSinkH.Install(c.ueNodes);
+  c.dlSinks.Start(Seconds(sinkStart));
+  c.dlSinks.Stop(Seconds(simStop));
+
+  c.ulSinkOf.assign(cfg.ues, nullptr);
+  OnOffHelper dl("ns3::UdpSocketFactory", Address());
+  dl.SetConstantRate(DataRate(cfg.dlRate), cfg.pktSize);
+  OnOffHelper ul("ns3::UdpSocketFactory", Address());
+  ul.SetConstantRate(DataRate(cfg.ulRate), cfg.pktSize);
+  for (uint32_t i = 0; i < cfg.ues; ++i)
+  {
+    const double start = appStart + (i % 100) * 1e-3;
+
+    dl.SetAttribute("Remote", AddressValue(InetSocketAddress(ueIfaces.GetAddress(i), dlPort)));
+    ApplicationContainer a = dl.Install(server);
+    a.Start(Seconds(start));
+    a.Stop(Seconds(appStop));
+
+    const bool hasUl = std::floor((i + 1) * cfg.ulFraction) > std::floor(i * cfg.ulFraction);
+    if (hasUl)
+    {
+      const uint16_t port = static_cast<uint16_t>(ulPortBase + i);
+      PacketSinkHelper ulSinkH("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+      ApplicationContainer s = ulSinkH.Install(server);
+      s.Start(Seconds(sinkStart));
+      s.Stop(Seconds(simStop));
+      c.ulSinkOf[i] = DynamicCast<PacketSink>(s.Get(0));
+
+      ul.SetAttribute("Remote", AddressValue(InetSocketAddress(serverAddr, port)));
+      ApplicationContainer u = ul.Install(c.ueNodes.Get(i));
+      u.Start(Seconds(start));
+      u.Stop(Seconds(appStop));
+    }
+  }
+  stream += dl.AssignStreams(ipNodes, stream); // every OnOff app on these nodes
+  NS_ABORT_MSG_IF(stream - streamBase > kStreamsPerCluster,
+                  "cluster " << c.id << " needs more than " << kStreamsPerCluster << " RNG streams");
+}
+
+// ---------- main: parse CLI, build this rank's clusters, run ----------
+
+int main(int argc, char* argv[])
+{
+  ClusterConfig cfg;
+  uint32_t clusters      = 8;
+  uint32_t seed          = 1;
+  uint32_t rank          = 0;
+  uint32_t ranks         = 0;        // 0 → from the MPI environment
+  std::string ueCsv      = "";
+  std::string timingCsv  = "";
+  bool usePool           = false;
+
+  CommandLine cmd;
+  cmd.AddValue("clusters",   "Number of clusters (each with its own EPC segment).",     clusters);
+  cmd.AddValue("sites",      "Sites per cluster.",                                       cfg.sites);
+  cmd.AddValue("sectors",    "Cells per site: 1 or 3.",                                  cfg.sectors);
+  cmd.AddValue("antenna",    "eNB antenna: cosine | parabolic | isotropic.",             cfg.antenna);
+  cmd.AddValue("isd",        "Inter-site distance in meters.",                           cfg.isd);
+  cmd.AddValue("uesPerCluster", "UEs per cluster.",                                      cfg.ues);
+  cmd.AddValue("ulFraction", "Fraction of UEs that also send uplink traffic.",           cfg.ulFraction);
+  cmd.AddValue("dlRate",     "Per-UE downlink offered load (DataRate string).",          cfg.dlRate);
+  cmd.AddValue("ulRate",     "Per-UE uplink offered load (DataRate string).",            cfg.ulRate);
+  cmd.AddValue("pktSize",    "UDP payload bytes for all flows.",                         cfg.pktSize);
+  cmd.AddValue("simTime",    "Seconds of traffic (apps run [1, 1+simTime]).",            cfg.simTime);
+  cmd.AddValue("seed",       "RNG run number.",                                          seed);
+  cmd.AddValue("rank",       "This process's rank (with --ranks).",                      rank);
+  cmd.AddValue("ranks",      "Number of ranks (0 = from the MPI environment).",          ranks);
+  cmd.AddValue("ueCsv",      "If non-empty, write per-UE rows here (per-rank suffix).",  ueCsv);
+  cmd.AddValue("timingCsv",  "If non-empty, write this rank's timing row here.",         timingCsv);
+  cmd.AddValue("pool",       "Serve packets/events from the size-class pool.",           usePool);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  PoolAllocator::SetEnabled(usePool);
+
+  if (ranks == 0 && !RankFromEnvironment(rank, ranks))
+  {
+    rank = 0;
+    ranks = 1;
+  }
+  if (rank >= ranks || clusters == 0 || cfg.sites == 0 || cfg.ues == 0 ||
+      (cfg.sectors != 1 && cfg.sectors != 3))
+  {
+    std::cerr << "ERROR: need rank < ranks, --clusters/--sites/--uesPerCluster >= 1 and "
+                 "--sectors 1 or 3.\n";
+    return 1;
+  }
+  if (cfg.sectors == 3 && ResolveAntennaTypeId(cfg.antenna) == "ns3::IsotropicAntennaModel")
+  {
+    std::cerr << "ERROR: --sectors=3 needs a directional antenna (cosine or parabolic).\n";
+    return 1;
+  }
+
+  std::vector<uint32_t> mine;
+  for (uint32_t k = rank; k < clusters; k += ranks)
+  {
+    mine.push_back(k);
+  }
+  std::ostringstream list;
+  for (size_t i = 0; i < mine.size(); ++i)
+  {
+    list << (i ? "," : "") << mine[i];
+  }
+  Banner("LTE clusters on rank " + std::to_string(rank) + "/" + std::to_string(ranks) +
+         ": {" + list.str() + "} of " + std::to_string(clusters));
+  std::cout << "[note] clusters have separate channels: no inter-cluster interference\n";
+
+  ResetPeakRss();
+  const double t0 = GetWallClockSeconds();
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(seed);
+
+  const double appStart = 1.0;
+  const double appStop  = appStart + cfg.simTime;
+  const double simStop  = appStop + 0.1;
+
+  Config::SetDefault("ns3::LteAmc::AmcModel", EnumValue(LteAmc::PiroEW2010));
+  // Every cluster reuses the EPC address plan; see the notes above.
+  Ipv4AddressGenerator::TestMode();
+
+  std::vector<Cluster> built(mine.size());
+  for (size_t i = 0; i < mine.size(); ++i)
+  {
+    built[i].id = mine[i];
+    BuildCluster(cfg, built[i], appStart, appStop, simStop);
+  }
+
+  const double t1 = GetWallClockSeconds();
+  Simulator::Stop(Seconds(simStop));
+  StartupProfiler::Running();
+  Simulator::Run();
+  const double runWall = GetWallClockSeconds() - t1;
+  const double buildWall = t1 - t0;
+  const uint64_t events = Simulator::GetEventCount();
+
+  // ---------------- Per-UE results ----------------
+  const double window = appStop - appStart;
+  std::ofstream ueOfs;
+  const std::string ueFile = RankFileName(ueCsv, rank, ranks);
+  if (!ueCsv.empty())
+  {
+    ueOfs.open(ueFile, std::ios::out | std::ios::trunc);
+    ueOfs << "cluster,imsi,cell,x,y,dl_Mbps,ul_Mbps\n";
+  }
+  uint32_t cells = 0, ues = 0, attached = 0;
+  uint64_t dl = 0, ul = 0;
+  for (const Cluster& c : built)
+  {
+    cells += c.enbDevs.GetN();
+    for (uint32_t i = 0; i < c.ueDevs.GetN(); ++i)
+    {
+      Ptr<LteUeNetDevice> ueDev = DynamicCast<LteUeNetDevice>(c.ueDevs.Get(i));
+      const uint16_t cellId = ueDev->GetRrc()->GetCellId();
+      const Vector pos = c.ueNodes.Get(i)->GetObject<MobilityModel>()->GetPosition();
+      const uint64_t dlBytes = DynamicCast<PacketSink>(c.dlSinks.Get(i))->GetTotalRx();
+      const uint64_t ulBytes = c.ulSinkOf[i] ? c.ulSinkOf[i]->GetTotalRx() : 0;
+      ++ues;
+      attached += (cellId != 0);
+      dl += dlBytes;
+      ul += ulBytes;
+      if (ueOfs.is_open())
+      {
+        ueOfs << c.id << "," << ueDev->GetImsi() << "," << cellId << "," << pos.x << "," << pos.y
+              << "," << dlBytes * 8.0 / window / 1e6 << "," << ulBytes * 8.0 / window / 1e6 << "\n";
+      }
+    }
+  }
+
+  Simulator::Destroy();
+  const uint64_t peakRssKb = GetPeakRssKb();
+
+  std::cout << std::fixed << std::setprecision(3)
+            << "clusters=" << built.size() << "  cells=" << cells << "  ues=" << ues
+            << " (attached " << attached << ")"
+            << "  DL=" << dl * 8.0 / window / 1e6 << " Mb/s  UL=" << ul * 8.0 / window / 1e6
+            << " Mb/s\n"
+            << "build=" << buildWall << " s  run=" << runWall << " s  events=" << events
+            << "  peakRss=" << peakRssKb / 1024 << " MiB\n";
+
+  if (ueOfs.is_open())
+  {
+    ueOfs.close();
+    std::cout << "CSV written: " << ueFile << "\n";
+  }
+  if (!timingCsv.empty())
+  {
+    const std::string timingFile = RankFileName(timingCsv, rank, ranks);
+    std::ofstream ofs(timingFile, std::ios::out | std::ios::trunc);
+    ofs << "rank,ranks,clusters,cells,ues,sim_s,build_s,run_s,events,peak_rss_kb\n"
+        << rank << "," << ranks << "," << built.size() << "," << cells << "," << ues << ","
+        << window << "," << buildWall << "," << runWall << "," << events << "," << peakRssKb
+        << "\n";
+    std::cout << "CSV written: " << timingFile << "\n";
+  }
+  return 0;
+}
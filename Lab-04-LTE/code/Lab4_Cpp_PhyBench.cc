@@ -0,0 +1,643 @@
+/*
+ * Lab 04 — PHY micro-benchmarks (antenna gain, MIESM error model, PSD arithmetic)
+ * ---------------------------------------------------------------
+ * What this program measures:
+ *   The cost of one AntennaModel::GetGainDb() call for the ns-3 Cosine and
+ *   Parabolic models, and for TabulatedAntennaModel (lab-tabulated-antenna.h)
+ *   tabulating the same pattern, with and without interpolation. All calls go
+ *   through Ptr<AntennaModel>, the way the spectrum channel makes them.
+ *   Also the cost of one transport-block BLER evaluation
+ *   (LteMiErrorModel::GetTbDecodificationStats) with and without MiesmCache
+ *   (lab-lte-miesm.h), and the per-receiver SINR arithmetic on 50-RB power
+ *   spectral densities with SpectrumValue operators and with the fused kernels
+ *   of lab-psd-kernels.h.
+ *
+ *   --bench=antenna : GetGainDb on random directions. Prints ns per call, the
+ *                     speed-up, the largest |table - analytic| seen over the
+ *                     samples, and the table's build time, bins and memory.
+ *   --bench=link    : the multi-cell case. A 7-site, 3-sector hex grid (ISD
+ *                     500 m) and --ues random UEs. For every cell/UE pair the
+ *                     benchmark computes Angles(ue, enb) plus the eNB gain, as
+ *                     MultiModelSpectrumChannel does for every receiver of
+ *                     every transmission. The Angles arithmetic is common to
+ *                     both variants, so this shows the saving per link.
+ *   --bench=miesm   : --tbs transport blocks through MiesmCache in ns3 / exact /
+ *                     fast mode, with a cold cache each run. Two workloads:
+ *                       static    : one UE, flat SINR on all 50 RBs, same
+ *                                   MCS every TTI (Lab4_Cpp_LTE at high load);
+ *                       selective : --states channel states (mean SINR
+ *                                   -5..25 dB, 3 dB per-RB spread, random
+ *                                   RBG allocation, MCS from CQI) revisited at
+ *                                   random, like many UEs in a static
+ *                                   multi-cell run.
+ *                     Prints ns per TB, hit rate and max / mean |ΔBLER|
+ *                     against ns3; exact must show 0. MiesmCache only
+ *                     serves this bench and Lab4_Cpp_LTE --engine=abstract;
+ *                     the full LTE programs decode TBs in LteSpectrumPhy
+ *                     without it, so these timings do not carry over to them.
+ *   --bench=psd     : the --bench=link grid (21 cells, --ues UEs) with the
+ *                     Lab4_Cpp_LTE radio (EARFCN 100, 50 RBs, 30 dBm, NF 9 dB,
+ *                     Friis), reuse 1, every cell on every RB, for --ttis
+ *                     subframes. Per UE and TTI: receive every cell's PSD,
+ *                     sum the interference, compute the serving cell's SINR
+ *                     and accumulate it as the CQI chunk processor does.
+ *                       operators : Copy() + *= gain per PSD, then
+ *                                   s / (all - s + noise) and sum += sinr*dt,
+ *                                   as the ns-3 channel and LteInterference do;
+ *                       fused     : PsdInterference, no allocations.
+ *                     Prints ns per UE-TTI, the speed-up and the largest
+ *                     relative difference of the averaged SINR. Build with
+ *                     the optimized profile to get vector code. This is a
+ *                     replay outside the simulator: the full LTE programs
+ *                     still use ns-3's own SpectrumValue operators, so the
+ *                     speed-up applies to this arithmetic only, not to a
+ *                     MultiCell run.
+ *   --bench=all     : all of them (default).
+ *
+ * CLI examples:
+ *   ./ns3 run "scratch/Lab4_Cpp_PhyBench"
+ *   ./ns3 run "scratch/Lab4_Cpp_PhyBench --antenna=cosine --beamwidth=65 --maxError=0.01"
+ *   ./ns3 run "scratch/Lab4_Cpp_PhyBench --bench=link --ues=500 --csv=phybench.csv"
+ *   ./ns3 run "scratch/Lab4_Cpp_PhyBench --bench=miesm --errorStep=0.1"
+ *   ./ns3 run "scratch/Lab4_Cpp_PhyBench --bench=psd --ues=420 --ttis=200"
+ *
+ * Key CLI flags:
+ *   --antenna   : cosine | parabolic | all (default all)
+ *   --beamwidth : horizontal beamwidth in deg (default 65, the MultiCell sector)
+ *   --step      : initial table grid in deg (default 1)
+ *   --maxError  : table error bound in dB (default 0.05)
+ *   --samples   : directions per antenna benchmark (default 1000000)
+ *   --ues       : UEs for the link and PSD benchmarks (default 210)
+ *   --ttis      : subframes of the PSD benchmark (default 100)
+ *   --tbs       : transport blocks per MIESM workload (default 100000)
+ *   --states    : channel states of the selective workload (default 256)
+ *   --errorStep : SINR quantisation of the fast MIESM mode in dB (default 0.25)
+ *   --repeat    : timed repetitions; the fastest is reported (default 5)
+ *   --csv       : if non-empty, one row per (bench, case, variant). max_err is
+ *                 in dB for the antenna bench, |ΔBLER| for the MIESM bench and
+ *                 the relative SINR difference for the PSD bench.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/antenna-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/lte-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-proc-stats.h"          // wall clock
+#include "lab-tabulated-antenna.h"   // TabulatedAntennaModel
+#include "lab-lte-miesm.h"           // MiesmCache
+#include "lab-lte-link-abstraction.h" // CQI → MCS mapping
+#include "lab-psd-kernels.h"         // PsdInterference
+#include "lab-startup-profiler.h"    // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("Lab4PhyBench");
+
+// ---------- Helpers ----------
+
+static void
+Banner(const std::string& s)
+{
+  std::cout << "\n=== " << s << " ===\n";
+}
+
+struct Variant
+{
+  std::string   name;     // analytic | table | table-nearest
+  ObjectFactory factory;  // one antenna per cell in the link benchmark
+  Ptr<AntennaModel> model; // Orientation 0 instance for the antenna benchmark
+  double buildSec;        // table build time (0 for analytic)
+  size_t bins;
+  size_t bytes;
+};
+
+static std::vector<Variant>
+MakeVariants(const std::string& typeId, double beamwidth, double step, double maxError)
+{
+  std::vector<Variant> v;
+  ObjectFactory analytic(typeId);
+  analytic.Set(typeId == "ns3::CosineAntennaModel" ? "HorizontalBeamwidth" : "Beamwidth",
+               DoubleValue(beamwidth));
+  v.push_back(Variant{"analytic", analytic, analytic.Create<AntennaModel>(), 0.0, 0, 0});
+
+  for (bool interpolate : {true, false})
+  {
+    ObjectFactory f("ns3::TabulatedAntennaModel");
+    f.Set("Pattern",     StringValue(typeId));
+    f.Set("Beamwidth",   DoubleValue(beamwidth));
+    f.Set("Step",        DoubleValue(step));
+    f.Set("Interpolate", BooleanValue(interpolate));
+    f.Set("MaxError",    DoubleValue(maxError));
+    Ptr<TabulatedAntennaModel> t = f.Create<TabulatedAntennaModel>();
+    const double t0 = GetWallClockSeconds();
+    const AntennaGainTable& table = t->GetTable();
+    const double built = GetWallClockSeconds() - t0;
+    v.push_back(Variant{interpolate ? "table" : "table-nearest", f, t, built,
+                        table.GetEntries(), table.GetMemoryBytes()});
+  }
+  return v;
+}
+
+// Fastest of 'repeat' runs of fn(), in seconds.
+template <typename F>
+static double
+BestOf(uint32_t repeat, F&& fn)
+{
+  double best = 1e300;
+  for (uint32_t r = 0; r < repeat; ++r)
+  {
+    const double t0 = GetWallClockSeconds();
+    fn();
+    best = std::min(best, GetWallClockSeconds() - t0);
+  }
+  return best;
+}
+
+static volatile double g_sink; // keeps the timed loops from being optimised away
+
+// 7 sites (centre + first ring, ISD 500 m), 3 sectors each with the antenna
+// 0.5 m towards boresight, and 'ues' UEs dropped uniformly around them.
+static void
+MakeHexLayout(uint32_t ues, std::vector<Vector>& enbPos, std::vector<double>& enbOrient,
+              std::vector<Vector>& uePos)
+{
+  const double isd = 500.0;
+  for (int k = -1; k < 6; ++k)
+  {
+    const Vector site = (k < 0) ? Vector(0, 0, 30)
+                                : Vector(isd * std::cos(M_PI / 3 * k), isd * std::sin(M_PI / 3 * k), 30);
+    for (int s = 0; s < 3; ++s)
+    {
+      const double o = 120.0 * s;
+      enbPos.emplace_back(site.x + 0.5 * std::cos(o * M_PI / 180),
+                          site.y + 0.5 * std::sin(o * M_PI / 180), 30);
+      enbOrient.push_back(o);
+    }
+  }
+  std::mt19937_64 rng(2);
+  std::uniform_real_distribution<double> u(-1.2 * isd, 1.2 * isd);
+  uePos.resize(ues);
+  for (Vector& p : uePos)
+  {
+    p = Vector(u(rng), u(rng), 1.5);
+  }
+}
+
+// ---------- Benchmarks ----------
+
+static void
+BenchAntenna(const std::string& typeId, std::vector<Variant>& vars, uint32_t samples,
+             uint32_t repeat, std::ostream* csv)
+{
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> uAz(-M_PI, M_PI), uIncl(0.0, M_PI);
+  std::vector<Angles> dirs;
+  dirs.reserve(samples);
+  for (uint32_t i = 0; i < samples; ++i)
+  {
+    // Mostly near the horizon (where UEs are), some anywhere
+    const double incl = (i % 4) ? M_PI / 2 + 0.2 * (uIncl(rng) / M_PI - 0.5) : uIncl(rng);
+    dirs.emplace_back(uAz(rng), incl);
+  }
+  std::vector<double> ref(samples);
+  for (uint32_t i = 0; i < samples; ++i)
+  {
+    ref[i] = vars[0].model->GetGainDb(dirs[i]);
+  }
+
+  double baseNs = 0.0;
+  std::cout << std::left << std::setw(15) << "variant" << std::right << std::setw(10) << "ns/call"
+            << std::setw(10) << "speedup" << std::setw(14) << "max err dB" << std::setw(10)
+            << "bins" << std::setw(10) << "KiB" << std::setw(12) << "build ms" << "\n";
+  for (Variant& v : vars)
+  {
+    Ptr<AntennaModel> m = v.model;
+    const double sec = BestOf(repeat, [&] {
+      double acc = 0.0;
+      for (const Angles& a : dirs)
+      {
+        acc += m->GetGainDb(a);
+      }
+      g_sink = acc;
+    });
+    const double ns = sec * 1e9 / samples;
+    if (v.name == "analytic")
+    {
+      baseNs = ns;
+    }
+    // Error against the analytic model, with the table's default Floor
+    // (60 dB below the peak) applied to both
+    double err = 0.0;
+    if (v.name != "analytic")
+    {
+      const double floorDb = vars[0].model->GetGainDb(Angles(0.0, M_PI / 2)) - 60.0;
+      for (uint32_t i = 0; i < samples; ++i)
+      {
+        err = std::max(err, std::abs(m->GetGainDb(dirs[i]) - std::max(ref[i], floorDb)));
+      }
+    }
+    std::cout << std::left << std::setw(15) << v.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << ns << std::setw(9)
+              << (ns > 0 ? baseNs / ns : 0.0) << "x" << std::setprecision(4) << std::setw(14)
+              << err << std::setw(10) << v.bins << std::setprecision(1) << std::setw(10)
+              << v.bytes / 1024.0 << std::setprecision(2) << std::setw(12) << v.buildSec * 1e3
+              << "\n";
+    if (csv)
+    {
+      (*csv) << "antenna," << typeId << "," << v.name << "," << ns << "," << err << "," << v.bins
+             << "\n";
+    }
+  }
+}
+
+static void
+BenchLink(const std::string& typeId, std::vector<Variant>& vars, uint32_t ues, uint32_t repeat,
+          std::ostream* csv)
+{
+  std::vector<Vector> enbPos, uePos;
+  std::vector<double> enbOrient;
+  MakeHexLayout(ues, enbPos, enbOrient, uePos);
+  const uint64_t links = static_cast<uint64_t>(enbPos.size()) * ues;
+
+  // One oriented antenna object per cell, as LteHelper installs them
+  double baseNs = 0.0;
+  for (Variant& v : vars)
+  {
+    std::vector<Ptr<AntennaModel>> cellAnt;
+    for (double o : enbOrient)
+    {
+      v.factory.Set("Orientation", DoubleValue(o));
+      Ptr<AntennaModel> a = v.factory.Create<AntennaModel>();
+      a->GetGainDb(Angles(0.0, M_PI / 2)); // build tables before timing
+      cellAnt.push_back(a);
+    }
+    const double sec = BestOf(repeat, [&] {
+      double acc = 0.0;
+      for (size_t c = 0; c < enbPos.size(); ++c)
+      {
+        const Ptr<AntennaModel>& a = cellAnt[c];
+        for (const Vector& p : uePos)
+        {
+          acc += a->GetGainDb(Angles(p, enbPos[c]));
+        }
+      }
+      g_sink = acc;
+    });
+    const double ns = sec * 1e9 / links;
+    if (v.name == "analytic")
+    {
+      baseNs = ns;
+    }
+    std::cout << std::left << std::setw(15) << v.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << ns << " ns/link" << std::setw(9)
+              << (ns > 0 ? baseNs / ns : 0.0) << "x  (" << enbPos.size() << " cells x " << ues
+              << " UEs)\n";
+    if (csv)
+    {
+      (*csv) << "link," << typeId << "," << v.name << "," << ns << ",," << v.bins << "\n";
+    }
+  }
+}
+
+// One transport block as LteSpectrumPhy::EndRxData hands it to the error model
+struct TbCase
+{
+  SpectrumValue sinr;
+  std::vector<int> rbs;
+  uint16_t sizeBytes;
+  uint8_t mcs;
+};
+
+static std::vector<TbCase>
+MakeTbStates(const std::string& kind, uint32_t states)
+{
+  Ptr<const SpectrumModel> sm = LteSpectrumValueHelper::GetSpectrumModel(100, 50);
+  Ptr<LteAmc> amc = CreateObject<LteAmc>();
+  std::mt19937_64 rng(3);
+  std::uniform_real_distribution<double> uMean(-5.0, 25.0);
+  std::normal_distribution<double> spread(0.0, 3.0);
+  const int rbgSize = 3; // 50 RBs → RBGs of 3 (36.213 Table 7.1.6.1-1)
+
+  std::vector<TbCase> out;
+  for (uint32_t k = 0; k < (kind == "static" ? 1u : states); ++k)
+  {
+    TbCase c{SpectrumValue(sm), {}, 0, 0};
+    const double meanDb = (kind == "static") ? 12.0 : uMean(rng);
+    Values::iterator v = c.sinr.ValuesBegin();
+    for (int rb = 0; rb < 50; ++rb)
+    {
+      v[rb] = std::pow(10.0, (meanDb + (kind == "static" ? 0.0 : spread(rng))) / 10.0);
+    }
+    int first = 0, last = 50;
+    if (kind != "static")
+    {
+      std::uniform_int_distribution<int> uRbg(0, 16);
+      int a = uRbg(rng), b = uRbg(rng);
+      first = std::min(a, b) * rbgSize;
+      last = std::min(50, (std::max(a, b) + 1) * rbgSize);
+    }
+    for (int rb = first; rb < last; ++rb)
+    {
+      c.rbs.push_back(rb);
+    }
+    const int cqi = std::max(1, LteLinkAbstraction::CqiFromSinr(std::pow(10.0, meanDb / 10.0), 5e-5));
+    c.mcs = static_cast<uint8_t>(LteLinkAbstraction::McsFromCqi(cqi));
+    c.sizeBytes = static_cast<uint16_t>(amc->GetDlTbSizeFromMcs(c.mcs, static_cast<int>(c.rbs.size())) / 8);
+    out.push_back(c);
+  }
+  return out;
+}
+
+static void
+BenchMiesm(const std::string& kind, uint32_t tbs, uint32_t states, double stepDb,
+           uint32_t repeat, std::ostream* csv)
+{
+  const std::vector<TbCase> pool = MakeTbStates(kind, states);
+  std::mt19937_64 rng(4);
+  std::uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+  std::vector<uint32_t> seq(tbs);
+  for (uint32_t& i : seq)
+  {
+    i = static_cast<uint32_t>(pick(rng));
+  }
+
+  std::vector<double> ref(tbs);
+  std::cout << std::left << std::setw(10) << "mode" << std::right << std::setw(12) << "ns/TB"
+            << std::setw(10) << "speedup" << std::setw(11) << "hit rate" << std::setw(14)
+            << "max |dBLER|" << std::setw(14) << "mean |dBLER|" << std::setw(10) << "entries"
+            << "\n";
+  double baseNs = 0.0;
+  for (MiesmCache::Mode mode : {MiesmCache::NS3, MiesmCache::EXACT, MiesmCache::FAST})
+  {
+    std::vector<double> bler(tbs);
+    double hitRate = 0.0;
+    size_t entries = 0;
+    const double sec = BestOf(repeat, [&] {
+      MiesmCache cache(mode, stepDb); // cold every run
+      for (uint32_t k = 0; k < tbs; ++k)
+      {
+        const TbCase& c = pool[seq[k]];
+        bler[k] = cache.GetTbDecodificationStats(c.sinr, c.rbs, c.sizeBytes, c.mcs, {}).tbler;
+      }
+      hitRate = cache.GetHitRate();
+      entries = cache.GetEntries();
+    });
+    if (mode == MiesmCache::NS3)
+    {
+      ref = bler;
+    }
+    double maxErr = 0.0, sumErr = 0.0;
+    for (uint32_t k = 0; k < tbs; ++k)
+    {
+      const double e = std::abs(bler[k] - ref[k]);
+      maxErr = std::max(maxErr, e);
+      sumErr += e;
+    }
+    const double ns = sec * 1e9 / tbs;
+    if (mode == MiesmCache::NS3)
+    {
+      baseNs = ns;
+    }
+    const char* name = (mode == MiesmCache::NS3) ? "ns3" : (mode == MiesmCache::EXACT) ? "exact" : "fast";
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << ns << std::setw(9)
+              << (ns > 0 ? baseNs / ns : 0.0) << "x" << std::setw(10) << 100.0 * hitRate
+              << "%" << std::scientific << std::setprecision(2) << std::setw(14) << maxErr
+              << std::setw(14) << sumErr / tbs << std::fixed << std::setw(10) << entries
+              << "\n";
+    if (csv)
+    {
+      (*csv) << "miesm," << kind << "," << name << "," << ns << "," << maxErr << ","
+             << entries << "\n";
+    }
+  }
+}
+
+// Downlink SINR of every UE in the 21-cell grid, reuse 1, all cells
+// transmitting on all 50 RBs, for 'ttis' subframes. "operators" is what
+// MultiModelSpectrumChannel + LteInterference + LteChunkProcessor do per
+// receiver; "fused" is the same arithmetic through PsdInterference.
+static void
+BenchPsd(uint32_t ues, uint32_t ttis, uint32_t repeat, std::ostream* csv)
+{
+  std::vector<Vector> enbPos, uePos;
+  std::vector<double> enbOrient;
+  MakeHexLayout(ues, enbPos, enbOrient, uePos);
+  const size_t cells = enbPos.size();
+
+  // Lab4_Cpp_LTE radio: EARFCN 100, 50 RBs, eNB 30 dBm, UE NF 9 dB, Friis
+  const uint32_t earfcn = 100;
+  const uint16_t nRb = 50;
+  std::vector<int> allRbs(nRb);
+  std::iota(allRbs.begin(), allRbs.end(), 0);
+  Ptr<SpectrumValue> tx = LteSpectrumValueHelper::CreateTxPowerSpectralDensity(earfcn, nRb, 30.0, allRbs);
+  Ptr<SpectrumValue> noise = LteSpectrumValueHelper::CreateNoisePowerSpectralDensity(earfcn, nRb, 9.0);
+  const double lambda = 299792458.0 / LteSpectrumValueHelper::GetCarrierFrequency(earfcn);
+  std::vector<double> gain(cells * ues); // [ue * cells + cell]
+  std::vector<size_t> serving(ues, 0);
+  for (uint32_t k = 0; k < ues; ++k)
+  {
+    for (size_t c = 0; c < cells; ++c)
+    {
+      const double d = std::max(1.0, CalculateDistance(uePos[k], enbPos[c]));
+      gain[k * cells + c] = std::pow(lambda / (4 * M_PI * d), 2);
+      if (gain[k * cells + c] > gain[k * cells + serving[k]])
+      {
+        serving[k] = c;
+      }
+    }
+  }
+  const double dt = 0.001 - 3 * 71.4e-6; // data chunk of one subframe (after 3 ctrl symbols)
+
+  // Per-UE SINR averaged over the run (what the CQI chunk processor reports)
+  std::vector<SpectrumValue> refAvg, fusedAvg;
+  const double opSec = BestOf(repeat, [&] {
+    refAvg.assign(ues, SpectrumValue(tx->GetSpectrumModel()));
+    std::vector<Ptr<SpectrumValue>> rx(cells);
+    for (uint32_t t = 0; t < ttis; ++t)
+    {
+      for (uint32_t k = 0; k < ues; ++k)
+      {
+        Ptr<SpectrumValue> all = Create<SpectrumValue>(tx->GetSpectrumModel());
+        for (size_t c = 0; c < cells; ++c)
+        {
+          rx[c] = Copy<SpectrumValue>(tx); // channel: one PSD per receiver
+          *rx[c] *= gain[k * cells + c];
+          *all += *rx[c]; // LteInterference::AddSignal
+        }
+        const SpectrumValue& s = *rx[serving[k]];
+        SpectrumValue interf = (*all) - s + (*noise);
+        SpectrumValue sinr = s / interf;
+        refAvg[k] += sinr * dt; // LteChunkProcessor::EvaluateChunk
+        for (size_t c = 0; c < cells; ++c)
+        {
+          *all -= *rx[c]; // LteInterference::DoSubtractSignal
+        }
+      }
+    }
+  });
+  const double fusedSec = BestOf(repeat, [&] {
+    fusedAvg.assign(ues, SpectrumValue(tx->GetSpectrumModel()));
+    PsdInterference rx(tx->GetSpectrumModel());
+    rx.SetNoise(*noise);
+    SpectrumValue s(tx->GetSpectrumModel());
+    for (uint32_t t = 0; t < ttis; ++t)
+    {
+      for (uint32_t k = 0; k < ues; ++k)
+      {
+        for (size_t c = 0; c < cells; ++c)
+        {
+          rx.AddSignal(*tx, gain[k * cells + c]);
+        }
+        psd::Scale(s, *tx, gain[k * cells + serving[k]]);
+        rx.ComputeSinr(s);
+        psd::AddScaled(fusedAvg[k], rx.GetSinr(), dt);
+        for (size_t c = 0; c < cells; ++c)
+        {
+          rx.SubtractSignal(*tx, gain[k * cells + c]);
+        }
+      }
+    }
+  });
+
+  double maxRel = 0.0;
+  for (uint32_t k = 0; k < ues; ++k)
+  {
+    for (uint16_t rb = 0; rb < nRb; ++rb)
+    {
+      const double a = psd::Data(refAvg[k])[rb], b = psd::Data(fusedAvg[k])[rb];
+      maxRel = std::max(maxRel, std::abs(a - b) / std::max(std::abs(a), 1e-300));
+    }
+  }
+  const double rxTtis = double(ttis) * ues;
+  for (const char* name : {"operators", "fused"})
+  {
+    const bool fused = (name[0] == 'f');
+    const double ns = (fused ? fusedSec : opSec) * 1e9 / rxTtis;
+    std::cout << std::left << std::setw(15) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << ns << " ns/UE-TTI" << std::setw(9)
+              << opSec / (fused ? fusedSec : opSec) << "x  (" << cells << " cells x " << ues
+              << " UEs x " << ttis << " TTIs, " << nRb << " RBs)";
+    if (fused)
+    {
+      std::cout << std::scientific << std::setprecision(2) << "  max rel diff " << maxRel;
+    }
+    std::cout << "\n";
+    if (csv)
+    {
+      (*csv) << "psd,sinr," << name << "," << ns << "," << (fused ? maxRel : 0.0) << "," << cells
+             << "\n";
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::string bench   = "all";
+  std::string antenna = "all";
+  double   beamwidth  = 65.0;
+  double   step       = 1.0;
+  double   maxError   = 0.05;
+  uint32_t samples    = 1000000;
+  uint32_t ues        = 210;
+  uint32_t tbs        = 100000;
+  uint32_t states     = 256;
+  uint32_t ttis       = 100;
+  double   errorStep  = 0.25;
+  uint32_t repeat     = 5;
+  std::string csvPath = "";
+
+  CommandLine cmd;
+  cmd.AddValue("bench",     "antenna | link | miesm | psd | all.",                    bench);
+  cmd.AddValue("antenna",   "cosine | parabolic | all.",                              antenna);
+  cmd.AddValue("beamwidth", "Horizontal beamwidth in degrees.",                       beamwidth);
+  cmd.AddValue("step",      "Initial table grid in degrees.",                         step);
+  cmd.AddValue("maxError",  "Table error bound in dB.",                               maxError);
+  cmd.AddValue("samples",   "Directions per antenna benchmark.",                      samples);
+  cmd.AddValue("ues",       "UEs for the link and PSD benchmarks.",                   ues);
+  cmd.AddValue("ttis",      "Subframes of the PSD benchmark.",                        ttis);
+  cmd.AddValue("tbs",       "Transport blocks per MIESM workload.",                   tbs);
+  cmd.AddValue("states",    "Channel states of the selective MIESM workload.",        states);
+  cmd.AddValue("errorStep", "SINR quantisation of the fast MIESM mode (dB).",         errorStep);
+  cmd.AddValue("repeat",    "Timed repetitions (fastest reported).",                  repeat);
+  cmd.AddValue("csv",       "If non-empty, write one row per bench/case/variant.",    csvPath);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  if (bench != "antenna" && bench != "link" && bench != "miesm" && bench != "psd" &&
+      bench != "all")
+  {
+    std::cerr << "ERROR: --bench must be antenna, link, miesm, psd or all.\n";
+    return 1;
+  }
+  std::vector<std::string> patterns;
+  if (antenna == "cosine" || antenna == "all")    patterns.push_back("ns3::CosineAntennaModel");
+  if (antenna == "parabolic" || antenna == "all") patterns.push_back("ns3::ParabolicAntennaModel");
+  if (patterns.empty() || samples == 0 || ues == 0 || repeat == 0 || tbs == 0 || states == 0 ||
+      ttis == 0 || errorStep <= 0)
+  {
+    std::cerr << "ERROR: --antenna must be cosine, parabolic or all; counts must be > 0.\n";
+    return 1;
+  }
+
+  std::ofstream ofs;
+  std::ostream* csv = nullptr;
+  if (!csvPath.empty())
+  {
+    ofs.open(csvPath, std::ios::trunc);
+    if (!ofs.is_open())
+    {
+      std::cerr << "ERROR: cannot open " << csvPath << "\n";
+      return 1;
+    }
+    ofs << "bench,case,variant,ns_per_call,max_err,entries\n";
+    csv = &ofs;
+  }
+
+  for (const std::string& typeId : patterns)
+  {
+    if (bench == "miesm" || bench == "psd")
+    {
+      break;
+    }
+    std::vector<Variant> vars = MakeVariants(typeId, beamwidth, step, maxError);
+    if (bench == "antenna" || bench == "all")
+    {
+      std::ostringstream title;
+      title << typeId << " GetGainDb (beamwidth " << beamwidth << " deg)";
+      Banner(title.str());
+      BenchAntenna(typeId, vars, samples, repeat, csv);
+    }
+    if (bench == "link" || bench == "all")
+    {
+      Banner(typeId + " multi-cell link gain");
+      BenchLink(typeId, vars, ues, repeat, csv);
+    }
+  }
+  if (bench == "miesm" || bench == "all")
+  {
+    for (const char* kind : {"static", "selective"})
+    {
+      Banner(std::string("MIESM transport-block BLER, ") + kind + " workload");
+      BenchMiesm(kind, tbs, states, errorStep, repeat, csv);
+    }
+  }
+  if (bench == "psd" || bench == "all")
+  {
+    Banner("Downlink SINR of 50-RB PSDs, 21-cell reuse-1 grid");
+    BenchPsd(ues, ttis, repeat, csv);
+  }
+  return 0;
+}
@@ -0,0 +1,668 @@
+/*
+ * Lab 04 — Downlink SINR coverage map (REM) for antenna comparisons
+ * -----------------------------------------------------------------
+ * What this program computes:
+ *   For every point of an nx x ny grid: the received power from every eNB, the
+ *   best (serving) eNB, the downlink SINR and the resulting CQI / 50-RB PHY rate.
+ *   No simulation is run. The numbers are the wideband values the LTE PHY sees
+ *   with the Lab 4 radio settings:
+ *     - eNB TxPower 30 dBm, UE noise figure 9 dB, 50 RBs, DL EARFCN 100 (2.12 GHz)
+ *     - pathloss: Friis (LteHelper default) or LogDistance
+ *     - antennas: isotropic | cosine | parabolic on BOTH eNB and UE, as in
+ *       Lab4_Cpp_LTE.cc, with --enbOrient/--ueOrient style orientations
+ *     - frequency reuse 1: every other eNB is interference
+ *
+ * Why this exists:
+ *   Lab4_Cpp_LTE.cc shows the effect of --antenna / --enbOrient / --ueOrient at ONE
+ *   distance per run. A coverage map shows the whole pattern at once.
+ *
+ * How it is fast:
+ *   - the grid is split by rows across a thread pool (lab-thread-pool.h);
+ *   - each row is evaluated as arrays: one log10 per pixel and eNB for the
+ *     pathloss, and one atan2 only for directional antennas. There are no
+ *     virtual calls or object look-ups in the loops, and the pathloss loop
+ *     vectorises;
+ *   - ns-3 objects are NOT touched from the worker threads (Ptr reference counts
+ *     are not thread-safe). The kernel re-implements the Friis / LogDistance and
+ *     Isotropic / Cosine / Parabolic formulas instead. At start-up the kernel is
+ *     checked against the real ns-3 models on --validate random points, and the
+ *     program aborts if they differ by more than 1e-6 dB.
+ *   --kernel=ns3 runs the plain ns-3 models point by point on one thread (the
+ *   reference; also the only choice for other pathloss models).
+ *
+ * Output:
+ *   --out  : columnar .labcol (lab-columnar.h), one row per pixel, row-major from
+ *            (xMin, yMin): sinr_db, rsrp_dbm, cell, cqi, phy_rate_bps; metadata
+ *            carries nx, ny and the bounds. Read it with common/scripts/labcol.py;
+ *            Lab-04-LTE/code/plot_rem.py renders a PNG.
+ *   --ppm  : the SINR map as a colour PPM image (-10..30 dB), which converts
+ *            directly to PNG (e.g. `convert rem.ppm rem.png`).
+ *
+ * CLI examples:
+ *   ./ns3 run "scratch/Lab4_Cpp_Rem --antenna=parabolic --enbs=0,0,45 --ueOrient=225 --ppm=rem.ppm"
+ *   ./ns3 run "scratch/Lab4_Cpp_Rem --enbs='0,0,0;0,0,120;0,0,240;1000,0,0;1000,0,120;1000,0,240' --antenna=cosine --xMin=-1500 --xMax=2500 --yMin=-2000 --yMax=2000 --out=rem.labcol"
+ *   ./ns3 run "scratch/Lab4_Cpp_Rem --nx=1000 --ny=1000 --threads=16"
+ *   ./ns3 run "scratch/Lab4_Cpp_Rem --kernel=ns3 --nx=200 --ny=200"
+ *
+ * Key CLI flags:
+ *   --enbs        : "x,y,orientDeg[;x,y,orientDeg...]" (default "0,0,0")
+ *   --antenna     : isotropic | cosine | parabolic (default isotropic)
+ *   --beamwidth   : cosine HorizontalBeamwidth / parabolic Beamwidth in deg (default 60)
+ *   --maxAttenuation : parabolic MaxAttenuation in dB (default 20)
+ *   --ueOrient    : UE antenna orientation in deg (default 0)
+ *   --enbHeight / --ueHeight : antenna heights in m (default 0 / 0, as in Lab4_Cpp_LTE)
+ *   --pathloss    : friis | logdistance (default friis)
+ *   --xMin --xMax --yMin --yMax : map bounds in m (default ±5000)
+ *   --nx / --ny   : grid size (default 1000 x 1000)
+ *   --threads     : worker threads (0 = all cores)
+ *   --kernel      : vector (default) | ns3
+ *   --validate    : points checked against ns-3 before the vector run (default 2000)
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/antenna-module.h"
+#include "ns3/lte-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lab-columnar.h"             // .labcol output
+#include "lab-lte-link-abstraction.h" // SINR → CQI → MCS → TBS tables
+#include "lab-proc-stats.h"           // wall clock
+#include "lab-thread-pool.h"          // row-parallel evaluation
+#include "lab-startup-profiler.h"     // startup breakdown (LAB_STARTUP_PROFILE=1)
+
+using namespace ns3;
+
+// ---------- Small helpers ----------
+
+static void
+Banner(const std::string& title)
+{
+  std::cout << "\n==== " << title << " ====\n";
+}
+
+struct EnbSite
+{
+  double x;
+  double y;
+  double orientDeg;
+};
+
+static bool
+ParseEnbs(const std::string& spec, std::vector<EnbSite>& out)
+{
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ';'))
+  {
+    if (item.empty())
+    {
+      continue;
+    }
+    EnbSite e{0, 0, 0};
+    char c1 = 0, c2 = 0;
+    std::istringstream in(item);
+    if (!(in >> e.x >> c1 >> e.y >> c2 >> e.orientDeg) || c1 != ',' || c2 != ',')
+    {
+      return false;
+    }
+    out.push_back(e);
+  }
+  return !out.empty();
+}
+
+// ---------- Radio configuration shared by both kernels ----------
+
+struct RemConfig
+{
+  std::string antenna = "isotropic";
+  double beamwidthDeg = 60.0;       // Cosine HorizontalBeamwidth / Parabolic Beamwidth
+  double maxAttenuationDb = 20.0;   // Parabolic MaxAttenuation
+  double ueOrientDeg = 0.0;
+  double enbHeight = 0.0;
+  double ueHeight = 0.0;
+  std::string pathloss = "friis";
+  double txPowerDbm = 30.0;         // LteEnbPhy::TxPower default
+  double noiseFigureDb = 9.0;       // LteUePhy::NoiseFigure default
+  uint16_t dlEarfcn = 100;
+  uint16_t nRb = 50;
+};
+
+// ---------- Vector kernel: analytic formulas, row at a time ----------
+
+class RemKernel
+{
+public:
+  RemKernel(const RemConfig& c, const std::vector<EnbSite>& enbs)
+    : m_cfg(c),
+      m_enbs(enbs)
+  {
+    const double fc = LteSpectrumValueHelper::GetCarrierFrequency(c.dlEarfcn);
+    const double lambda = 299792458.0 / fc;
+    // Friis: L = 20 log10(4 pi d / lambda) + 10 log10(SystemLoss) = k + 10 log10(d^2)
+    m_friisK = 20.0 * std::log10(4.0 * M_PI / lambda); // SystemLoss = 1, MinLoss = 0
+    m_noiseDbm = -174.0 + 10.0 * std::log10(c.nRb * 180e3) + c.noiseFigureDb;
+    m_friis = (c.pathloss == "friis");
+    m_ant = c.antenna == "parabolic" ? PARABOLIC : (c.antenna == "cosine" ? COSINE : ISOTROPIC);
+    m_bwRad = c.beamwidthDeg * M_PI / 180.0;
+    // CosineAntennaModel::GetExponentFromBeamwidth
+    m_cosExpH = -3.0 / (20.0 * std::log10(std::cos(m_bwRad / 4.0)));
+    m_cosExpV = -3.0 / (20.0 * std::log10(std::cos(2.0 * M_PI / 4.0))); // VerticalBeamwidth 360
+  }
+
+  double GetNoiseDbm() const { return m_noiseDbm; }
+
+  // Received power (dBm) from eNB 'e' at points (x[i], y), i < n.
+  void RxRow(uint32_t e, const double* x, double y, size_t n, double* rx, double* tmp) const
+  {
+    const EnbSite& s = m_enbs[e];
+    const double dy = y - s.y;
+    const double dz = m_cfg.ueHeight - m_cfg.enbHeight;
+    const double dyz2 = dy * dy + dz * dz;
+
+    // Pathloss
+    if (m_friis)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double dx = x[i] - s.x;
+        const double d2 = dx * dx + dyz2;
+        rx[i] = m_cfg.txPowerDbm - std::max(m_friisK + 10.0 * std::log10(d2), 0.0);
+      }
+    }
+    else // logdistance: exponent 3, d0 = 1 m, L0 = 46.6777 dB
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double dx = x[i] - s.x;
+        const double d2 = dx * dx + dyz2;
+        rx[i] = m_cfg.txPowerDbm - 46.6777 - (d2 <= 1.0 ? 0.0 : 15.0 * std::log10(d2));
+      }
+    }
+
+    if (m_ant == ISOTROPIC)
+    {
+      return; // IsotropicAntennaModel Gain = 0 dB
+    }
+
+    // Azimuth eNB → UE; the UE sees the eNB at azimuth + pi.
+    for (size_t i = 0; i < n; ++i)
+    {
+      tmp[i] = std::atan2(dy, x[i] - s.x);
+    }
+    const double oE = s.orientDeg * M_PI / 180.0;
+    const double oU = m_cfg.ueOrientDeg * M_PI / 180.0;
+    const bool level = (dz == 0.0);
+    for (size_t i = 0; i < n; ++i)
+    {
+      double gain = Gain(tmp[i] - oE) + Gain(tmp[i] + M_PI - oU);
+      if (!level && m_ant == COSINE)
+      {
+        const double dx = x[i] - s.x;
+        const double r = std::sqrt(dx * dx + dyz2);
+        const double incl = r > 0.0 ? std::acos(dz / r) : 0.0; // eNB → UE
+        gain += VGain(incl) + VGain(M_PI - incl);
+      }
+      rx[i] += gain;
+    }
+  }
+
+private:
+  enum Antenna
+  {
+    ISOTROPIC,
+    COSINE,
+    PARABOLIC
+  };
+
+  // Horizontal pattern (dB) at azimuth offset phi. Both patterns are even in phi,
+  // so wrapping to [-pi, pi] (remainder) matches ns-3's (-pi, pi].
+  double Gain(double phi) const
+  {
+    phi = std::remainder(phi, 2.0 * M_PI);
+    if (m_ant == PARABOLIC)
+    {
+      const double r = phi / m_bwRad;
+      return -std::min(12.0 * r * r, m_cfg.maxAttenuationDb);
+    }
+    // cosine, MaxGain 0 dB
+    return 20.0 * m_cosExpH * std::log10(std::cos(phi / 2.0)); // 20 log10(cos^exp)
+  }
+
+  // Cosine vertical element factor (dB) for inclination incl.
+  double VGain(double incl) const
+  {
+    const double theta = incl - M_PI / 2.0;
+    return 20.0 * m_cosExpV * std::log10(std::cos(theta / 2.0));
+  }
+
+  RemConfig m_cfg;
+  std::vector<EnbSite> m_enbs;
+  bool    m_friis;
+  Antenna m_ant;
+  double  m_friisK;
+  double  m_noiseDbm;
+  double  m_bwRad;
+  double  m_cosExpH;
+  double  m_cosExpV;
+};
+
+// ---------- Reference: the real ns-3 models, one point at a time ----------
+
+class Ns3Reference
+{
+public:
+  Ns3Reference(const RemConfig& c, const std::vector<EnbSite>& enbs)
+    : m_cfg(c),
+      m_enbs(enbs)
+  {
+    const double fc = LteSpectrumValueHelper::GetCarrierFrequency(c.dlEarfcn);
+    ObjectFactory lossF(c.pathloss == "friis" ? "ns3::FriisPropagationLossModel"
+                                              : "ns3::LogDistancePropagationLossModel");
+    m_loss = lossF.Create<PropagationLossModel>();
+    m_loss->SetAttributeFailSafe("Frequency", DoubleValue(fc)); // as LteHelper does
+
+    for (const EnbSite& s : enbs)
+    {
+      m_enbAnt.push_back(MakeAntenna(s.orientDeg));
+      Ptr<ConstantPositionMobilityModel> m = CreateObject<ConstantPositionMobilityModel>();
+      m->SetPosition(Vector(s.x, s.y, c.enbHeight));
+      m_enbMob.push_back(m);
+    }
+    m_ueAnt = MakeAntenna(c.ueOrientDeg);
+    m_ueMob = CreateObject<ConstantPositionMobilityModel>();
+  }
+
+  double Rx(uint32_t e, double x, double y)
+  {
+    const Vector ue(x, y, m_cfg.ueHeight);
+    m_ueMob->SetPosition(ue);
+    const Vector enb = m_enbMob[e]->GetPosition();
+    const double g = m_enbAnt[e]->GetGainDb(Angles(ue, enb)) + m_ueAnt->GetGainDb(Angles(enb, ue));
+    return m_loss->CalcRxPower(m_cfg.txPowerDbm + g, m_enbMob[e], m_ueMob);
+  }
+
+private:
+  Ptr<AntennaModel> MakeAntenna(double orientDeg) const
+  {
+    if (m_cfg.antenna == "cosine")
+    {
+      return CreateObjectWithAttributes<CosineAntennaModel>(
+          "Orientation", DoubleValue(orientDeg),
+          "HorizontalBeamwidth", DoubleValue(m_cfg.beamwidthDeg));
+    }
+    if (m_cfg.antenna == "parabolic")
+    {
+      return CreateObjectWithAttributes<ParabolicAntennaModel>(
+          "Orientation", DoubleValue(orientDeg),
+          "Beamwidth", DoubleValue(m_cfg.beamwidthDeg),
+          "MaxAttenuation", DoubleValue(m_cfg.maxAttenuationDb));
+    }
+    return CreateObject<IsotropicAntennaModel>();
+  }
+
+  RemConfig m_cfg;
+  std::vector<EnbSite> m_enbs;
+  Ptr<PropagationLossModel> m_loss;
+  std::vector<Ptr<AntennaModel>> m_enbAnt;
+  std::vector<Ptr<MobilityModel>> m_enbMob;
+  Ptr<AntennaModel> m_ueAnt;
+  Ptr<ConstantPositionMobilityModel> m_ueMob;
+};
+
+// ---------- Map storage ----------
+
+struct RemMap
+{
+  uint32_t nx = 0, ny = 0;
+  double xMin = 0, xMax = 0, yMin = 0, yMax = 0;
+  std::vector<float>    sinrDb;   // row-major from (xMin, yMin)
+  std::vector<float>    rsrpDbm;  // serving eNB
+  std::vector<uint16_t> cell;     // index into --enbs
+
+  double X(uint32_t i) const { return nx > 1 ? xMin + i * (xMax - xMin) / (nx - 1) : xMin; }
+  double Y(uint32_t j) const { return ny > 1 ? yMin + j * (yMax - yMin) / (ny - 1) : yMin; }
+};
+
+// Serving cell and SINR from per-eNB received powers (dBm) at one pixel.
+static inline void
+Combine(const double* rxByEnb, size_t stride, uint32_t nEnb, double noiseMw,
+        float& sinrDb, float& rsrp, uint16_t& cell)
+{
+  double best = -1e300, sumMw = 0.0;
+  uint32_t bestE = 0;
+  for (uint32_t e = 0; e < nEnb; ++e)
+  {
+    const double v = rxByEnb[e * stride];
+    sumMw += std::pow(10.0, v / 10.0);
+    if (v > best)
+    {
+      best = v;
+      bestE = e;
+    }
+  }
+  const double sMw = std::pow(10.0, best / 10.0);
+  sinrDb = static_cast<float>(10.0 * std::log10(sMw / (noiseMw + sumMw - sMw)));
+  rsrp = static_cast<float>(best);
+  cell = static_cast<uint16_t>(bestE);
+}
+
+static void
+RunVector(const RemKernel& k, uint32_t nEnb, RemMap& map, ThreadPool& pool)
+{
+  const double noiseMw = std::pow(10.0, k.GetNoiseDbm() / 10.0);
+  std::vector<double> xs(map.nx);
+  for (uint32_t i = 0; i < map.nx; ++i)
+  {
+    xs[i] = map.X(i);
+  }
+  pool.ParallelFor(map.ny, 1, [&](size_t lo, size_t hi) {
+    std::vector<double> rx(size_t(nEnb) * map.nx), tmp(map.nx);
+    for (size_t j = lo; j < hi; ++j)
+    {
+      const double y = map.Y(static_cast<uint32_t>(j));
+      for (uint32_t e = 0; e < nEnb; ++e)
+      {
+        k.RxRow(e, xs.data(), y, map.nx, rx.data() + size_t(e) * map.nx, tmp.data());
+      }
+      const size_t base = j * map.nx;
+      for (uint32_t i = 0; i < map.nx; ++i)
+      {
+        Combine(rx.data() + i, map.nx, nEnb, noiseMw,
+                map.sinrDb[base + i], map.rsrpDbm[base + i], map.cell[base + i]);
+      }
+    }
+  });
+}
+
+static void
+RunNs3(Ns3Reference& ref, double noiseDbm, uint32_t nEnb, RemMap& map)
+{
+  const double noiseMw = std::pow(10.0, noiseDbm / 10.0);
+  std::vector<double> rx(nEnb);
+  for (uint32_t j = 0; j < map.ny; ++j)
+  {
+    for (uint32_t i = 0; i < map.nx; ++i)
+    {
+      for (uint32_t e = 0; e < nEnb; ++e)
+      {
+        rx[e] = ref.Rx(e, map.X(i), map.Y(j));
+      }
+      const size_t p = size_t(j) * map.nx + i;
+      Combine(rx.data(), 1, nEnb, noiseMw, map.sinrDb[p], map.rsrpDbm[p], map.cell[p]);
+    }
+  }
+}
+
+// ---------- Output ----------
+
+// 5-stop colour ramp (dark blue → cyan → green → yellow → red) over [lo, hi].
+static void
+Colour(double v, double lo, double hi, unsigned char rgb[3])
+{
+  static const double stops[5][3] = {
+      {0, 0, 96}, {0, 160, 224}, {32, 192, 64}, {240, 224, 32}, {208, 32, 16}};
+  double t = std::min(std::max((v - lo) / (hi - lo), 0.0), 1.0) * 4.0;
+  const int k = std::min(static_cast<int>(t), 3);
+  t -= k;
+  for (int c = 0; c < 3; ++c)
+  {
+    rgb[c] = static_cast<unsigned char>(stops[k][c] + t * (stops[k + 1][c] - stops[k][c]));
+  }
+}
+
+static bool
+WritePpm(const RemMap& map, const std::string& path)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+  {
+    return false;
+  }
+  out << "P6\n" << map.nx << " " << map.ny << "\n255\n";
+  std::vector<unsigned char> row(size_t(map.nx) * 3);
+  for (uint32_t j = map.ny; j-- > 0;) // image top = yMax
+  {
+    for (uint32_t i = 0; i < map.nx; ++i)
+    {
+      Colour(map.sinrDb[size_t(j) * map.nx + i], -10.0, 30.0, &row[size_t(i) * 3]);
+    }
+    out.write(reinterpret_cast<const char*>(row.data()), row.size());
+  }
+  return out.good();
+}
+
+static bool
+WriteLabcol(const RemMap& map, const RemConfig& cfg, const std::string& enbs,
+            const std::string& path)
+{
+  ColumnarTable t;
+  const uint32_t cSinr = t.AddColumn("sinr_db", ColumnarTable::F64);
+  const uint32_t cRsrp = t.AddColumn("rsrp_dbm", ColumnarTable::F64);
+  const uint32_t cCell = t.AddColumn("cell", ColumnarTable::U32);
+  const uint32_t cCqi  = t.AddColumn("cqi", ColumnarTable::U32);
+  const uint32_t cRate = t.AddColumn("phy_rate_bps", ColumnarTable::F64);
+  t.SetMeta("format", "lte-rem");
+  t.SetMeta("nx", std::to_string(map.nx));
+  t.SetMeta("ny", std::to_string(map.ny));
+  t.SetMeta("x_min", std::to_string(map.xMin));
+  t.SetMeta("x_max", std::to_string(map.xMax));
+  t.SetMeta("y_min", std::to_string(map.yMin));
+  t.SetMeta("y_max", std::to_string(map.yMax));
+  t.SetMeta("enbs", enbs);
+  t.SetMeta("antenna", cfg.antenna);
+  t.SetMeta("pathloss", cfg.pathloss);
+  t.Reserve(size_t(map.nx) * map.ny);
+  for (size_t p = 0; p < map.sinrDb.size(); ++p)
+  {
+    const double sinrLin = std::pow(10.0, map.sinrDb[p] / 10.0);
+    const int cqi = LteLinkAbstraction::CqiFromSinr(sinrLin, 0.00005);
+    const double rate =
+        cqi > 0 ? LteLinkAbstraction::TbsBits(LteLinkAbstraction::McsFromCqi(cqi), cfg.nRb) * 1000.0
+                : 0.0;
+    t.Set(cSinr, double(map.sinrDb[p]));
+    t.Set(cRsrp, double(map.rsrpDbm[p]));
+    t.Set(cCell, uint64_t(map.cell[p]));
+    t.Set(cCqi, uint64_t(cqi));
+    t.Set(cRate, rate);
+    t.EndRow();
+  }
+  return t.Write(path);
+}
+
+// ---------- main ----------
+
+int main(int argc, char* argv[])
+{
+  RemConfig cfg;
+  std::string enbSpec = "0,0,0";
+  RemMap map;
+  map.xMin = -5000; map.xMax = 5000; map.yMin = -5000; map.yMax = 5000;
+  map.nx = 1000; map.ny = 1000;
+  unsigned threads = 0;
+  std::string kernel = "vector";
+  uint32_t validate = 2000;
+  std::string outPath = "";
+  std::string ppmPath = "";
+
+  CommandLine cmd;
+  cmd.AddValue("enbs",       "eNBs as x,y,orientDeg;x,y,orientDeg;...",                   enbSpec);
+  cmd.AddValue("antenna",    "Antenna (eNB and UE): isotropic | cosine | parabolic.",     cfg.antenna);
+  cmd.AddValue("beamwidth",  "Cosine HorizontalBeamwidth / Parabolic Beamwidth (deg).",   cfg.beamwidthDeg);
+  cmd.AddValue("maxAttenuation", "Parabolic MaxAttenuation (dB).",                        cfg.maxAttenuationDb);
+  cmd.AddValue("ueOrient",   "UE antenna orientation (degrees).",                         cfg.ueOrientDeg);
+  cmd.AddValue("enbHeight",  "eNB antenna height (m).",                                   cfg.enbHeight);
+  cmd.AddValue("ueHeight",   "UE antenna height (m).",                                    cfg.ueHeight);
+  cmd.AddValue("pathloss",   "Pathloss model: friis | logdistance.",                      cfg.pathloss);
+  cmd.AddValue("xMin",       "Map x lower bound (m).",                                    map.xMin);
+  cmd.AddValue("xMax",       "Map x upper bound (m).",                                    map.xMax);
+  cmd.AddValue("yMin",       "Map y lower bound (m).",                                    map.yMin);
+  cmd.AddValue("yMax",       "Map y upper bound (m).",                                    map.yMax);
+  cmd.AddValue("nx",         "Grid points along x.",                                      map.nx);
+  cmd.AddValue("ny",         "Grid points along y.",                                      map.ny);
+  cmd.AddValue("threads",    "Worker threads (0 = all cores).",                           threads);
+  cmd.AddValue("kernel",     "vector (threaded, analytic) | ns3 (serial reference).",     kernel);
+  cmd.AddValue("validate",   "Random points checked against the ns-3 models first.",      validate);
+  cmd.AddValue("out",        "If non-empty, write the map as .labcol here.",              outPath);
+  cmd.AddValue("ppm",        "If non-empty, write the SINR map as a PPM image here.",     ppmPath);
+  cmd.Parse(argc, argv);
+  StartupProfiler::Mark("cli");
+
+  std::transform(cfg.antenna.begin(), cfg.antenna.end(), cfg.antenna.begin(),
+                 [](unsigned char c){ return std::tolower(c); });
+  std::transform(cfg.pathloss.begin(), cfg.pathloss.end(), cfg.pathloss.begin(),
+                 [](unsigned char c){ return std::tolower(c); });
+
+  std::vector<EnbSite> enbs;
+  if (!ParseEnbs(enbSpec, enbs))
+  {
+    std::cerr << "ERROR: --enbs expects x,y,orientDeg[;x,y,orientDeg...]\n";
+    return 1;
+  }
+  if (cfg.antenna != "isotropic" && cfg.antenna != "cosine" && cfg.antenna != "parabolic")
+  {
+    std::cerr << "ERROR: --antenna must be isotropic, cosine or parabolic.\n";
+    return 1;
+  }
+  if (cfg.pathloss != "friis" && cfg.pathloss != "logdistance")
+  {
+    std::cerr << "ERROR: --pathloss must be friis or logdistance.\n";
+    return 1;
+  }
+  if (kernel != "vector" && kernel != "ns3")
+  {
+    std::cerr << "ERROR: --kernel must be vector or ns3.\n";
+    return 1;
+  }
+  if (map.nx == 0 || map.ny == 0 || enbs.size() > 65535)
+  {
+    std::cerr << "ERROR: need --nx, --ny >= 1 and at most 65535 eNBs.\n";
+    return 1;
+  }
+
+  const uint32_t nEnb = static_cast<uint32_t>(enbs.size());
+  const size_t nPix = size_t(map.nx) * map.ny;
+  map.sinrDb.assign(nPix, 0.0f);
+  map.rsrpDbm.assign(nPix, 0.0f);
+  map.cell.assign(nPix, 0);
+
+  RemKernel k(cfg, enbs);
+  Ns3Reference ref(cfg, enbs);
+
+  Banner("REM: " + std::to_string(map.nx) + " x " + std::to_string(map.ny) + ", " +
+         std::to_string(nEnb) + " eNB(s), antenna=" + cfg.antenna + ", pathloss=" + cfg.pathloss);
+
+  // ---- Validate the analytic kernel against ns-3 (also times the ns-3 path) ----
+  double ns3PerPoint = 0.0;
+  if (validate > 0)
+  {
+    Ptr<UniformRandomVariable> ux = CreateObjectWithAttributes<UniformRandomVariable>(
+        "Min", DoubleValue(map.xMin), "Max", DoubleValue(map.xMax));
+    Ptr<UniformRandomVariable> uy = CreateObjectWithAttributes<UniformRandomVariable>(
+        "Min", DoubleValue(map.yMin), "Max", DoubleValue(map.yMax));
+    std::vector<double> px(validate), py(validate);
+    for (uint32_t v = 0; v < validate; ++v)
+    {
+      px[v] = ux->GetValue();
+      py[v] = uy->GetValue();
+    }
+    double maxErr = 0.0;
+    std::vector<double> rxVec(1), tmp(1);
+    const double t0 = GetWallClockSeconds();
+    std::vector<double> rxRef(size_t(validate) * nEnb);
+    for (uint32_t v = 0; v < validate; ++v)
+    {
+      for (uint32_t e = 0; e < nEnb; ++e)
+      {
+        rxRef[size_t(v) * nEnb + e] = ref.Rx(e, px[v], py[v]);
+      }
+    }
+    ns3PerPoint = (GetWallClockSeconds() - t0) / validate;
+    for (uint32_t v = 0; v < validate; ++v)
+    {
+      for (uint32_t e = 0; e < nEnb; ++e)
+      {
+        k.RxRow(e, &px[v], py[v], 1, rxVec.data(), tmp.data());
+        maxErr = std::max(maxErr, std::fabs(rxVec[0] - rxRef[size_t(v) * nEnb + e]));
+      }
+    }
+    std::cout << "validation: " << validate << " points x " << nEnb
+              << " eNB(s), max |vector - ns-3| = " << std::scientific << std::setprecision(2)
+              << maxErr << " dB" << std::defaultfloat << "\n";
+    if (kernel == "vector" && maxErr > 1e-6)
+    {
+      std::cerr << "ERROR: the vector kernel disagrees with the ns-3 models for this "
+                   "configuration; rerun with --kernel=ns3.\n";
+      return 1;
+    }
+  }
+
+  // ---- Evaluate ----
+  const double t0 = GetWallClockSeconds();
+  unsigned usedThreads = 1;
+  if (kernel == "vector")
+  {
+    ThreadPool pool(threads);
+    usedThreads = pool.GetThreads();
+    RunVector(k, nEnb, map, pool);
+  }
+  else
+  {
+    RunNs3(ref, k.GetNoiseDbm(), nEnb, map);
+  }
+  const double wall = GetWallClockSeconds() - t0;
+
+  std::cout << std::fixed << std::setprecision(3) << "kernel=" << kernel
+            << "  threads=" << usedThreads << "  wall=" << wall << " s  ("
+            << std::setprecision(2) << nPix * nEnb / wall / 1e6 << " M links/s)\n";
+  if (kernel == "vector" && ns3PerPoint > 0.0)
+  {
+    std::cout << "serial ns-3 estimate (from validation timing): " << std::setprecision(1)
+              << ns3PerPoint * nPix << " s  → speed-up x" << ns3PerPoint * nPix / wall << "\n";
+  }
+
+  // Coverage summary
+  size_t covered = 0;
+  double sinrSum = 0.0;
+  for (float s : map.sinrDb)
+  {
+    sinrSum += s;
+    covered += (LteLinkAbstraction::CqiFromSinr(std::pow(10.0, s / 10.0), 0.00005) > 0);
+  }
+  std::cout << std::setprecision(2) << "mean SINR=" << sinrSum / nPix << " dB  coverage (CQI>0)="
+            << 100.0 * covered / nPix << " %\n";
+
+  if (!outPath.empty())
+  {
+    if (WriteLabcol(map, cfg, enbSpec, outPath))
+    {
+      std::cout << "REM written: " << outPath << "\n";
+    }
+    else
+    {
+      std::cerr << "ERROR: cannot write " << outPath << "\n";
+    }
+  }
+  if (!ppmPath.empty())
+  {
+    if (WritePpm(map, ppmPath))
+    {
+      std::cout << "Image written: " << ppmPath << "\n";
+    }
+    else
+    {
+      std::cerr << "ERROR: cannot write " << ppmPath << "\n";
+    }
+  }
+
+  Simulator::Destroy();
+  return 0;
+}
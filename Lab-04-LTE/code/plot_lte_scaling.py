@@ -0,0 +1,53 @@
+"""Plot Lab4_Cpp_LTE_MultiCell scaling / scheduler-benchmark CSVs.
+
+  --scalingCsv : wall time, peak memory and event rate vs UE count
+  --schedCsv   : per-TTI scheduler cost, scheduler share of wall time and
+                 Jain fairness vs UE count (one line per scheduler)
+
+Usage: python3 plot_lte_scaling.py <scaling.csv | sched.csv> [outdir]
+"""
+import sys
+from pathlib import Path
+import pandas as pd
+import matplotlib.pyplot as plt
+
+csv  = Path(sys.argv[1] if len(sys.argv) > 1 else "scaling.csv")
+outd = Path(sys.argv[2]) if len(sys.argv) > 2 else csv.parent
+outd.mkdir(parents=True, exist_ok=True)
+
+df = pd.read_csv(csv).sort_values(["scheduler", "ues"])
+
+
+def per_scheduler(col, ylabel, title, fname, scale=1.0):
+    plt.figure()
+    for s in df["scheduler"].unique():
+        sub = df[df["scheduler"] == s]
+        plt.plot(sub["ues"], sub[col] * scale, marker='o', label=s)
+    plt.xlabel("UEs"); plt.ylabel(ylabel)
+    plt.title(title)
+    plt.legend(); plt.grid(True, linestyle="--", alpha=0.4); plt.tight_layout()
+    plt.savefig(outd / fname, dpi=150)
+
+
+if "dl_cost_mean_us" in df.columns:
+    # Scheduler benchmark (--schedCsv)
+    per_scheduler("dl_cost_mean_us", "DL allocation time per TTI (us)",
+                  "Scheduler CPU cost per TTI (DL, mean)", "lte_sched_dl_cost.png")
+    per_scheduler("dl_cost_p99_us", "DL allocation time per TTI (us)",
+                  "Scheduler CPU cost per TTI (DL, p99)", "lte_sched_dl_cost_p99.png")
+    per_scheduler("sched_share", "Share of run wall time (%)",
+                  "Scheduler share of simulation time", "lte_sched_share.png", 100.0)
+    per_scheduler("jain_dl", "Jain index (DL goodput)",
+                  "Radio fairness vs UE count", "lte_sched_jain.png")
+    per_scheduler("dl_Mbps", "Aggregate DL goodput (Mbps)",
+                  "Aggregate DL goodput vs UE count", "lte_sched_dl_goodput.png")
+else:
+    # Scaling (--scalingCsv)
+    label = f"{df['sites'].iloc[0]} sites x {df['sectors'].iloc[0]} sectors"
+    df["total_s"] = df["build_s"] + df["run_s"]
+    per_scheduler("total_s", "Wall time, build + run (s)",
+                  f"Wall time vs UE count ({label})", "lte_scaling_wall.png")
+    per_scheduler("peak_rss_kb", "Peak RSS (MiB)",
+                  f"Peak memory vs UE count ({label})", "lte_scaling_memory.png", 1 / 1024)
+    per_scheduler("events_per_s", "Events per wall second",
+                  f"Simulator event rate vs UE count ({label})", "lte_scaling_event_rate.png")
@@ -0,0 +1,35 @@
+"""Render a Lab4_Cpp_Rem --out=<file>.labcol map as PNG images.
+
+Usage: python3 plot_rem.py rem.labcol [outdir]
+"""
+import sys
+from pathlib import Path
+import matplotlib.pyplot as plt
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2] / "common" / "scripts"))
+from labcol import read_labcol  # noqa: E402
+
+src  = Path(sys.argv[1] if len(sys.argv) > 1 else "rem.labcol")
+outd = Path(sys.argv[2]) if len(sys.argv) > 2 else src.parent
+outd.mkdir(parents=True, exist_ok=True)
+
+df, meta = read_labcol(src)
+nx, ny = int(meta["nx"]), int(meta["ny"])
+extent = [float(meta["x_min"]), float(meta["x_max"]), float(meta["y_min"]), float(meta["y_max"])]
+title = f"{meta.get('antenna', '')} / {meta.get('pathloss', '')}"
+
+for col, label, fname, kw in [
+    ("sinr_db", "SINR (dB)", "rem_sinr.png", dict(vmin=-10, vmax=30, cmap="viridis")),
+    ("phy_rate_bps", "PHY rate (Mbps)", "rem_rate.png", dict(cmap="magma")),
+    ("cell", "Serving eNB index", "rem_cell.png", dict(cmap="tab20")),
+]:
+    grid = df[col].to_numpy().reshape(ny, nx)
+    if col == "phy_rate_bps":
+        grid = grid / 1e6
+    plt.figure()
+    plt.imshow(grid, origin="lower", extent=extent, **kw)
+    plt.colorbar(label=label)
+    plt.xlabel("x (m)"); plt.ylabel("y (m)")
+    plt.title(f"{label} — {title}")
+    plt.tight_layout()
+    plt.savefig(outd / fname, dpi=150)
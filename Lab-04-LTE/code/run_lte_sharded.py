@@ -0,0 +1,116 @@
+"""Wall-time scaling of Lab4_Cpp_LTE_Sharded against the shard (rank) count.
+
+For every rank count R it runs the program on R ranks (mpirun -np R, or R
+plain processes with --rank/--ranks when mpirun is not installed), times the
+whole job, merges the per-rank per-UE CSVs and checks that they match the
+R = 1 run row for row.
+
+Usage:
+  python3 run_lte_sharded.py [--ranks=1,2,4] [--bin=PATH] [--launcher=auto|mpirun|local]
+                         [--out=sharded_scaling.csv] [-- program flags...]
+
+--bin defaults to the optimized/default build under $NS3_DIR
+(~/ns-allinone-3.40/ns-3.40). Every rank count writes its files to
+lte_sharded_runs/R<R>/. The result table is printed and written to --out:
+ranks, job wall time, slowest rank's build/run time, speedup over R = 1 and
+whether the per-UE rows are identical.
+
+The speed-up is against R = 1 of Lab4_Cpp_LTE_Sharded itself. Sharded clusters
+do not interfere with each other, so neither the wall time nor the per-UE
+results are comparable with Lab4_Cpp_LTE_MultiCell.
+"""
+import argparse
+import csv
+import glob
+import os
+import shutil
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+
+def find_binary():
+    ns3 = Path(os.environ.get("NS3_DIR", Path.home() / "ns-allinone-3.40" / "ns-3.40"))
+    hits = sorted(glob.glob(str(ns3 / "build" / "scratch" / "*Lab4_Cpp_LTE_Sharded*")))
+    hits = [h for h in hits if os.access(h, os.X_OK)]
+    if not hits:
+        sys.exit(f"Lab4_Cpp_LTE_Sharded not found under {ns3}/build/scratch; build it or pass --bin")
+    return hits[-1]
+
+
+def run(binary, ranks, launcher, outdir, extra):
+    outdir.mkdir(parents=True, exist_ok=True)
+    args = [f"--ueCsv={outdir / 'ues.csv'}", f"--timingCsv={outdir / 'timing.csv'}"] + extra
+    t0 = time.perf_counter()
+    if launcher == "mpirun":
+        subprocess.run(["mpirun", "-np", str(ranks), binary] + args, check=True,
+                       stdout=subprocess.DEVNULL)
+    else:
+        procs = [subprocess.Popen([binary, f"--rank={r}", f"--ranks={ranks}"] + args,
+                                  stdout=subprocess.DEVNULL) for r in range(ranks)]
+        if any(p.wait() != 0 for p in procs):
+            sys.exit(f"a rank failed with R={ranks}")
+    wall = time.perf_counter() - t0
+
+    def shards(name):
+        stem, ext = os.path.splitext(name)
+        if ranks == 1:
+            return [outdir / name]
+        return [outdir / f"{stem}.rank{r}{ext}" for r in range(ranks)]
+
+    ues = []
+    for f in shards("ues.csv"):
+        with open(f) as fh:
+            ues += list(csv.DictReader(fh))
+    ues.sort(key=lambda u: (int(u["cluster"]), int(u["imsi"])))
+    timing = []
+    for f in shards("timing.csv"):
+        with open(f) as fh:
+            timing += list(csv.DictReader(fh))
+    return wall, ues, timing
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--ranks", default="1,2,4")
+    ap.add_argument("--bin", default=None)
+    ap.add_argument("--launcher", default="auto", choices=["auto", "mpirun", "local"])
+    ap.add_argument("--out", default="sharded_scaling.csv")
+    ap.add_argument("extra", nargs="*", help="flags passed to every rank (after --)")
+    opt = ap.parse_args()
+
+    binary = opt.bin or find_binary()
+    launcher = opt.launcher
+    if launcher == "auto":
+        launcher = "mpirun" if shutil.which("mpirun") else "local"
+    counts = [int(x) for x in opt.ranks.split(",") if x]
+    if 1 not in counts:
+        counts.insert(0, 1)  # the reference for speedup and equality
+
+    rows = []
+    ref_wall, ref_ues = None, None
+    print(f"{'ranks':>5} {'wall_s':>8} {'build_s':>8} {'run_s':>8} {'speedup':>8}  identical")
+    for r in sorted(counts):
+        wall, ues, timing = run(binary, r, launcher, Path("lte_sharded_runs") / f"R{r}", opt.extra)
+        if r == 1:
+            ref_wall, ref_ues = wall, ues
+        build = max(float(t["build_s"]) for t in timing)
+        run_s = max(float(t["run_s"]) for t in timing)
+        same = ues == ref_ues
+        rows.append({"ranks": r, "wall_s": wall, "max_build_s": build, "max_run_s": run_s,
+                     "speedup": ref_wall / wall, "ues": len(ues), "identical": int(same)})
+        print(f"{r:>5} {wall:8.2f} {build:8.2f} {run_s:8.2f} {ref_wall / wall:8.2f}  "
+              f"{'yes' if same else 'NO'}")
+
+    with open(opt.out, "w", newline="") as fh:
+        w = csv.DictWriter(fh, fieldnames=list(rows[0].keys()))
+        w.writeheader()
+        w.writerows(rows)
+    print(f"CSV written: {opt.out}")
+    if not all(row["identical"] for row in rows):
+        sys.exit("per-UE results differ from the R = 1 run")
+
+
+if __name__ == "__main__":
+    main()
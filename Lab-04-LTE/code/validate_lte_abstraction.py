@@ -0,0 +1,97 @@
+"""Abstract vs full Lab4_Cpp_LTE goodput over a distance sweep.
+
+For every distance it runs Lab4_Cpp_LTE twice, once with --engine=abstract
+and once with the full EPC stack (--engine=full), both appending to the same
+CSV. It then checks each pair against the allowed deviation:
+
+  |abstract - full| <= max(--rtol * full, --atol)
+
+The defaults (rtol 0.15, atol 0.5 Mb/s) are the acceptance criterion for
+the link abstraction. The relative term covers PDCP/RLC/GTP-U header
+overhead and the one-step MCS error when a distance falls on a CQI
+boundary. The absolute term covers the points near the cell edge, where
+both engines are close to 0. The offered load defaults to 40 Mb/s, above the
+48-PRB peak rate, so the link and not the source sets the goodput.
+
+Usage:
+  python3 validate_lte_abstraction.py [--distances=100,500,...] [--bin=PATH]
+                         [--rtol=0.15] [--atol=0.5] [--out=lte_abstraction_check.csv]
+                         [-- program flags...]
+
+--bin defaults to the optimized/default build under $NS3_DIR
+(~/ns-allinone-3.40/ns-3.40). The table (distance, abstract, full, diff,
+allowed, pass) is printed and written to --out. The exit code is non-zero
+when any distance is outside the allowed deviation.
+"""
+import argparse
+import csv
+import glob
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+DEFAULT_DISTANCES = "100,500,1000,2000,5000,10000,15000,20000,30000,40000,50000,60000"
+
+
+def find_binary():
+    ns3 = Path(os.environ.get("NS3_DIR", Path.home() / "ns-allinone-3.40" / "ns-3.40"))
+    hits = sorted(glob.glob(str(ns3 / "build" / "scratch" / "*Lab4_Cpp_LTE-*")) +
+                  glob.glob(str(ns3 / "build" / "scratch" / "*Lab4_Cpp_LTE")))
+    hits = [h for h in hits if os.access(h, os.X_OK)]
+    if not hits:
+        sys.exit(f"Lab4_Cpp_LTE not found under {ns3}/build/scratch; build it or pass --bin")
+    return hits[-1]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--distances", default=DEFAULT_DISTANCES)
+    ap.add_argument("--dataRate", default="40Mbps")
+    ap.add_argument("--bin", default=None)
+    ap.add_argument("--rtol", type=float, default=0.15)
+    ap.add_argument("--atol", type=float, default=0.5, help="Mb/s")
+    ap.add_argument("--out", default="lte_abstraction_check.csv")
+    ap.add_argument("extra", nargs="*", help="flags passed to both engines (after --)")
+    opt = ap.parse_args()
+
+    binary = opt.bin or find_binary()
+    raw = Path("lte_abstraction_runs.csv")
+    if raw.exists():
+        raw.unlink()
+    distances = [float(x) for x in opt.distances.split(",") if x]
+    for d in distances:
+        for engine in ("abstract", "full"):
+            subprocess.run([binary, f"--engine={engine}", f"--distance={d}",
+                            f"--dataRate={opt.dataRate}", "--traces=none",
+                            f"--csv={raw}"] + opt.extra,
+                           check=True, stdout=subprocess.DEVNULL)
+
+    got = {}
+    with open(raw) as fh:
+        for r in csv.DictReader(fh):
+            engine = "abstract" if r["status"] == "abstract" else "full"
+            got[(float(r["distance_m"]), engine)] = float(r["throughput_bps"]) / 1e6
+
+    rows = []
+    print(f"{'distance_m':>10} {'abstract':>9} {'full':>9} {'diff':>8} {'allowed':>8}  pass")
+    for d in distances:
+        a, f = got[(d, "abstract")], got[(d, "full")]
+        diff = a - f
+        allowed = max(opt.rtol * f, opt.atol)
+        ok = abs(diff) <= allowed
+        rows.append({"distance_m": d, "abstract_Mbps": a, "full_Mbps": f, "diff_Mbps": diff,
+                     "allowed_Mbps": allowed, "pass": int(ok)})
+        print(f"{d:10.0f} {a:9.3f} {f:9.3f} {diff:8.3f} {allowed:8.3f}  {'yes' if ok else 'NO'}")
+
+    with open(opt.out, "w", newline="") as fh:
+        w = csv.DictWriter(fh, fieldnames=list(rows[0].keys()))
+        w.writeheader()
+        w.writerows(rows)
+    print(f"CSV written: {opt.out}")
+    if not all(row["pass"] for row in rows):
+        sys.exit("abstract goodput is outside the allowed deviation at some distances")
+
+
+if __name__ == "__main__":
+    main()
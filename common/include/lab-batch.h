@@ -0,0 +1,510 @@
+/*
+ * Shared helper — batch runner for parameter sweeps (NumPy in, NumPy out)
+ * -------------------------------------------------------------
+ * The Lab*_Py_*.py drivers build one scenario per process through cppyy, one
+ * attribute call at a time, and a sweep then parses the printed throughput
+ * back out of stdout. LabBatch runs a whole table of cases from C++ instead:
+ *
+ *   params : rows x P doubles, row-major, one row per case (e.g. a NumPy array)
+ *   out    : rows x O doubles, written in place (NaN for a case that failed)
+ *   status : rows int32, kRowDone or kRowFailed
+ *
+ * A kernel turns one parameter row into one output row. It builds its
+ * scenario with the same helpers and object order as the lab program it
+ * mirrors, so a row gives the numbers the program prints for that case.
+ * Built-in kernels:
+ *
+ *   lab1-link  model (0 Friis, 1 TwoRay, 2 Cost231, 3 Nakagami), distance_m,
+ *              ant_height_m, seed  ->  rx_bytes, throughput_bps
+ *              (Lab1_Cpp_<Model>, without NetAnim/pcap; the programs use
+ *              ant_height_m = 1.5 and seed = 1)
+ *   lab2-bss   rate_mbps, seed, rts_cts  ->  rx_bytes, goodput_bps
+ *              (Lab2_Cpp_Scenario1, without NetAnim)
+ *
+ * LabBatch::Register() adds more (e.g. from a cppyy.cppdef block).
+ *
+ * Workers: ns-3 keeps its simulator, node list and RNG state in globals, so
+ * cases cannot run on threads (lab-thread-pool.h is for pure computation).
+ * Run() forks 'workers' processes instead. They take rows from a shared
+ * counter, write their outputs into one MAP_SHARED block and reset the
+ * simulator before their first row and after every row, the way lab-host
+ * does between scenarios. Every row therefore matches a fresh process with the
+ * same flags, regardless of which worker ran it or what the caller (e.g. a
+ * notebook) configured beforehand. The parent copies the block into 'out'
+ * once. A worker that aborts (NS_FATAL_ERROR) fails only the row it was
+ * running; the rows it had not reached are handed to a new round of workers.
+ * The caller's own ns-3 state is never touched. workers = 0 runs the rows in
+ * the calling process instead, and resets ITS state the same way.
+ *
+ * From Python (common/scripts/lab_batch.py):
+ *   from lab_batch import run_batch
+ *   res = run_batch("lab1-link", {"model": 0, "distance_m": np.arange(10, 400, 10),
+ *                                 "ant_height_m": 1.5, "seed": 1})
+ *   res["throughput_bps"]   # numpy array, one entry per row
+ *
+ * Linux/POSIX only (fork, mmap).
+ */
+
+#ifndef LAB_BATCH_H
+#define LAB_BATCH_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/flow-monitor-module.h"
+
+#include "lab-scenario.h" // typed rates, BSS builder, saturating OnOff
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+class LabBatch
+{
+public:
+  // One parameter row in, one output row out.
+  using Kernel = void (*)(const double* params, double* out);
+
+  enum RowStatus : int32_t
+  {
+    kRowDone = 0,
+    kRowFailed = 1, // exception, or the worker died on this row
+    kRowPending = 2,
+    kRowRunning = 3,
+  };
+
+  static void Register(const std::string& name, const std::vector<std::string>& params,
+                       const std::vector<std::string>& outputs, Kernel fn)
+  {
+    for (Entry& e : Registry())
+    {
+      if (e.name == name)
+      {
+        e = Entry{name, params, outputs, fn};
+        return;
+      }
+    }
+    Registry().push_back(Entry{name, params, outputs, fn});
+  }
+
+  static std::vector<std::string> Kernels()
+  {
+    std::vector<std::string> names;
+    for (const Entry& e : Registry())
+    {
+      names.push_back(e.name);
+    }
+    return names;
+  }
+
+  // Column names, in the order Run() expects / writes them (empty if unknown).
+  static std::vector<std::string> Params(const std::string& kernel)
+  {
+    const Entry* e = Find(kernel);
+    return e ? e->params : std::vector<std::string>();
+  }
+  static std::vector<std::string> Outputs(const std::string& kernel)
+  {
+    const Entry* e = Find(kernel);
+    return e ? e->outputs : std::vector<std::string>();
+  }
+
+  // Runs 'rows' cases; returns the number of failed rows, or -1 if the kernel
+  // is unknown or no worker could be started.
+  static int64_t Run(const std::string& kernel, const double* params, uint64_t rows, double* out,
+                     int32_t* status, uint32_t workers)
+  {
+    const Entry* e = Find(kernel);
+    if (e == nullptr)
+    {
+      return -1;
+    }
+    const size_t nIn = e->params.size();
+    const size_t nOut = e->outputs.size();
+    if (workers == 0)
+    {
+      return RunRows(*e, params, rows, out, status);
+    }
+
+    // Shared block: [next-row counter][rows * nOut outputs][rows statuses]
+    const size_t outBytes = rows * nOut * sizeof(double);
+    const size_t bytes = sizeof(Shared) + outBytes + rows * sizeof(int32_t);
+    void* mem = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+      return -1;
+    }
+    Shared* shared = new (mem) Shared();
+    double* sOut = reinterpret_cast<double*>(static_cast<char*>(mem) + sizeof(Shared));
+    int32_t* sStatus = reinterpret_cast<int32_t*>(static_cast<char*>(mem) + sizeof(Shared) + outBytes);
+    std::fill(sOut, sOut + rows * nOut, std::numeric_limits<double>::quiet_NaN());
+    std::fill(sStatus, sStatus + rows, int32_t(kRowPending));
+
+    // Buffered output would be written once more by every worker.
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    bool ok = true;
+    for (;;)
+    {
+      std::vector<uint64_t> todo;
+      for (uint64_t r = 0; r < rows; ++r)
+      {
+        if (sStatus[r] == kRowPending)
+        {
+          todo.push_back(r);
+        }
+      }
+      if (todo.empty())
+      {
+        break;
+      }
+      shared->next.store(0);
+      const uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(workers, todo.size()));
+      std::vector<pid_t> pids;
+      for (uint32_t w = 0; w < n; ++w)
+      {
+        const pid_t pid = ::fork();
+        if (pid == 0)
+        {
+          // The caller's Config defaults, node list or stream index must not
+          // leak into the first row.
+          ResetSimulationState();
+          for (uint64_t i; (i = shared->next.fetch_add(1)) < todo.size();)
+          {
+            const uint64_t r = todo[i];
+            sStatus[r] = kRowRunning;
+            sStatus[r] = RunRow(*e, params + r * nIn, sOut + r * nOut);
+            ResetSimulationState();
+          }
+          ::_exit(0); // no atexit handlers or static destructors of the caller
+        }
+        if (pid > 0)
+        {
+          pids.push_back(pid);
+        }
+      }
+      if (pids.empty())
+      {
+        ok = false;
+        break;
+      }
+      for (pid_t pid : pids)
+      {
+        int ws = 0;
+        while (::waitpid(pid, &ws, 0) < 0 && errno == EINTR)
+        {
+        }
+      }
+      // A worker that died leaves its current row "running".
+      for (uint64_t r : todo)
+      {
+        if (sStatus[r] == kRowRunning)
+        {
+          sStatus[r] = kRowFailed;
+          std::fill(sOut + r * nOut, sOut + (r + 1) * nOut, std::numeric_limits<double>::quiet_NaN());
+        }
+      }
+    }
+
+    std::memcpy(out, sOut, outBytes);
+    std::memcpy(status, sStatus, rows * sizeof(int32_t));
+    shared->~Shared();
+    ::munmap(mem, bytes);
+    return ok ? Failed(status, rows) : -1;
+  }
+
+  // What a fresh process would see (the same steps as lab-host between scenarios).
+  static void ResetSimulationState()
+  {
+    Simulator::Destroy();
+    Config::Reset();
+    RngSeedManager::ResetNextStreamIndex();
+    Names::Clear();
+    Ipv4AddressGenerator::Reset();
+    Ipv6AddressGenerator::Reset();
+  }
+
+private:
+  struct Entry
+  {
+    std::string name;
+    std::vector<std::string> params;
+    std::vector<std::string> outputs;
+    Kernel fn;
+  };
+
+  struct Shared
+  {
+    std::atomic<uint64_t> next{0};
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "the row counter is shared between processes");
+
+  static std::vector<Entry>& Registry();
+
+  static const Entry* Find(const std::string& name)
+  {
+    for (const Entry& e : Registry())
+    {
+      if (e.name == name)
+      {
+        return &e;
+      }
+    }
+    return nullptr;
+  }
+
+  static int32_t RunRow(const Entry& e, const double* in, double* out)
+  {
+    try
+    {
+      e.fn(in, out);
+      return kRowDone;
+    }
+    catch (const std::exception& ex)
+    {
+      std::cerr << "ERROR: " << e.name << ": " << ex.what() << "\n";
+      std::fill(out, out + e.outputs.size(), std::numeric_limits<double>::quiet_NaN());
+      return kRowFailed;
+    }
+    catch (...)
+    {
+      std::fill(out, out + e.outputs.size(), std::numeric_limits<double>::quiet_NaN());
+      return kRowFailed;
+    }
+  }
+
+  static int64_t RunRows(const Entry& e, const double* params, uint64_t rows, double* out,
+                         int32_t* status)
+  {
+    ResetSimulationState();
+    for (uint64_t r = 0; r < rows; ++r)
+    {
+      status[r] = RunRow(e, params + r * e.params.size(), out + r * e.outputs.size());
+      ResetSimulationState();
+    }
+    return Failed(status, rows);
+  }
+
+  static int64_t Failed(const int32_t* status, uint64_t rows)
+  {
+    return std::count_if(status, status + rows, [](int32_t s) { return s != kRowDone; });
+  }
+};
+
+// ---------- Built-in kernels ----------
+
+// Lab1_Cpp_{Friis,TwoRay,Cost231,Nakagami}: one 802.11a ad-hoc link at 6 Mb/s.
+inline void
+LabBatchLab1Link(const double* in, double* out)
+{
+  const int model = static_cast<int>(in[0]);
+  const double distance = in[1];
+  const double antHeight = in[2];
+  NS_ABORT_MSG_IF(model < 0 || model > 3, "lab1-link: model must be 0..3");
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(static_cast<uint64_t>(in[3]));
+  Time::SetResolution(Time::NS);
+
+  NodeContainer nodes;
+  nodes.Create(2);
+
+  YansWifiChannelHelper channel;
+  channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+  double txPower = 23.0;
+  switch (model)
+  {
+  case 0:
+    channel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.18e9));
+    break;
+  case 1:
+    channel.AddPropagationLoss("ns3::TwoRayGroundPropagationLossModel",
+                               "Frequency",   DoubleValue(5.18e9),
+                               "MinDistance", DoubleValue(1.0));
+    break;
+  case 2:
+    channel.AddPropagationLoss("ns3::Cost231PropagationLossModel",
+                               "Frequency",       DoubleValue(1.8e9),
+                               "BSAntennaHeight", DoubleValue(15.0),
+                               "SSAntennaHeight", DoubleValue(1.5),
+                               "MinDistance",     DoubleValue(0.5));
+    txPower = 27.0;
+    break;
+  default:
+    channel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.18e9));
+    channel.AddPropagationLoss("ns3::NakagamiPropagationLossModel",
+                               "m0", DoubleValue(1.0),
+                               "m1", DoubleValue(1.0),
+                               "m2", DoubleValue(1.0));
+    break;
+  }
+
+  YansWifiPhyHelper phy;
+  phy.SetChannel(channel.Create());
+  phy.Set("TxPowerStart",   DoubleValue(txPower));
+  phy.Set("TxPowerEnd",     DoubleValue(txPower));
+  phy.Set("RxSensitivity",  DoubleValue(-92.0));
+  phy.Set("CcaEdThreshold", DoubleValue(-92.0));
+
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_STANDARD_80211a);
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                               "DataMode",    StringValue("OfdmRate6Mbps"),
+                               "ControlMode", StringValue("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType("ns3::AdhocWifiMac");
+  NetDeviceContainer devs = wifi.Install(phy, mac, nodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> pos = CreateObject<ListPositionAllocator>();
+  pos->Add(Vector(0.0, 0.0, antHeight));
+  pos->Add(Vector(distance, 0.0, antHeight));
+  mobility.SetPositionAllocator(pos);
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  mobility.Install(nodes);
+
+  // Same subnet per model as the programs.
+  static const char* const kBase[] = {"10.1.1.0", "10.1.2.0", "10.1.3.0", "10.1.4.0"};
+  InternetStackHelper stack;
+  stack.Install(nodes);
+  Ipv4AddressHelper addr;
+  addr.SetBase(kBase[model], "255.255.255.0");
+  Ipv4InterfaceContainer ifaces = addr.Assign(devs);
+
+  // Attribute strings, as in the Lab 1 programs: they create their random
+  // variables in this order, and a different count would shift the streams.
+  OnOffHelper on("ns3::UdpSocketFactory", InetSocketAddress(ifaces.GetAddress(1), 9));
+  on.SetAttribute("DataRate", StringValue("6Mbps"));
+  on.SetAttribute("PacketSize", UintegerValue(1000));
+  on.SetAttribute("OnTime",  StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+  on.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+  ApplicationContainer tx = on.Install(nodes.Get(0));
+  tx.Start(Seconds(1.0));
+  tx.Stop(Seconds(10.0));
+
+  PacketSinkHelper sink("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 9));
+  ApplicationContainer rx = sink.Install(nodes.Get(1));
+  rx.Start(Seconds(0.0));
+  rx.Stop(Seconds(10.0));
+
+  FlowMonitorHelper fm;
+  Ptr<FlowMonitor> monitor = fm.InstallAll();
+
+  Simulator::Stop(Seconds(10.0));
+  Simulator::Run();
+  monitor->CheckForLostPackets();
+  uint64_t rxBytes = 0;
+  for (const auto& kv : monitor->GetFlowStats())
+  {
+    rxBytes += kv.second.rxBytes;
+  }
+  out[0] = static_cast<double>(rxBytes);
+  out[1] = rxBytes * 8.0 / 9.0;
+}
+
+// Lab2_Cpp_Scenario1: STA -> AP -> STA, 802.11b, saturating UDP.
+inline void
+LabBatchLab2Bss(const double* in, double* out)
+{
+  const LabRate phyRate = DsssRateAtLeast(in[0]);
+  if (in[2] != 0.0)
+  {
+    Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(0));
+  }
+  RngSeedManager::SetSeed(1);
+  RngSeedManager::SetRun(static_cast<uint64_t>(in[1]));
+  Time::SetResolution(Time::NS);
+
+  NodeContainer staNodes;
+  staNodes.Create(2);
+  NodeContainer apNode;
+  apNode.Create(1);
+
+  LabWifiBss<LabStandard::k80211b> bss("lab2-ssid");
+  bss.Rates(phyRate, phyRate);
+  NetDeviceContainer staDevs = bss.InstallSta(staNodes);
+  NetDeviceContainer apDev = bss.InstallAp(apNode);
+
+  // Equilateral triangle, side 10 m.
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> pos = CreateObject<ListPositionAllocator>();
+  const double side = 10.0;
+  const double h = side * std::sqrt(3.0) / 2.0;
+  pos->Add(Vector(0.0, 0.0, 0.0));
+  pos->Add(Vector(-side / 2.0, h, 0.0));
+  pos->Add(Vector(side / 2.0, h, 0.0));
+  mobility.SetPositionAllocator(pos);
+  mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  mobility.Install(apNode);
+  mobility.Install(staNodes);
+
+  InternetStackHelper stack;
+  stack.Install(apNode);
+  stack.Install(staNodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer staIfaces = ipv4.Assign(staDevs);
+  ipv4.Assign(apDev);
+
+  OnOffHelper onoff = SaturatingOnOff(InetSocketAddress(staIfaces.GetAddress(1), 9),
+                                      DataRate(100000000), 1000);
+  ApplicationContainer client = onoff.Install(staNodes.Get(0));
+  client.Start(Seconds(1.0));
+  client.Stop(Seconds(10.0));
+
+  PacketSinkHelper sink("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 9));
+  ApplicationContainer server = sink.Install(staNodes.Get(1));
+  server.Start(Seconds(0.0));
+  server.Stop(Seconds(10.0));
+
+  FlowMonitorHelper fmHelper;
+  Ptr<FlowMonitor> monitor = fmHelper.InstallAll();
+
+  Simulator::Stop(Seconds(10.0));
+  Simulator::Run();
+  monitor->CheckForLostPackets();
+  uint64_t rxBytes = 0;
+  for (const auto& kv : monitor->GetFlowStats())
+  {
+    rxBytes += kv.second.rxBytes;
+  }
+  out[0] = static_cast<double>(rxBytes);
+  out[1] = rxBytes * 8.0 / 9.0;
+}
+
+inline std::vector<LabBatch::Entry>&
+LabBatch::Registry()
+{
+  static std::vector<Entry> entries = {
+    {"lab1-link", {"model", "distance_m", "ant_height_m", "seed"}, {"rx_bytes", "throughput_bps"},
+     &LabBatchLab1Link},
+    {"lab2-bss", {"rate_mbps", "seed", "rts_cts"}, {"rx_bytes", "goodput_bps"}, &LabBatchLab2Bss},
+  };
+  return entries;
+}
+
+} // namespace ns3
+
+#endif // LAB_BATCH_H
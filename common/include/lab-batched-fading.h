@@ -0,0 +1,340 @@
+/*
+ * Shared helper — Nakagami-m fading with per-link, block-generated variates
+ * -------------------------------------------------------------
+ * NakagamiPropagationLossModel draws one Gamma(m, P/m) variate per
+ * reception through ns-3's RandomVariableStream. An integer m goes through
+ * ErlangRandomVariable (m exponentials, each a virtual GetValue() on the
+ * MRG32k3a stream); any other m goes through GammaRandomVariable (rejection
+ * with normals). It then converts the result back to dBm with a log10.
+ *
+ * BatchedNakagamiPropagationLossModel returns the same distribution with the
+ * same attributes (Distance1/2, m0/m1/m2). It keeps one generator per
+ * directed link (tx node, rx node) and fills blocks of BlockSize fading gains,
+ * already in dB. A reception is then one table read and one add:
+ *
+ *   - uniforms  : xoshiro256** with four independent interleaved lanes, so
+ *                 consecutive updates do not wait on each other (the output
+ *                 multiplies are 64-bit, so this is scalar code, not SIMD);
+ *   - m = 1     : Rayleigh power is Exp(1): g = -ln(U), one log per variate;
+ *   - integer m : Erlang(m)/m = -ln(U1 * ... * Um)/m, still one log per
+ *                 variate (m <= 8 here; larger m goes through Gamma);
+ *   - other m   : Marsaglia-Tsang Gamma(m) from block Box-Muller normals
+ *                 (m < 1 via Gamma(m + 1) * U^(1/m));
+ *   - output    : 10 log10(g) for the whole block, so the hot path has no
+ *                 transcendental calls.
+ *
+ * All of the block loops call scalar std::log/sqrt/cos/sin/pow/log10, one
+ * value at a time. Any gain over ns-3's model (measure it with
+ * Lab1_Cpp_Nakagami --benchDraws) comes from fewer virtual RandomVariableStream
+ * calls and from moving the log10 off the per-reception path, not from vector
+ * instructions.
+ *
+ * Reproducibility: each link's generator is seeded from (RngSeedManager seed,
+ * run, AssignStreams() stream, tx node id, rx node id). Its draws do not
+ * depend on how receptions of other links interleave with it, so adding a node
+ * or reordering events does not change the fading of an existing link. The
+ * variates are Nakagami-m like ns-3's, but not the same numbers: a run with
+ * this model is a different (equally valid) realisation than with ns-3's.
+ *
+ *   channel.AddPropagationLoss("ns3::BatchedNakagamiPropagationLossModel",
+ *                              "m0", DoubleValue(1.0), "m1", DoubleValue(1.0),
+ *                              "m2", DoubleValue(1.0));
+ */
+
+#ifndef LAB_BATCHED_FADING_H
+#define LAB_BATCHED_FADING_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------- Pure generator (no ns-3 objects) ----------
+class FadingBlockGenerator
+{
+public:
+  static constexpr int kLanes = 4;
+  static constexpr uint32_t kMaxErlang = 8;
+
+  explicit FadingBlockGenerator(uint64_t seed = 1)
+  {
+    uint64_t z = seed;
+    for (int l = 0; l < kLanes; ++l)
+    {
+      m_s0[l] = SplitMix64(z);
+      m_s1[l] = SplitMix64(z);
+      m_s2[l] = SplitMix64(z);
+      m_s3[l] = SplitMix64(z);
+    }
+  }
+
+  static uint64_t SplitMix64(uint64_t& x)
+  {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // n uniforms in (0, 1); n is rounded up to a multiple of kLanes internally.
+  void Uniforms(double* out, size_t n)
+  {
+    size_t i = 0;
+    while (i < n)
+    {
+      uint64_t r[kLanes];
+      for (int l = 0; l < kLanes; ++l) // lanes are independent of each other
+      {
+        r[l] = Rotl(m_s1[l] * 5, 7) * 9;
+        const uint64_t t = m_s1[l] << 17;
+        m_s2[l] ^= m_s0[l];
+        m_s3[l] ^= m_s1[l];
+        m_s1[l] ^= m_s2[l];
+        m_s0[l] ^= m_s3[l];
+        m_s2[l] ^= t;
+        m_s3[l] = Rotl(m_s3[l], 45);
+      }
+      for (int l = 0; l < kLanes && i < n; ++l, ++i)
+      {
+        out[i] = ((r[l] >> 11) + 0.5) * 0x1.0p-53; // never 0 or 1
+      }
+    }
+  }
+
+  // n unit-mean Gamma(m, 1/m) power gains, in dB.
+  void FillDb(double m, double* out, size_t n)
+  {
+    const uint32_t k = static_cast<uint32_t>(m);
+    if (static_cast<double>(k) == m && k >= 1 && k <= kMaxErlang)
+    {
+      FillErlangDb(k, out, n);
+    }
+    else
+    {
+      FillGammaDb(m, out, n);
+    }
+  }
+
+private:
+  static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  void FillErlangDb(uint32_t k, double* out, size_t n)
+  {
+    m_u.resize(n * k);
+    Uniforms(m_u.data(), n * k);
+    const double* u = m_u.data();
+    const double invK = 1.0 / k;
+    for (size_t i = 0; i < n; ++i)
+    {
+      double p = u[i];
+      for (uint32_t j = 1; j < k; ++j)
+      {
+        p *= u[j * n + i];
+      }
+      out[i] = -std::log(p) * invK;
+    }
+    ToDb(out, n);
+  }
+
+  void FillGammaDb(double m, double* out, size_t n)
+  {
+    const bool boost = m < 1.0; // Gamma(m) = Gamma(m + 1) * U^(1/m)
+    const double a = boost ? m + 1.0 : m;
+    const double d = a - 1.0 / 3.0;
+    const double c = 1.0 / std::sqrt(9.0 * d);
+    size_t filled = 0;
+    while (filled < n)
+    {
+      // One block of normals (Box-Muller pairs) and uniforms per pass
+      const size_t half = (n - filled) / 2 + 4;
+      const size_t want = 2 * half;
+      m_u.resize(2 * want);
+      Uniforms(m_u.data(), 2 * want);
+      const double* u1 = m_u.data();
+      const double* u2 = u1 + half;
+      const double* u3 = u2 + half;
+      m_x.resize(want);
+      for (size_t i = 0; i < half; ++i)
+      {
+        const double r = std::sqrt(-2.0 * std::log(u1[i]));
+        const double t = 2 * M_PI * u2[i];
+        m_x[2 * i] = r * std::cos(t);
+        m_x[2 * i + 1] = r * std::sin(t);
+      }
+      for (size_t i = 0; i < want && filled < n; ++i)
+      {
+        const double x = m_x[i];
+        double v = 1.0 + c * x;
+        if (v <= 0.0)
+        {
+          continue;
+        }
+        v = v * v * v;
+        if (std::log(u3[i]) < 0.5 * x * x + d - d * v + d * std::log(v))
+        {
+          out[filled++] = d * v;
+        }
+      }
+    }
+    if (boost)
+    {
+      m_u.resize(n);
+      Uniforms(m_u.data(), n);
+      const double invM = 1.0 / m;
+      for (size_t i = 0; i < n; ++i)
+      {
+        out[i] *= std::pow(m_u[i], invM);
+      }
+    }
+    const double invM = 1.0 / m;
+    for (size_t i = 0; i < n; ++i)
+    {
+      out[i] *= invM;
+    }
+    ToDb(out, n);
+  }
+
+  static void ToDb(double* v, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      v[i] = 10.0 * std::log10(v[i]);
+    }
+  }
+
+  uint64_t m_s0[kLanes], m_s1[kLanes], m_s2[kLanes], m_s3[kLanes];
+  std::vector<double> m_u, m_x; // scratch, reused across blocks
+};
+
+// ---------- ns-3 PropagationLossModel front end ----------
+class BatchedNakagamiPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+        TypeId("ns3::BatchedNakagamiPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<BatchedNakagamiPropagationLossModel>()
+            .AddAttribute("Distance1", "Beginning of the second distance field (m).",
+                          DoubleValue(80.0),
+                          MakeDoubleAccessor(&BatchedNakagamiPropagationLossModel::m_distance1),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Distance2", "Beginning of the third distance field (m).",
+                          DoubleValue(200.0),
+                          MakeDoubleAccessor(&BatchedNakagamiPropagationLossModel::m_distance2),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("m0", "m0 for distances smaller than Distance1.",
+                          DoubleValue(1.5),
+                          MakeDoubleAccessor(&BatchedNakagamiPropagationLossModel::m_m0),
+                          MakeDoubleChecker<double>(0.5))
+            .AddAttribute("m1", "m1 for distances smaller than Distance2.",
+                          DoubleValue(0.75),
+                          MakeDoubleAccessor(&BatchedNakagamiPropagationLossModel::m_m1),
+                          MakeDoubleChecker<double>(0.5))
+            .AddAttribute("m2", "m2 for distances greater than Distance2.",
+                          DoubleValue(0.75),
+                          MakeDoubleAccessor(&BatchedNakagamiPropagationLossModel::m_m2),
+                          MakeDoubleChecker<double>(0.5))
+            .AddAttribute("BlockSize", "Fading gains generated per link and refill.",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&BatchedNakagamiPropagationLossModel::m_block),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+  }
+
+  size_t GetLinks() const { return m_links.size(); }
+
+private:
+  struct Band
+  {
+    std::vector<double> db;
+    uint32_t next{0};
+  };
+
+  struct Link
+  {
+    explicit Link(uint64_t seed) : gen(seed) {}
+    FadingBlockGenerator gen;
+    Band band[3];
+  };
+
+  double DoCalcRxPower(double txPowerDbm, Ptr<MobilityModel> a,
+                       Ptr<MobilityModel> b) const override
+  {
+    const double d = a->GetDistanceFrom(b);
+    const int k = (d < m_distance1) ? 0 : (d < m_distance2) ? 1 : 2;
+    Link& link = GetLink(a, b);
+    Band& band = link.band[k];
+    if (band.next == band.db.size())
+    {
+      band.db.resize(m_block);
+      link.gen.FillDb(k == 0 ? m_m0 : k == 1 ? m_m1 : m_m2, band.db.data(), m_block);
+      band.next = 0;
+    }
+    return txPowerDbm + band.db[band.next++];
+  }
+
+  int64_t DoAssignStreams(int64_t stream) override
+  {
+    m_stream = stream;
+    m_links.clear();
+    return 1;
+  }
+
+  Link& GetLink(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    const uint64_t key = (uint64_t(NodeId(a)) << 32) | NodeId(b);
+    auto it = m_links.find(key);
+    if (it == m_links.end())
+    {
+      uint64_t x = (uint64_t(RngSeedManager::GetSeed()) << 32) ^ RngSeedManager::GetRun();
+      x = FadingBlockGenerator::SplitMix64(x) ^ uint64_t(m_stream);
+      x = FadingBlockGenerator::SplitMix64(x) ^ key;
+      it = m_links.emplace(key, Link(FadingBlockGenerator::SplitMix64(x))).first;
+    }
+    return it->second;
+  }
+
+  // Node id of the mobility model's node; models without a node get ids from
+  // the top of the range in order of first use.
+  uint32_t NodeId(const Ptr<MobilityModel>& m) const
+  {
+    Ptr<Node> n = m->GetObject<Node>();
+    if (n)
+    {
+      return n->GetId();
+    }
+    auto it = m_anon.find(PeekPointer(m));
+    if (it == m_anon.end())
+    {
+      it = m_anon.emplace(PeekPointer(m), 0xFFFFFFFFu - uint32_t(m_anon.size())).first;
+    }
+    return it->second;
+  }
+
+  double m_distance1{80.0};
+  double m_distance2{200.0};
+  double m_m0{1.5};
+  double m_m1{0.75};
+  double m_m2{0.75};
+  uint32_t m_block{64};
+  int64_t m_stream{0};
+  mutable std::unordered_map<uint64_t, Link> m_links;
+  mutable std::unordered_map<const MobilityModel*, uint32_t> m_anon;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(BatchedNakagamiPropagationLossModel);
+
+} // namespace ns3
+
+#endif // LAB_BATCHED_FADING_H
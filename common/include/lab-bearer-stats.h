@@ -0,0 +1,351 @@
+/*
+ * Shared helper — in-memory PDCP/RLC bearer statistics with binary output
+ * -------------------------------------------------------------
+ * LteHelper::EnablePdcpTraces()/EnableRlcTraces() write DlPdcpStats.txt,
+ * UlPdcpStats.txt, DlRlcStats.txt and UlRlcStats.txt: one text line per
+ * bearer per epoch, flushed as the run goes. With hundreds of UEs the writes
+ * (and later the Python re-parse) dominate.
+ *
+ * BearerStatsCollector hooks the same trace sources the LTE helper's
+ * RadioBearerStatsConnector uses:
+ *
+ *   UE  : .../LteUeRrc/DataRadioBearerMap/ * /{LtePdcp,LteRlc}/{TxPDU,RxPDU}
+ *   eNB : .../LteEnbRrc/UeMap/<rnti>/DataRadioBearerMap/ * /{LtePdcp,LteRlc}/{TxPDU,RxPDU}
+ *
+ * It connects them when the RRC reports ConnectionReconfiguration, because
+ * bearers only exist after setup. Per (IMSI, LCID, layer, direction) it keeps
+ * PDU and byte counters for TX and RX, and a QuantileSketch
+ * (lab-quantile-sketch.h, 1 % relative accuracy) of the RX delay. A trace
+ * callback is a map look-up and a few increments. Nothing is written until
+ * Write().
+ *
+ * Output: one row per bearer, layer and direction (per epoch if SetEpoch() is
+ * used) in a ColumnarTable (lab-columnar.h), written as a .labcol file:
+ *   t_start_s, t_end_s, imsi, cell_id, rnti, lcid, layer (0 = PDCP, 1 = RLC),
+ *   dir (0 = DL, 1 = UL), tx_pdus, tx_bytes, rx_pdus, rx_bytes,
+ *   delay_mean_us, delay_p50_us, delay_p95_us, delay_p99_us, delay_max_us
+ * Read it with common/scripts/labcol.py.
+ *
+ * Data radio bearers only (SRBs are left out, as in the text traces' usual use).
+ *
+ * Usage:
+ *   BearerStatsCollector stats;
+ *   stats.SetEpoch(Seconds(0.25));        // optional; default = whole run
+ *   stats.Start(Seconds(appStart));       // counts from appStart on
+ *   Simulator::Run();
+ *   stats.Finish();
+ *   stats.Report(std::cout);
+ *   stats.Write("LteBearerStats.labcol");
+ */
+
+#ifndef LAB_BEARER_STATS_H
+#define LAB_BEARER_STATS_H
+
+#include "ns3/core-module.h"
+
+#include "lab-columnar.h"
+#include "lab-quantile-sketch.h"
+
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace ns3
+{
+
+class BearerStatsCollector
+{
+public:
+  enum Layer : uint8_t
+  {
+    PDCP = 0,
+    RLC = 1
+  };
+
+  enum Dir : uint8_t
+  {
+    DL = 0,
+    UL = 1
+  };
+
+  explicit BearerStatsCollector(double relAccuracy = 0.01)
+    : m_alpha(relAccuracy)
+  {
+  }
+
+  // Epoch length for the output rows (zero = one row per bearer for the whole run).
+  void SetEpoch(Time epoch) { m_epoch = epoch; }
+
+  // Connect the RRC hooks now; count PDUs from 'from' on.
+  void Start(Time from = Seconds(0))
+  {
+    m_from = from;
+    m_epochStart = from;
+    Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionReconfiguration",
+                    MakeCallback(&BearerStatsCollector::OnUeReconfiguration, this));
+    Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/ConnectionReconfiguration",
+                    MakeCallback(&BearerStatsCollector::OnEnbReconfiguration, this));
+    if (m_epoch.IsStrictlyPositive())
+    {
+      Simulator::Schedule(from + m_epoch - Simulator::Now(), &BearerStatsCollector::EndEpoch,
+                          this);
+    }
+  }
+
+  // Close the last (partial) epoch. Call after Simulator::Run().
+  void Finish()
+  {
+    if (!m_finished)
+    {
+      Flush(Simulator::Now());
+      m_finished = true;
+    }
+  }
+
+  bool Write(const std::string& path)
+  {
+    Finish();
+    m_table.SetMeta("format", "lte-bearer-stats");
+    m_table.SetMeta("delay_rel_accuracy", std::to_string(m_alpha));
+    return m_table.Write(path);
+  }
+
+  const ColumnarTable& GetTable() const { return m_table; }
+
+  // Whole-run totals per layer/direction, merged over all bearers.
+  void Report(std::ostream& os) const
+  {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize prec = os.precision();
+    static const char* kLayer[] = {"PDCP", "RLC"};
+    static const char* kDir[] = {"DL", "UL"};
+    for (uint32_t l = 0; l < 2; ++l)
+    {
+      for (uint32_t d = 0; d < 2; ++d)
+      {
+        const Counters& c = m_totals[l][d];
+        os << std::fixed << std::setprecision(3) << "[bearers] " << kLayer[l] << " " << kDir[d]
+           << "  bearers=" << m_bearers.size() << "  tx " << c.txPdus << " PDUs / "
+           << c.txBytes << " B  rx " << c.rxPdus << " PDUs / " << c.rxBytes << " B"
+           << "  delay mean=" << c.delayNs.GetMean() / 1e6
+           << " ms p50=" << c.delayNs.Quantile(0.5) / 1e6
+           << " p99=" << c.delayNs.Quantile(0.99) / 1e6 << " ms\n";
+      }
+    }
+    os.flags(flags);
+    os.precision(prec);
+  }
+
+private:
+  struct Counters
+  {
+    explicit Counters(double alpha = 0.01)
+      : delayNs(alpha)
+    {
+    }
+
+    uint64_t txPdus{0};
+    uint64_t txBytes{0};
+    uint64_t rxPdus{0};
+    uint64_t rxBytes{0};
+    QuantileSketch delayNs;
+
+    bool Empty() const { return txPdus == 0 && rxPdus == 0; }
+    void Reset()
+    {
+      txPdus = txBytes = rxPdus = rxBytes = 0;
+      delayNs.Reset();
+    }
+  };
+
+  struct Bearer
+  {
+    explicit Bearer(double alpha)
+      : c{{Counters(alpha), Counters(alpha)}, {Counters(alpha), Counters(alpha)}}
+    {
+    }
+
+    uint16_t cellId{0};
+    uint16_t rnti{0};
+    Counters c[2][2]; // [layer][dir]
+  };
+
+  // ---- connection (same paths as the LTE helper's stats connector) ----
+  static std::string BasePath(const std::string& context)
+  {
+    return context.substr(0, context.rfind('/'));
+  }
+
+  void OnUeReconfiguration(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+  {
+    if (!m_ueSeen.insert(imsi).second)
+    {
+      return;
+    }
+    const std::string base = BasePath(context) + "/DataRadioBearerMap/*";
+    Connect(base, imsi, cellId, rnti, UL, DL); // UE transmits UL, receives DL
+  }
+
+  void OnEnbReconfiguration(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+  {
+    if (!m_enbSeen.insert(std::make_tuple(imsi, cellId, rnti)).second)
+    {
+      return;
+    }
+    const std::string base =
+        BasePath(context) + "/UeMap/" + std::to_string(rnti) + "/DataRadioBearerMap/*";
+    Connect(base, imsi, cellId, rnti, DL, UL); // eNB transmits DL, receives UL
+  }
+
+  void Connect(const std::string& base, uint64_t imsi, uint16_t cellId, uint16_t rnti,
+               Dir txDir, Dir rxDir)
+  {
+    m_cell[imsi] = std::make_pair(cellId, rnti);
+    Config::ConnectWithoutContext(base + "/LtePdcp/TxPDU",
+        MakeBoundCallback(&BearerStatsCollector::OnTx, this, imsi, uint8_t(PDCP), uint8_t(txDir)));
+    Config::ConnectWithoutContext(base + "/LtePdcp/RxPDU",
+        MakeBoundCallback(&BearerStatsCollector::OnRx, this, imsi, uint8_t(PDCP), uint8_t(rxDir)));
+    Config::ConnectWithoutContext(base + "/LteRlc/TxPDU",
+        MakeBoundCallback(&BearerStatsCollector::OnTx, this, imsi, uint8_t(RLC), uint8_t(txDir)));
+    Config::ConnectWithoutContext(base + "/LteRlc/RxPDU",
+        MakeBoundCallback(&BearerStatsCollector::OnRx, this, imsi, uint8_t(RLC), uint8_t(rxDir)));
+  }
+
+  // ---- trace sinks ----
+  Bearer& Get(uint64_t imsi, uint8_t lcid)
+  {
+    const uint64_t key = (imsi << 8) | lcid;
+    auto it = m_bearers.find(key);
+    if (it == m_bearers.end())
+    {
+      it = m_bearers.emplace(key, Bearer(m_alpha)).first;
+      const auto& cr = m_cell[imsi];
+      it->second.cellId = cr.first;
+      it->second.rnti = cr.second;
+    }
+    return it->second;
+  }
+
+  static void OnTx(BearerStatsCollector* self, uint64_t imsi, uint8_t layer, uint8_t dir,
+                   uint16_t /*rnti*/, uint8_t lcid, uint32_t size)
+  {
+    if (Simulator::Now() < self->m_from)
+    {
+      return;
+    }
+    Counters& c = self->Get(imsi, lcid).c[layer][dir];
+    c.txPdus++;
+    c.txBytes += size;
+  }
+
+  static void OnRx(BearerStatsCollector* self, uint64_t imsi, uint8_t layer, uint8_t dir,
+                   uint16_t /*rnti*/, uint8_t lcid, uint32_t size, uint64_t delayNs)
+  {
+    if (Simulator::Now() < self->m_from)
+    {
+      return;
+    }
+    Counters& c = self->Get(imsi, lcid).c[layer][dir];
+    c.rxPdus++;
+    c.rxBytes += size;
+    c.delayNs.Record(static_cast<double>(delayNs));
+  }
+
+  // ---- epochs / output ----
+  void EndEpoch()
+  {
+    Flush(Simulator::Now());
+    Simulator::Schedule(m_epoch, &BearerStatsCollector::EndEpoch, this);
+  }
+
+  void Flush(Time now)
+  {
+    if (m_table.GetRows() == 0 && m_cols.empty())
+    {
+      DefineColumns();
+    }
+    for (auto& kv : m_bearers)
+    {
+      Bearer& b = kv.second;
+      for (uint32_t l = 0; l < 2; ++l)
+      {
+        for (uint32_t d = 0; d < 2; ++d)
+        {
+          Counters& c = b.c[l][d];
+          if (c.Empty())
+          {
+            continue;
+          }
+          m_table.Set(m_cols[0], m_epochStart.GetSeconds());
+          m_table.Set(m_cols[1], now.GetSeconds());
+          m_table.Set(m_cols[2], uint64_t(kv.first >> 8));
+          m_table.Set(m_cols[3], uint64_t(b.cellId));
+          m_table.Set(m_cols[4], uint64_t(b.rnti));
+          m_table.Set(m_cols[5], uint64_t(kv.first & 0xff));
+          m_table.Set(m_cols[6], uint64_t(l));
+          m_table.Set(m_cols[7], uint64_t(d));
+          m_table.Set(m_cols[8], c.txPdus);
+          m_table.Set(m_cols[9], c.txBytes);
+          m_table.Set(m_cols[10], c.rxPdus);
+          m_table.Set(m_cols[11], c.rxBytes);
+          m_table.Set(m_cols[12], c.delayNs.GetMean() / 1e3);
+          m_table.Set(m_cols[13], c.delayNs.Quantile(0.50) / 1e3);
+          m_table.Set(m_cols[14], c.delayNs.Quantile(0.95) / 1e3);
+          m_table.Set(m_cols[15], c.delayNs.Quantile(0.99) / 1e3);
+          m_table.Set(m_cols[16], c.delayNs.GetMax() / 1e3);
+          m_table.EndRow();
+
+          Counters& t = m_totals[l][d];
+          t.txPdus += c.txPdus;
+          t.txBytes += c.txBytes;
+          t.rxPdus += c.rxPdus;
+          t.rxBytes += c.rxBytes;
+          t.delayNs.Merge(c.delayNs);
+          c.Reset();
+        }
+      }
+    }
+    m_epochStart = now;
+  }
+
+  void DefineColumns()
+  {
+    const std::pair<const char*, ColumnarTable::Type> defs[] = {
+        {"t_start_s", ColumnarTable::F64},    {"t_end_s", ColumnarTable::F64},
+        {"imsi", ColumnarTable::U64},         {"cell_id", ColumnarTable::U32},
+        {"rnti", ColumnarTable::U32},         {"lcid", ColumnarTable::U32},
+        {"layer", ColumnarTable::U32},        {"dir", ColumnarTable::U32},
+        {"tx_pdus", ColumnarTable::U64},      {"tx_bytes", ColumnarTable::U64},
+        {"rx_pdus", ColumnarTable::U64},      {"rx_bytes", ColumnarTable::U64},
+        {"delay_mean_us", ColumnarTable::F64}, {"delay_p50_us", ColumnarTable::F64},
+        {"delay_p95_us", ColumnarTable::F64}, {"delay_p99_us", ColumnarTable::F64},
+        {"delay_max_us", ColumnarTable::F64}};
+    for (const auto& d : defs)
+    {
+      m_cols.push_back(m_table.AddColumn(d.first, d.second));
+    }
+  }
+
+  double m_alpha;
+  Time   m_epoch{Seconds(0)};
+  Time   m_from{Seconds(0)};
+  Time   m_epochStart{Seconds(0)};
+  bool   m_finished{false};
+
+  std::set<uint64_t> m_ueSeen;
+  std::set<std::tuple<uint64_t, uint16_t, uint16_t>> m_enbSeen;
+  std::map<uint64_t, std::pair<uint16_t, uint16_t>> m_cell; // imsi → (cellId, rnti)
+  std::map<uint64_t, Bearer> m_bearers;                     // (imsi << 8 | lcid)
+  Counters m_totals[2][2]{{Counters(m_alpha), Counters(m_alpha)},
+                          {Counters(m_alpha), Counters(m_alpha)}};
+
+  ColumnarTable m_table;
+  std::vector<uint32_t> m_cols;
+};
+
+} // namespace ns3
+
+#endif // LAB_BEARER_STATS_H
@@ -0,0 +1,195 @@
+/*
+ * Shared helper — Bianchi's saturation model of the 802.11 DCF
+ * -------------------------------------------------------------
+ * G. Bianchi, "Performance Analysis of the IEEE 802.11 Distributed
+ * Coordination Function", IEEE JSAC 18(3), 2000. This is the model for N
+ * saturated stations in one collision domain with ideal channel conditions.
+ * Each station transmits in a slot with probability tau. A transmission
+ * collides with probability p = 1 - (1 - tau)^(N-1), and tau solves the
+ * backoff Markov chain
+ *
+ *   tau = 2 (1 - 2p) / ((1 - 2p)(W + 1) + p W (1 - (2p)^m)),
+ *
+ * where W = CWmin + 1 and 2^m W = CWmax + 1. The fixed point is found by
+ * bisection on p (the code uses an equivalent form without the 0/0 at
+ * p = 1/2). Saturation throughput is payload bits per mean slot:
+ *
+ *   S = Ps Ptr E[P] / ((1 - Ptr) sigma + Ptr Ps Ts + Ptr (1 - Ps) Tc)
+ *
+ * Ts and Tc are the busy times of a success and of a collision. They are
+ * built from ns-3's own DSSS timings: 192 us long preamble + PLCP header,
+ * payload at the data rate rounded up to whole microseconds, and ACK/CTS at
+ * the control rate. As in ns-3, stations that saw a collision defer EIFS
+ * (SIFS + ACK at the lowest basic rate + DIFS), so Tc uses EIFS in place of
+ * DIFS. E[P] is the application payload. The MAC/LLC/IP/UDP headers (64 bytes
+ * for UDP over IPv4) count as overhead.
+ *
+ *   DcfParameters prm = DcfParameters::Dsss(11.0, 1000, false);
+ *   DcfPrediction r = BianchiSaturation(prm, 2);
+ *   r.throughputBps;     // all stations together
+ *   r.perStationBps;     // S / N, DCF's long-run fair share
+ *   r.p;                 // conditional collision probability
+ *
+ * In an infrastructure BSS every STA-to-STA packet crosses the air twice, and
+ * the AP is one more saturated contender. With k flows, the goodput is the
+ * AP's share, S / (k + 1). ReportRelayedBss() prints that prediction.
+ * Lab2_Cpp_Scenario1/2 --bianchi print it next to the simulated value, and
+ * --analyticOnly prints it for any number of flows without simulating.
+ */
+
+#ifndef LAB_BIANCHI_H
+#define LAB_BIANCHI_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+namespace ns3
+{
+
+struct DcfParameters
+{
+  double   slotUs       = 20.0;  // 802.11b
+  double   sifsUs       = 10.0;
+  uint32_t cwMin        = 31;
+  uint32_t cwMax        = 1023;
+  double   preambleUs   = 192.0; // long DSSS preamble + PLCP header
+  double   dataMbps     = 11.0;
+  double   controlMbps  = 11.0;  // ACK / RTS / CTS
+  double   basicMbps    = 1.0;   // lowest basic rate (EIFS)
+  uint32_t payloadBytes = 1000;
+  uint32_t overheadBytes = 64;   // MAC 24 + FCS 4 + LLC/SNAP 8 + IPv4 20 + UDP 8
+  bool     rtsCts       = false;
+  double   propUs       = 0.0;
+
+  // 802.11b with the lab's setup: control frames at the data rate.
+  static DcfParameters Dsss(double dataMbps, uint32_t payloadBytes, bool rtsCts)
+  {
+    DcfParameters p;
+    p.dataMbps = dataMbps;
+    p.controlMbps = dataMbps;
+    p.payloadBytes = payloadBytes;
+    p.rtsCts = rtsCts;
+    return p;
+  }
+
+  double DifsUs() const { return sifsUs + 2.0 * slotUs; }
+
+  // Air time of a frame of 'bytes' at 'mbps' (DSSS: preamble + whole microseconds).
+  double FrameUs(uint32_t bytes, double mbps) const
+  {
+    return preambleUs + std::ceil(8.0 * bytes / mbps - 1e-9);
+  }
+
+  double EifsUs() const { return sifsUs + FrameUs(14, basicMbps) + DifsUs(); }
+};
+
+struct DcfPrediction
+{
+  uint32_t stations;
+  double   tau;            // transmission probability per slot
+  double   p;              // conditional collision probability
+  double   ptr;            // P(at least one transmission in a slot)
+  double   ps;             // P(success | transmission)
+  double   tsUs;           // busy time of a success
+  double   tcUs;           // busy time of a collision
+  double   meanSlotUs;
+  double   throughputBps;  // payload bits/s, all stations
+  double   perStationBps;  // throughputBps / stations
+};
+
+inline DcfPrediction
+BianchiSaturation(const DcfParameters& prm, uint32_t n)
+{
+  n = std::max<uint32_t>(n, 1);
+  const double w = prm.cwMin + 1.0;
+  const int m = static_cast<int>(std::lround(std::log2((prm.cwMax + 1.0) / w)));
+  // Same expression with (1 - (2p)^m) / (1 - 2p) expanded, so p = 1/2 is fine.
+  auto tauOf = [&](double p) {
+    double geo = 0.0, term = 1.0;
+    for (int k = 0; k < m; ++k)
+    {
+      geo += term;
+      term *= 2.0 * p;
+    }
+    return 2.0 / (1.0 + w + p * w * geo);
+  };
+
+  // p - (1 - (1 - tau(p))^(n-1)) increases with p: bisection on [0, 1).
+  double lo = 0.0, hi = 1.0;
+  for (int i = 0; i < 200 && n > 1; ++i)
+  {
+    const double mid = 0.5 * (lo + hi);
+    const double g = mid - (1.0 - std::pow(1.0 - tauOf(mid), n - 1.0));
+    (g > 0.0 ? hi : lo) = mid;
+  }
+  DcfPrediction r{};
+  r.stations = n;
+  r.p = (n > 1) ? 0.5 * (lo + hi) : 0.0;
+  r.tau = tauOf(r.p);
+  r.ptr = 1.0 - std::pow(1.0 - r.tau, double(n));
+  r.ps = n * r.tau * std::pow(1.0 - r.tau, n - 1.0) / r.ptr;
+
+  const double d = prm.propUs;
+  const double data = prm.FrameUs(prm.payloadBytes + prm.overheadBytes, prm.dataMbps);
+  const double ack = prm.FrameUs(14, prm.controlMbps);
+  if (prm.rtsCts)
+  {
+    const double rts = prm.FrameUs(20, prm.controlMbps);
+    const double cts = prm.FrameUs(14, prm.controlMbps);
+    r.tsUs = rts + prm.sifsUs + d + cts + prm.sifsUs + d + data + prm.sifsUs + d + ack +
+             prm.DifsUs() + d;
+    r.tcUs = rts + prm.EifsUs() + d;
+  }
+  else
+  {
+    r.tsUs = data + prm.sifsUs + d + ack + prm.DifsUs() + d;
+    r.tcUs = data + prm.EifsUs() + d;
+  }
+  r.meanSlotUs = (1.0 - r.ptr) * prm.slotUs + r.ptr * r.ps * r.tsUs + r.ptr * (1.0 - r.ps) * r.tcUs;
+  r.throughputBps = r.ps * r.ptr * 8.0 * prm.payloadBytes / (r.meanSlotUs * 1e-6);
+  r.perStationBps = r.throughputBps / n;
+  return r;
+}
+
+// Prediction for 'flows' saturated STA -> AP -> STA flows (flows + 1 contenders).
+// With simulatedBps >= 0 it also prints the simulated aggregate goodput and
+// returns false when that deviates from the prediction by more than 'tolerance'.
+inline bool
+ReportRelayedBss(std::ostream& os, const DcfParameters& prm, uint32_t flows,
+                 double simulatedBps = -1.0, double tolerance = 0.15)
+{
+  const DcfPrediction r = BianchiSaturation(prm, flows + 1);
+  const double goodput = r.perStationBps; // the AP's share carries every flow
+  const std::ios::fmtflags flags = os.flags();
+  const std::streamsize precision = os.precision();
+  os << "[Bianchi] " << flows << " flow(s), " << r.stations << " contenders, " << prm.dataMbps
+     << " Mbps" << (prm.rtsCts ? " RTS/CTS" : " basic") << std::fixed << std::setprecision(4)
+     << ": tau=" << r.tau << "  p=" << r.p
+     << std::setprecision(3) << "  air S=" << r.throughputBps / 1e6
+     << " Mbps  goodput=" << goodput / 1e6 << " Mbps (" << goodput / flows / 1e6
+     << " per flow)\n";
+  bool ok = true;
+  if (simulatedBps >= 0.0)
+  {
+    const double dev = goodput > 0.0 ? (simulatedBps - goodput) / goodput : 0.0;
+    os << std::setprecision(3) << "[Bianchi] simulated=" << simulatedBps / 1e6
+       << " Mbps  deviation=" << std::showpos << std::setprecision(1) << 100.0 * dev
+       << std::noshowpos << " %\n";
+    if (std::abs(dev) > tolerance)
+    {
+      os << std::setprecision(0) << "[Bianchi] WARNING: simulation is more than "
+         << 100.0 * tolerance << " % away from the model; check the setup (rates, load, geometry).\n";
+      ok = false;
+    }
+  }
+  os.flags(flags);
+  os.precision(precision);
+  return ok;
+}
+
+} // namespace ns3
+
+#endif // LAB_BIANCHI_H
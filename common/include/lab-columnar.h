@@ -0,0 +1,521 @@
+/*
+ * Shared helper — compact columnar binary table (.labcol)
+ * -------------------------------------------------------------
+ * The text traces of the ns-3 stats calculators are one line per epoch per
+ * bearer. A script then has to re-parse them. ColumnarTable instead keeps
+ * typed columns in memory and writes them in one go, column after column,
+ * so a reader can map each column straight into an array
+ * (common/scripts/labcol.py → pandas).
+ *
+ * File layout (little-endian):
+ *   char[8]  magic "LABCOL01"
+ *   u32      number of metadata entries, then per entry:
+ *              u16 key length, key bytes, u32 value length, value bytes
+ *   u32      number of columns C
+ *   u64      number of rows R
+ *   C times  u16 name length, name bytes, u8 type (1 = u32, 2 = u64, 3 = f64, 4 = str)
+ *   C times  R values of the column's type, packed; a str column is R u32
+ *            codes followed by its dictionary: u32 D, D times u32 length, bytes
+ *
+ * Usage:
+ *   ColumnarTable t;
+ *   const uint32_t cImsi = t.AddColumn("imsi", ColumnarTable::U64);
+ *   const uint32_t cThr  = t.AddColumn("thr_bps", ColumnarTable::F64);
+ *   t.SetMeta("program", "Lab4_Cpp_LTE");
+ *   t.Set(cImsi, imsi); t.Set(cThr, thr); t.EndRow();
+ *   t.Write("out.labcol");
+ *
+ * Set() writes into the current row. EndRow() fills any column not set in that
+ * row with 0 (or "" for a str column), so all columns always have the same
+ * length. Read() loads a file back, Append() concatenates two tables with the
+ * same columns (lab-results.h merges per-process segments with them).
+ *
+ * Schema misuse (AddColumn after the first row, a column index out of range,
+ * a string into a numeric column or a number into a str column) is a bug in
+ * the caller: it prints the reason and aborts, in optimised builds too. A
+ * value that does not fit its column (above 2^32 - 1 in a u32 column, a
+ * negative or non-finite double into an integer column) is data: Write()
+ * then returns false and writes nothing. The header stays free of ns-3, so
+ * it aborts with std::abort() rather than NS_ABORT_MSG_IF.
+ */
+
+#ifndef LAB_COLUMNAR_H
+#define LAB_COLUMNAR_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class ColumnarTable
+{
+public:
+  enum Type : uint8_t
+  {
+    U32 = 1,
+    U64 = 2,
+    F64 = 3,
+    STR = 4  // dictionary-encoded
+  };
+
+  uint32_t AddColumn(const std::string& name, Type type)
+  {
+    Require(m_rows == 0, "AddColumn after the first row");
+    m_cols.emplace_back(name, type);
+    if (type == STR)
+    {
+      m_cols.back().Code(""); // code 0 = "", the EndRow() filler
+    }
+    return static_cast<uint32_t>(m_cols.size() - 1);
+  }
+
+  void SetMeta(const std::string& key, const std::string& value)
+  {
+    for (auto& kv : m_meta)
+    {
+      if (kv.first == key)
+      {
+        kv.second = value;
+        return;
+      }
+    }
+    m_meta.emplace_back(key, value);
+  }
+
+  // Value of metadata 'key', or "" if absent.
+  std::string GetMeta(const std::string& key) const
+  {
+    for (const auto& kv : m_meta)
+    {
+      if (kv.first == key)
+      {
+        return kv.second;
+      }
+    }
+    return "";
+  }
+
+  void Reserve(uint64_t rows)
+  {
+    for (Column& c : m_cols)
+    {
+      if (c.type == F64)
+      {
+        c.f.reserve(rows);
+      }
+      else
+      {
+        c.u.reserve(rows);
+      }
+    }
+  }
+
+  void Set(uint32_t col, uint64_t v)
+  {
+    Column& c = Cell(col);
+    Require(c.type != STR, "number into a str column");
+    if (c.type == F64)
+    {
+      c.f.back() = static_cast<double>(v);
+    }
+    else
+    {
+      c.u.back() = v;
+      c.overflow = c.overflow || (c.type == U32 && v > std::numeric_limits<uint32_t>::max());
+    }
+  }
+
+  void Set(uint32_t col, double v)
+  {
+    Column& c = Cell(col);
+    Require(c.type != STR, "number into a str column");
+    if (c.type == F64)
+    {
+      c.f.back() = v;
+    }
+    else if (v >= 0.0 && v < 18446744073709551616.0) // [0, 2^64); false for NaN
+    {
+      Set(col, static_cast<uint64_t>(v));
+    }
+    else
+    {
+      c.u.back() = 0;
+      c.overflow = true;
+    }
+  }
+
+  void Set(uint32_t col, const std::string& v)
+  {
+    Column& c = Cell(col);
+    Require(c.type == STR, "string into a numeric column");
+    c.u.back() = c.Code(v);
+  }
+
+  void EndRow()
+  {
+    for (Column& c : m_cols)
+    {
+      if (!c.touched)
+      {
+        c.Grow();
+      }
+      c.touched = false;
+    }
+    ++m_rows;
+  }
+
+  uint64_t GetRows() const { return m_rows; }
+
+  // True if 'other' has the same column names and types, in the same order.
+  bool SameColumns(const ColumnarTable& other) const
+  {
+    if (m_cols.size() != other.m_cols.size())
+    {
+      return false;
+    }
+    for (size_t i = 0; i < m_cols.size(); ++i)
+    {
+      if (m_cols[i].name != other.m_cols[i].name || m_cols[i].type != other.m_cols[i].type)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Appends the rows of 'other' (same columns); str codes are re-mapped.
+  bool Append(const ColumnarTable& other)
+  {
+    if (!SameColumns(other))
+    {
+      return false;
+    }
+    for (size_t i = 0; i < m_cols.size(); ++i)
+    {
+      Column& c = m_cols[i];
+      const Column& o = other.m_cols[i];
+      c.overflow = c.overflow || o.overflow;
+      if (c.type == F64)
+      {
+        c.f.insert(c.f.end(), o.f.begin(), o.f.end());
+      }
+      else if (c.type == STR)
+      {
+        std::vector<uint64_t> remap(o.dict.size());
+        for (size_t k = 0; k < o.dict.size(); ++k)
+        {
+          remap[k] = c.Code(o.dict[k]);
+        }
+        for (uint64_t code : o.u)
+        {
+          c.u.push_back(remap[code]);
+        }
+      }
+      else
+      {
+        c.u.insert(c.u.end(), o.u.begin(), o.u.end());
+      }
+    }
+    m_rows += other.m_rows;
+    return true;
+  }
+
+  // False, without touching 'path', if a value or a length does not fit the
+  // file format; false too if the file cannot be written.
+  bool Write(const std::string& path) const
+  {
+    if (!Fits())
+    {
+      return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+      return false;
+    }
+    out.write("LABCOL01", 8);
+    Put<uint32_t>(out, static_cast<uint32_t>(m_meta.size()));
+    for (const auto& kv : m_meta)
+    {
+      Put<uint16_t>(out, static_cast<uint16_t>(kv.first.size()));
+      out.write(kv.first.data(), kv.first.size());
+      Put<uint32_t>(out, static_cast<uint32_t>(kv.second.size()));
+      out.write(kv.second.data(), kv.second.size());
+    }
+    Put<uint32_t>(out, static_cast<uint32_t>(m_cols.size()));
+    Put<uint64_t>(out, m_rows);
+    for (const Column& c : m_cols)
+    {
+      Put<uint16_t>(out, static_cast<uint16_t>(c.name.size()));
+      out.write(c.name.data(), c.name.size());
+      Put<uint8_t>(out, c.type);
+    }
+    for (const Column& c : m_cols)
+    {
+      if (c.type == F64)
+      {
+        out.write(reinterpret_cast<const char*>(c.f.data()), c.f.size() * sizeof(double));
+      }
+      else if (c.type == U64)
+      {
+        out.write(reinterpret_cast<const char*>(c.u.data()), c.u.size() * sizeof(uint64_t));
+      }
+      else
+      {
+        std::vector<uint32_t> narrow(c.u.begin(), c.u.end());
+        out.write(reinterpret_cast<const char*>(narrow.data()), narrow.size() * sizeof(uint32_t));
+      }
+      if (c.type == STR)
+      {
+        Put<uint32_t>(out, static_cast<uint32_t>(c.dict.size()));
+        for (const std::string& v : c.dict)
+        {
+          Put<uint32_t>(out, static_cast<uint32_t>(v.size()));
+          out.write(v.data(), v.size());
+        }
+      }
+    }
+    return out.good();
+  }
+
+  // Loads a file written by Write(). Returns false (and leaves 'out' empty) if
+  // it cannot be read or is not a complete LABCOL01 table.
+  static bool Read(const std::string& path, ColumnarTable& out)
+  {
+    out = ColumnarTable();
+    std::ifstream in(path, std::ios::binary);
+    const std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Cursor cur{buf, 8};
+    if (buf.compare(0, 8, "LABCOL01") != 0)
+    {
+      return false;
+    }
+    ColumnarTable t;
+    uint32_t nMeta = 0;
+    cur.Get(nMeta);
+    for (uint32_t i = 0; i < nMeta && cur.ok; ++i)
+    {
+      const std::string k = cur.Str<uint16_t>();
+      const std::string v = cur.Str<uint32_t>();
+      t.m_meta.emplace_back(k, v);
+    }
+    uint32_t nCols = 0;
+    uint64_t nRows = 0;
+    cur.Get(nCols);
+    cur.Get(nRows);
+    for (uint32_t i = 0; i < nCols && cur.ok; ++i)
+    {
+      const std::string name = cur.Str<uint16_t>();
+      uint8_t type = 0;
+      cur.Get(type);
+      if (type < U32 || type > STR)
+      {
+        return false;
+      }
+      t.m_cols.emplace_back(name, static_cast<Type>(type));
+    }
+    if (!cur.ok || nRows > buf.size())
+    {
+      return false;
+    }
+    for (Column& c : t.m_cols)
+    {
+      if (c.type == F64)
+      {
+        c.f.resize(nRows);
+        cur.Raw(c.f.data(), nRows * sizeof(double));
+      }
+      else if (c.type == U64)
+      {
+        c.u.resize(nRows);
+        cur.Raw(c.u.data(), nRows * sizeof(uint64_t));
+      }
+      else
+      {
+        std::vector<uint32_t> narrow(nRows);
+        cur.Raw(narrow.data(), nRows * sizeof(uint32_t));
+        c.u.assign(narrow.begin(), narrow.end());
+      }
+      if (c.type == STR)
+      {
+        uint32_t nDict = 0;
+        cur.Get(nDict);
+        for (uint32_t k = 0; k < nDict && cur.ok; ++k)
+        {
+          c.Code(cur.Str<uint32_t>());
+        }
+        for (uint64_t code : c.u)
+        {
+          cur.ok = cur.ok && code < c.dict.size();
+        }
+      }
+    }
+    if (!cur.ok)
+    {
+      return false;
+    }
+    t.m_rows = nRows;
+    out = std::move(t);
+    return true;
+  }
+
+private:
+  // Aborts with 'what' unless 'ok'.
+  static void Require(bool ok, const char* what)
+  {
+    if (!ok)
+    {
+      std::cerr << "ColumnarTable: " << what << std::endl;
+      std::abort();
+    }
+  }
+
+  // Every value and length fits the width the file stores it in.
+  bool Fits() const
+  {
+    const uint64_t u16 = std::numeric_limits<uint16_t>::max();
+    const uint64_t u32 = std::numeric_limits<uint32_t>::max();
+    if (m_cols.size() > u32 || m_meta.size() > u32)
+    {
+      return false;
+    }
+    for (const auto& kv : m_meta)
+    {
+      if (kv.first.size() > u16 || kv.second.size() > u32)
+      {
+        return false;
+      }
+    }
+    for (const Column& c : m_cols)
+    {
+      if (c.overflow || c.name.size() > u16 || c.dict.size() > u32)
+      {
+        return false;
+      }
+      for (const std::string& v : c.dict)
+      {
+        if (v.size() > u32)
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  struct Column
+  {
+    Column(const std::string& n, Type t)
+      : name(n),
+        type(t)
+    {
+    }
+
+    std::string name;
+    Type type;
+    std::vector<uint64_t> u;   // U32 / U64 / STR codes
+    std::vector<double> f;     // F64
+    bool touched{false};
+    bool overflow{false};      // a value did not fit the column's type
+    std::vector<std::string> dict;                    // STR: code -> value
+    std::unordered_map<std::string, uint32_t> index;  // STR: value -> code
+
+    uint32_t Code(const std::string& v)
+    {
+      auto it = index.find(v);
+      if (it != index.end())
+      {
+        return it->second;
+      }
+      const uint32_t code = static_cast<uint32_t>(dict.size());
+      dict.push_back(v);
+      index.emplace(v, code);
+      return code;
+    }
+
+    void Grow()
+    {
+      if (type == F64)
+      {
+        f.push_back(0.0);
+      }
+      else
+      {
+        u.push_back(0);
+      }
+    }
+  };
+
+  // The current (unfinished) row of column 'col'.
+  Column& Cell(uint32_t col)
+  {
+    Require(col < m_cols.size(), "column index out of range");
+    Column& c = m_cols[col];
+    if (!c.touched)
+    {
+      c.Grow();
+      c.touched = true;
+    }
+    return c;
+  }
+
+  template <typename T>
+  static void Put(std::ofstream& out, T v)
+  {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+  }
+
+  // Bounds-checked reader over a whole file; 'ok' turns false on truncation.
+  struct Cursor
+  {
+    const std::string& buf;
+    size_t pos;
+    bool ok{true};
+
+    void Raw(void* dst, size_t n)
+    {
+      ok = ok && n <= buf.size() - pos;
+      if (ok)
+      {
+        std::memcpy(dst, buf.data() + pos, n);
+        pos += n;
+      }
+    }
+    template <typename T>
+    void Get(T& v)
+    {
+      Raw(&v, sizeof(T));
+    }
+    template <typename L>
+    std::string Str()
+    {
+      L n = 0;
+      Get(n);
+      ok = ok && n <= buf.size() - pos;
+      if (!ok)
+      {
+        return "";
+      }
+      pos += n;
+      return buf.substr(pos - n, n);
+    }
+  };
+
+  std::vector<Column> m_cols;
+  std::vector<std::pair<std::string, std::string>> m_meta;
+  uint64_t m_rows{0};
+};
+
+} // namespace ns3
+
+#endif // LAB_COLUMNAR_H
@@ -0,0 +1,381 @@
+/*
+ * Shared helper — CountingSink: per-flow counters + latency histograms
+ * -------------------------------------------------------------
+ * A drop-in replacement for PacketSink when you also want DELAY numbers
+ * without paying for FlowMonitor:
+ *
+ *  - Per-flow (per sender address:port) byte/packet counters.
+ *  - A fixed-memory HDR-style latency histogram per flow (lab-latency-histogram.h)
+ *    → p50 / p99 / p99.9 / max one-way delay.
+ *  - RFC 3550 interarrival jitter per flow.
+ *  - Goodput per 1 s bucket, preallocated (attribute MaxSeconds).
+ *  - No per-packet maps: a flow is looked up in a short vector, and a packet
+ *    costs one histogram increment plus a few additions.
+ *
+ * Where does the send time come from?
+ *   LatencyTag is an 8-byte ByteTag holding the transmit time. LatencyTagger
+ *   stamps it on every packet a SOURCE node originates, from the
+ *   Ipv4L3Protocol "SendOutgoing" trace. That trace fires before the IP layer
+ *   copies the packet, so the tag survives the copy. It also survives Wi-Fi
+ *   forwarding and LTE PDCP/RLC segmentation, because byte tags follow the
+ *   bytes. (Tagging from OnOffApplication's "Tx" trace would be too late: that
+ *   trace fires after the socket has already copied the packet.)
+ *   For TCP the stamp is the transmit time of the (last) IP segment carrying
+ *   the first received byte, i.e. network delay, not socket-buffer wait.
+ *
+ * Usage:
+ *   CountingSinkHelper sinkH("ns3::UdpSocketFactory",
+ *                            InetSocketAddress(Ipv4Address::GetAny(), port));
+ *   ApplicationContainer sinkApp = sinkH.Install(dstNode);
+ *   LatencyTagger::Install(srcNode);
+ *   ...
+ *   GetSinkTotalRx(sinkApp.Get(0));             // works for PacketSink too
+ *   DynamicCast<CountingSink>(sinkApp.Get(0))->Report(std::cout, appStart);
+ */
+
+#ifndef LAB_COUNTING_SINK_H
+#define LAB_COUNTING_SINK_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+
+#include "lab-latency-histogram.h"
+
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------- compact timestamp tag (8 bytes) ----------
+
+class LatencyTag : public Tag
+{
+public:
+  LatencyTag() = default;
+
+  explicit LatencyTag(Time tx)
+    : m_txNs(tx.GetNanoSeconds())
+  {
+  }
+
+  static TypeId GetTypeId()
+  {
+    static TypeId tid = TypeId("ns3::LatencyTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<LatencyTag>();
+    return tid;
+  }
+
+  TypeId GetInstanceTypeId() const override { return GetTypeId(); }
+  uint32_t GetSerializedSize() const override { return 8; }
+  void Serialize(TagBuffer i) const override { i.WriteU64(static_cast<uint64_t>(m_txNs)); }
+  void Deserialize(TagBuffer i) override { m_txNs = static_cast<int64_t>(i.ReadU64()); }
+  void Print(std::ostream& os) const override { os << "tx=" << m_txNs << "ns"; }
+
+  int64_t GetTxNs() const { return m_txNs; }
+
+private:
+  int64_t m_txNs{0};
+};
+
+// ---------- source-side stamping ----------
+
+class LatencyTagger
+{
+public:
+  static void Install(Ptr<Node> node)
+  {
+    Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+    NS_ABORT_MSG_IF(!ipv4, "LatencyTagger: install the Internet stack first");
+    ipv4->TraceConnectWithoutContext("SendOutgoing", MakeCallback(&LatencyTagger::Stamp));
+  }
+
+  static void Install(const NodeContainer& nodes)
+  {
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+      Install(nodes.Get(i));
+    }
+  }
+
+private:
+  static void Stamp(const Ipv4Header& /*hdr*/, Ptr<const Packet> p, uint32_t /*iface*/)
+  {
+    LatencyTag tag;
+    if (!p->FindFirstMatchingByteTag(tag))
+    {
+      p->AddByteTag(LatencyTag(Simulator::Now()));
+    }
+  }
+};
+
+// ---------- the sink application ----------
+
+class CountingSink : public Application
+{
+public:
+  struct FlowStats
+  {
+    Address  peer;
+    uint64_t rxBytes{0};
+    uint64_t rxPackets{0};
+    uint64_t stamped{0};          // packets that carried a LatencyTag
+    LatencyHistogram delayNs;
+    double   jitterNs{0.0};       // RFC 3550 running estimate
+    int64_t  lastDelayNs{-1};
+    std::vector<uint64_t> bytesPerSecond;
+  };
+
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+        TypeId("ns3::CountingSink")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<CountingSink>()
+            .AddAttribute("Local",
+                          "The Address on which to Bind the rx socket.",
+                          AddressValue(),
+                          MakeAddressAccessor(&CountingSink::m_local),
+                          MakeAddressChecker())
+            .AddAttribute("Protocol",
+                          "The type id of the protocol to use for the rx socket.",
+                          TypeIdValue(UdpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&CountingSink::m_tid),
+                          MakeTypeIdChecker())
+            .AddAttribute("MaxSeconds",
+                          "Number of 1 s goodput buckets preallocated per flow.",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&CountingSink::m_maxSeconds),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("Rx",
+                            "A packet has been received",
+                            MakeTraceSourceAccessor(&CountingSink::m_rxTrace),
+                            "ns3::Packet::AddressTracedCallback");
+    return tid;
+  }
+
+  uint64_t GetTotalRx() const { return m_totalRx; }
+  const std::vector<FlowStats>& GetFlows() const { return m_flows; }
+
+  // Latency over ALL flows of this sink.
+  LatencyHistogram GetMergedDelay() const
+  {
+    LatencyHistogram all;
+    for (const FlowStats& f : m_flows)
+    {
+      all.Merge(f.delayNs);
+    }
+    return all;
+  }
+
+  // Human-readable per-flow summary. Goodput buckets before 'fromSecond' are
+  // skipped (typically appStart).
+  void Report(std::ostream& os, double fromSecond = 0.0) const
+  {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize prec = os.precision();
+    os << std::fixed << std::setprecision(3);
+    for (std::size_t k = 0; k < m_flows.size(); ++k)
+    {
+      const FlowStats& f = m_flows[k];
+      os << "Sink flow " << k << "  from " << InetSocketAddress::ConvertFrom(f.peer).GetIpv4()
+         << ":" << InetSocketAddress::ConvertFrom(f.peer).GetPort()
+         << " | rxBytes=" << f.rxBytes << " | rxPackets=" << f.rxPackets << "\n";
+      if (f.stamped > 0)
+      {
+        os << "    delay ms: p50=" << f.delayNs.Quantile(0.50) / 1e6
+           << "  p99=" << f.delayNs.Quantile(0.99) / 1e6
+           << "  p99.9=" << f.delayNs.Quantile(0.999) / 1e6
+           << "  max=" << f.delayNs.GetMax() / 1e6
+           << "  mean=" << f.delayNs.GetMean() / 1e6
+           << "  jitter=" << f.jitterNs / 1e6
+           << "  (" << f.stamped << " stamped)\n";
+      }
+      os << "    goodput Mb/s per second:";
+      const std::size_t first = static_cast<std::size_t>(std::max(0.0, std::floor(fromSecond)));
+      const std::size_t last = std::min<std::size_t>(
+          f.bytesPerSecond.size(),
+          static_cast<std::size_t>(std::ceil(Simulator::Now().GetSeconds())));
+      for (std::size_t s = first; s < last; ++s)
+      {
+        os << " " << s << ":" << f.bytesPerSecond[s] * 8.0 / 1e6;
+      }
+      os << "\n";
+    }
+    os.flags(flags);
+    os.precision(prec);
+  }
+
+protected:
+  void DoDispose() override
+  {
+    m_socket = nullptr;
+    m_accepted.clear();
+    Application::DoDispose();
+  }
+
+private:
+  void StartApplication() override
+  {
+    if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket(GetNode(), m_tid);
+      if (m_socket->Bind(m_local) == -1)
+      {
+        NS_FATAL_ERROR("CountingSink: failed to bind socket");
+      }
+      m_socket->Listen();
+      m_socket->ShutdownSend();
+    }
+    m_socket->SetRecvCallback(MakeCallback(&CountingSink::HandleRead, this));
+    m_socket->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                MakeCallback(&CountingSink::HandleAccept, this));
+  }
+
+  void StopApplication() override
+  {
+    for (Ptr<Socket> s : m_accepted)
+    {
+      s->Close();
+    }
+    m_accepted.clear();
+    if (m_socket)
+    {
+      m_socket->Close();
+      m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+  }
+
+  void HandleAccept(Ptr<Socket> s, const Address& /*from*/)
+  {
+    s->SetRecvCallback(MakeCallback(&CountingSink::HandleRead, this));
+    m_accepted.push_back(s);
+  }
+
+  FlowStats& Lookup(const Address& from)
+  {
+    for (FlowStats& f : m_flows)
+    {
+      if (f.peer == from)
+      {
+        return f;
+      }
+    }
+    m_flows.emplace_back();
+    m_flows.back().peer = from;
+    m_flows.back().bytesPerSecond.assign(m_maxSeconds, 0);
+    return m_flows.back();
+  }
+
+  void HandleRead(Ptr<Socket> socket)
+  {
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+      const uint32_t size = packet->GetSize();
+      if (size == 0)
+      {
+        break;
+      }
+      const Time now = Simulator::Now();
+      FlowStats& f = Lookup(from);
+      f.rxBytes += size;
+      f.rxPackets++;
+      m_totalRx += size;
+
+      const std::size_t sec = static_cast<std::size_t>(now.GetSeconds());
+      f.bytesPerSecond[std::min<std::size_t>(sec, f.bytesPerSecond.size() - 1)] += size;
+
+      LatencyTag tag;
+      if (packet->FindFirstMatchingByteTag(tag))
+      {
+        const int64_t d = now.GetNanoSeconds() - tag.GetTxNs();
+        f.delayNs.Record(static_cast<uint64_t>(std::max<int64_t>(d, 0)));
+        if (f.lastDelayNs >= 0)
+        {
+          const double dd = std::fabs(static_cast<double>(d - f.lastDelayNs));
+          f.jitterNs += (dd - f.jitterNs) / 16.0;
+        }
+        f.lastDelayNs = d;
+        f.stamped++;
+      }
+      m_rxTrace(packet, from);
+    }
+  }
+
+  Ptr<Socket> m_socket;
+  std::vector<Ptr<Socket>> m_accepted;
+  Address m_local;
+  TypeId m_tid;
+  uint32_t m_maxSeconds{64};
+  uint64_t m_totalRx{0};
+  std::vector<FlowStats> m_flows;
+  TracedCallback<Ptr<const Packet>, const Address&> m_rxTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CountingSink);
+
+// ---------- helper (same shape as PacketSinkHelper) ----------
+
+class CountingSinkHelper
+{
+public:
+  CountingSinkHelper(const std::string& protocol, const Address& local)
+  {
+    m_factory.SetTypeId(CountingSink::GetTypeId());
+    m_factory.Set("Protocol", TypeIdValue(TypeId::LookupByName(protocol)));
+    m_factory.Set("Local", AddressValue(local));
+  }
+
+  void SetAttribute(const std::string& name, const AttributeValue& value)
+  {
+    m_factory.Set(name, value);
+  }
+
+  ApplicationContainer Install(Ptr<Node> node) const
+  {
+    Ptr<Application> app = m_factory.Create<Application>();
+    node->AddApplication(app);
+    return ApplicationContainer(app);
+  }
+
+  ApplicationContainer Install(const NodeContainer& nodes) const
+  {
+    ApplicationContainer apps;
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+      apps.Add(Install(nodes.Get(i)));
+    }
+    return apps;
+  }
+
+private:
+  ObjectFactory m_factory;
+};
+
+// Total received bytes for either sink type (PacketSink or CountingSink).
+inline uint64_t
+GetSinkTotalRx(Ptr<Application> app)
+{
+  if (Ptr<PacketSink> ps = DynamicCast<PacketSink>(app))
+  {
+    return ps->GetTotalRx();
+  }
+  if (Ptr<CountingSink> cs = DynamicCast<CountingSink>(app))
+  {
+    return cs->GetTotalRx();
+  }
+  return 0;
+}
+
+} // namespace ns3
+
+#endif // LAB_COUNTING_SINK_H
@@ -0,0 +1,142 @@
+/*
+ * Shared helper — LTE fast attach: short warm-up with every UE connected
+ * -------------------------------------------------------------
+ * The Lab 4 programs start traffic at a fixed time (2 s, 1 s) so that the
+ * UEs are attached and their default bearers are up before any data arrives.
+ * All UEs keep sending SRS/CQI during that idle window, so with hundreds of
+ * UEs it is a large share of a run's events.
+ *
+ * ns-3 has no way to create a UE already in RRC CONNECTED with its DRB. The
+ * attach procedure always runs. The two calls below make it as short as
+ * ns-3 allows:
+ *   - ideal RRC: RRC messages are delivered directly instead of over SRB0/1
+ *     on the air interface. This is already LteHelper's default;
+ *     ConfigureFastAttach() only pins it, so fast attach still holds if the
+ *     command line turned it off (--ns3::LteHelper::UseIdealRrc=0);
+ *   - SIB2 every 10 ms instead of 80 ms, so a UE that synchronised at t=0
+ *     can start random access almost at once (the first SIB2 is at 16 ms
+ *     either way);
+ *   - all 64 RA preambles for contention-based access, which lowers the
+ *     collision rate when every UE attaches in the same subframe (handover,
+ *     which needs dedicated preambles, is not used by the labs).
+ * The EPC side (S1-AP/S11 SAP calls, zero-delay S1-U/S5 links of
+ * PointToPointEpcHelper) is already instantaneous.
+ *
+ * Call ConfigureFastAttach(lte) BEFORE InstallEnbDevice and
+ * ConfigureFastAttachEnbs(enbDevs) after it (before Simulator::Run), and
+ * attach with LteHelper::Attach(ue, enb) or AttachToClosestEnb (no cell
+ * search). Both only touch the given helper and devices; no Config default
+ * is changed, so a later case in the same process (MultiCell sweeps) starts
+ * from ns-3's normal attach settings.
+ *
+ * AttachTracker records when each IMSI completes its first RRC Connection
+ * Reconfiguration on the eNB side. At that point the default bearer's DRB and
+ * the S1-U tunnel both exist. Traffic can start after a short, fixed budget
+ * (--attachTime) that does not grow with the UE count. Report() prints how
+ * many UEs were up in time and when the last one came up, so an
+ * under-sized budget shows up:
+ *
+ *   AttachTracker attach;
+ *   attach.Start();
+ *   ... Simulator::Run() ...
+ *   attach.Report(std::cout, ueCount, Seconds(appStart));
+ */
+
+#ifndef LAB_FAST_ATTACH_H
+#define LAB_FAST_ATTACH_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-module.h"
+
+#include <algorithm>
+#include <ostream>
+#include <unordered_map>
+
+namespace ns3
+{
+
+// Before InstallEnbDevice: ideal RRC on this helper (see above).
+inline void
+ConfigureFastAttach(Ptr<LteHelper> lte)
+{
+  lte->SetAttribute("UseIdealRrc", BooleanValue(true));
+}
+
+// After InstallEnbDevice: SIB2 period and RA preambles on each eNB's own RRC
+// and MAC. Both are read when they are used (every SIB2, every RACH config),
+// so setting them before Simulator::Run() is enough.
+inline void
+ConfigureFastAttachEnbs(const NetDeviceContainer& enbDevs)
+{
+  for (uint32_t i = 0; i < enbDevs.GetN(); ++i)
+  {
+    Ptr<LteEnbNetDevice> enb = DynamicCast<LteEnbNetDevice>(enbDevs.Get(i));
+    NS_ABORT_MSG_IF(!enb, "ConfigureFastAttachEnbs: not an LteEnbNetDevice");
+    enb->GetRrc()->SetAttribute("SystemInformationPeriodicity", TimeValue(MilliSeconds(10)));
+    for (const auto& cc : enb->GetCcMap())
+    {
+      DynamicCast<ComponentCarrierEnb>(cc.second)->GetMac()->SetAttribute("NumberOfRaPreambles",
+                                                                         UintegerValue(64));
+    }
+  }
+}
+
+class AttachTracker
+{
+public:
+  void Start()
+  {
+    Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/LteEnbRrc/ConnectionReconfiguration",
+                                  MakeCallback(&AttachTracker::OnReconfiguration, this));
+  }
+
+  uint32_t GetConnected() const { return static_cast<uint32_t>(m_upAt.size()); }
+
+  // UEs whose bearer was up at or before 'by'.
+  uint32_t GetConnectedBy(Time by) const
+  {
+    uint32_t n = 0;
+    for (const auto& kv : m_upAt)
+    {
+      n += (kv.second <= by) ? 1 : 0;
+    }
+    return n;
+  }
+
+  Time GetLastConnected() const
+  {
+    Time last = Seconds(0);
+    for (const auto& kv : m_upAt)
+    {
+      last = std::max(last, kv.second);
+    }
+    return last;
+  }
+
+  void Report(std::ostream& os, uint32_t expected, Time trafficStart) const
+  {
+    const uint32_t inTime = GetConnectedBy(trafficStart);
+    os << "[attach] " << inTime << "/" << expected << " UEs with bearers up by t="
+       << trafficStart.GetSeconds() << " s; last at t=" << GetLastConnected().GetSeconds()
+       << " s";
+    if (inTime < expected)
+    {
+      os << "  (WARNING: " << (expected - inTime)
+         << " UEs missed the traffic start; raise --attachTime)";
+    }
+    os << "\n";
+  }
+
+private:
+  void OnReconfiguration(uint64_t imsi, uint16_t /*cellId*/, uint16_t /*rnti*/)
+  {
+    m_upAt.emplace(imsi, Simulator::Now()); // keeps the first one per IMSI
+  }
+
+  std::unordered_map<uint64_t, Time> m_upAt;
+};
+
+} // namespace ns3
+
+#endif // LAB_FAST_ATTACH_H
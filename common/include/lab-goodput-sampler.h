@@ -0,0 +1,298 @@
+/*
+ * Shared helper — goodput time series with warm-up detection (MSER-5)
+ * -------------------------------------------------------------
+ * The labs compute throughput as bytes / (appStop - appStart). That average
+ * also contains the start-up transient: OLSR convergence in Lab 3, association
+ * in Lab 2, RRC attach and bearer setup in Lab 4.
+ *
+ * GoodputSampler reads a cumulative byte counter (usually the sink's
+ * GetTotalRx) every 'interval' seconds and stores the delivered bit rate of
+ * each interval in a ring buffer that is allocated once at Start(). Analyse()
+ * then applies MSER-5 (White 1997; Franklin & White 2008):
+ *
+ *   - group the samples into batches of 5 and take the batch means Z_1..Z_k;
+ *   - for each candidate truncation d <= k/2 compute
+ *         MSER(d) = sum_{j>d} (Z_j - mean_{j>d} Z)^2 / (k - d)^2 ;
+ *   - the warm-up is the d that minimises MSER(d).
+ *
+ * Its result has two parts:
+ *   steady state : the mean of the samples after the warm-up, plus a 95 %
+ *                  confidence half-width from the remaining batch means;
+ *   transient    : the length of the warm-up and its mean goodput.
+ *
+ * Optional early stop: EnableEarlyStop(relTarget) re-runs the analysis each
+ * time a batch completes. It calls Simulator::Stop() once ALL of these hold:
+ * the warm-up ends in the first half of the series, at least kMinSteadyBatches
+ * batches lie past it, and the relative CI half-width is <= relTarget.
+ * Analysis costs O(k) with running sums, so checking every batch is cheap.
+ *
+ * Usage:
+ *   GoodputSampler sampler(Seconds(0.1));
+ *   sampler.SetBytesSource([sink]() { return sink->GetTotalRx(); });
+ *   sampler.Start(Seconds(appStart), Seconds(appStop));
+ *   if (earlyStop > 0) sampler.EnableEarlyStop(earlyStop);
+ *   Simulator::Run();
+ *   GoodputSampler::Result r = sampler.Analyse();
+ *   sampler.Report(std::cout);
+ *   // Effective measurement window if the run was cut short:
+ *   const double window = sampler.GetWindowSeconds();
+ *
+ * The sampler must outlive Simulator::Run() (its events point at it).
+ */
+
+#ifndef LAB_GOODPUT_SAMPLER_H
+#define LAB_GOODPUT_SAMPLER_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+class GoodputSampler
+{
+public:
+  static constexpr uint32_t kBatch           = 5;   // MSER-5
+  static constexpr uint32_t kMinSteadyBatches = 10;  // before early stop may fire
+
+  struct Result
+  {
+    uint32_t samples{0};        // intervals analysed
+    double   warmupSeconds{0};  // detected transient length
+    double   transientBps{0};   // mean goodput during the transient
+    double   steadyBps{0};      // mean goodput after the transient
+    double   ciHalfBps{0};      // 95 % half-width of steadyBps (0 if too few batches)
+    bool     converged{false};  // warm-up found in first half + enough batches left
+  };
+
+  explicit GoodputSampler(Time interval)
+    : m_interval(interval)
+  {
+  }
+
+  void SetBytesSource(std::function<uint64_t()> bytes) { m_bytes = std::move(bytes); }
+
+  // Sample the interval ending at start+interval, start+2*interval, ... up to stop.
+  // The ring holds 'capacity' samples (default: enough for the whole window).
+  void Start(Time start, Time stop, uint32_t capacity = 0)
+  {
+    NS_ABORT_MSG_IF(!m_bytes, "GoodputSampler: SetBytesSource() first");
+    NS_ABORT_MSG_IF(m_interval.IsZero(), "GoodputSampler: interval must be > 0");
+    m_start = start;
+    m_stop = stop;
+    if (capacity == 0)
+    {
+      capacity = static_cast<uint32_t>(std::ceil((stop - start).GetSeconds() /
+                                                 m_interval.GetSeconds())) + 1;
+    }
+    m_ring.assign(capacity, 0.0);
+    m_batch.assign(capacity / kBatch + 1, 0.0);
+    m_scratch.assign(capacity / kBatch + 1, 0.0);
+    m_head = 0;
+    m_count = 0;
+    m_stoppedEarly = false;
+    Simulator::Schedule(start - Simulator::Now(), &GoodputSampler::Begin, this);
+  }
+
+  // relTarget: stop when CI half-width / steady mean <= relTarget (e.g. 0.02).
+  void EnableEarlyStop(double relTarget) { m_relTarget = relTarget; }
+
+  Result Analyse() const
+  {
+    Result r;
+    const uint32_t n = m_count;
+    const uint32_t k = n / kBatch;
+    r.samples = n;
+    if (k < 2)
+    {
+      r.steadyBps = Mean(0, n);
+      return r;
+    }
+
+    // Batch means, oldest first.
+    for (uint32_t j = 0; j < k; ++j)
+    {
+      double s = 0.0;
+      for (uint32_t i = 0; i < kBatch; ++i)
+      {
+        s += At(j * kBatch + i);
+      }
+      m_batch[j] = s / kBatch;
+    }
+
+    // Suffix sums → MSER(d) in O(k).
+    double sum = 0.0, sumSq = 0.0;
+    double best = std::numeric_limits<double>::infinity();
+    uint32_t bestD = 0;
+    std::vector<double>& mser = m_scratch;
+    for (uint32_t j = k; j-- > 0;)
+    {
+      sum += m_batch[j];
+      sumSq += m_batch[j] * m_batch[j];
+      const double m = k - j;
+      mser[j] = std::max(0.0, sumSq - sum * sum / m) / (m * m);
+    }
+    for (uint32_t d = 0; d <= k / 2; ++d)
+    {
+      if (mser[d] < best)
+      {
+        best = mser[d];
+        bestD = d;
+      }
+    }
+
+    const uint32_t cut = bestD * kBatch;
+    const uint32_t steadyBatches = k - bestD;
+    r.warmupSeconds = cut * m_interval.GetSeconds();
+    r.transientBps = cut > 0 ? Mean(0, cut) : 0.0;
+    r.steadyBps = Mean(cut, n);
+
+    if (steadyBatches >= 2)
+    {
+      double bm = 0.0, bv = 0.0;
+      for (uint32_t j = bestD; j < k; ++j)
+      {
+        bm += m_batch[j];
+      }
+      bm /= steadyBatches;
+      for (uint32_t j = bestD; j < k; ++j)
+      {
+        bv += (m_batch[j] - bm) * (m_batch[j] - bm);
+      }
+      bv /= (steadyBatches - 1);
+      r.ciHalfBps = StudentT975(steadyBatches - 1) * std::sqrt(bv / steadyBatches);
+    }
+    r.converged = bestD < k / 2 && steadyBatches >= kMinSteadyBatches;
+    return r;
+  }
+
+  // Seconds actually covered by the samples (== stop-start unless stopped early).
+  double GetWindowSeconds() const { return m_count * m_interval.GetSeconds(); }
+  bool   StoppedEarly() const { return m_stoppedEarly; }
+  Time   GetStopTime() const { return m_stopTime; }
+  uint32_t GetDropped() const { return m_dropped; }
+
+  void Report(std::ostream& os) const
+  {
+    const Result r = Analyse();
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize prec = os.precision();
+    os << std::fixed << std::setprecision(3)
+       << "[goodput] interval=" << m_interval.GetSeconds() << " s  samples=" << r.samples
+       << "  warm-up=" << r.warmupSeconds << " s (" << r.transientBps / 1e6 << " Mb/s)"
+       << "  steady=" << r.steadyBps / 1e6 << " ± " << r.ciHalfBps / 1e6 << " Mb/s"
+       << (r.converged ? "" : "  [not converged]");
+    if (m_stoppedEarly)
+    {
+      os << "  early stop @ " << m_stopTime.GetSeconds() << " s";
+    }
+    if (m_dropped > 0)
+    {
+      os << "  (ring dropped " << m_dropped << " oldest)";
+    }
+    os << "\n";
+    os.flags(flags);
+    os.precision(prec);
+  }
+
+private:
+  void Begin()
+  {
+    m_lastBytes = m_bytes();
+    m_event = Simulator::Schedule(m_interval, &GoodputSampler::Sample, this);
+  }
+
+  void Sample()
+  {
+    const uint64_t now = m_bytes();
+    const double bps = (now - m_lastBytes) * 8.0 / m_interval.GetSeconds();
+    m_lastBytes = now;
+
+    const uint32_t cap = static_cast<uint32_t>(m_ring.size());
+    m_ring[(m_head + m_count) % cap] = bps;
+    if (m_count < cap)
+    {
+      ++m_count;
+    }
+    else
+    {
+      m_head = (m_head + 1) % cap;
+      ++m_dropped;
+    }
+
+    if (m_relTarget > 0.0 && m_count % kBatch == 0)
+    {
+      const Result r = Analyse();
+      if (r.converged && r.steadyBps > 0.0 && r.ciHalfBps <= m_relTarget * r.steadyBps)
+      {
+        m_stoppedEarly = true;
+        m_stopTime = Simulator::Now();
+        Simulator::Stop();
+        return;
+      }
+    }
+    if (Simulator::Now() + m_interval <= m_stop)
+    {
+      m_event = Simulator::Schedule(m_interval, &GoodputSampler::Sample, this);
+    }
+  }
+
+  double At(uint32_t i) const { return m_ring[(m_head + i) % m_ring.size()]; }
+
+  double Mean(uint32_t from, uint32_t to) const
+  {
+    if (to <= from)
+    {
+      return 0.0;
+    }
+    double s = 0.0;
+    for (uint32_t i = from; i < to; ++i)
+    {
+      s += At(i);
+    }
+    return s / (to - from);
+  }
+
+  // Two-sided 95 % Student-t quantile.
+  static double StudentT975(uint32_t dof)
+  {
+    static const double t[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                               2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                               2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                               2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    if (dof == 0)
+    {
+      return 0.0;
+    }
+    return dof <= 30 ? t[dof - 1] : 1.960;
+  }
+
+  Time m_interval;
+  Time m_start;
+  Time m_stop;
+  std::function<uint64_t()> m_bytes;
+  uint64_t m_lastBytes{0};
+  EventId m_event;
+
+  std::vector<double> m_ring;            // bit rate per interval
+  uint32_t m_head{0};
+  uint32_t m_count{0};
+  uint32_t m_dropped{0};
+  mutable std::vector<double> m_batch;   // preallocated batch means
+  mutable std::vector<double> m_scratch; // MSER(d), reused across calls
+
+  double m_relTarget{0.0};
+  bool   m_stoppedEarly{false};
+  Time   m_stopTime;
+};
+
+} // namespace ns3
+
+#endif // LAB_GOODPUT_SAMPLER_H
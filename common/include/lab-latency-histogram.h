@@ -0,0 +1,160 @@
+/*
+ * Shared helper — fixed-memory, HDR-style latency histogram
+ * -------------------------------------------------------------
+ * Records non-negative integer samples (we use nanoseconds) into log-linear
+ * buckets, the same layout HdrHistogram uses:
+ *
+ *   - values below 128 are counted exactly (one bucket per value);
+ *   - above that, every power of two [2^k, 2^(k+1)) is split into 64 linear
+ *     sub-buckets, so any reported value is within 1/64 (~1.6 %) of the true one.
+ *
+ * Memory is fixed at construction (2304 counters = 18 KiB, covering up to
+ * 2^41 ns ≈ 36 min); recording is a couple of shifts and an increment, with no
+ * allocation and no per-sample storage. Larger values are clamped into the top
+ * bucket and counted in GetClamped().
+ *
+ * Quantiles return the HIGHEST value equivalent to the bucket (conservative,
+ * like HdrHistogram's ValueAtPercentile), clamped to the observed maximum.
+ * Min, max and mean are exact.
+ */
+
+#ifndef LAB_LATENCY_HISTOGRAM_H
+#define LAB_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3
+{
+
+class LatencyHistogram
+{
+public:
+  static constexpr uint32_t kLinearBits = 7;                 // exact below 128
+  static constexpr uint32_t kSubBits    = kLinearBits - 1;   // 64 sub-buckets
+  static constexpr uint32_t kMaxMsb     = 40;                // 2^41 - 1 ns max
+  static constexpr uint32_t kBuckets =
+      (1u << kLinearBits) + (kMaxMsb - kLinearBits + 1) * (1u << kSubBits);
+
+  LatencyHistogram()
+    : m_counts(kBuckets, 0)
+  {
+  }
+
+  void Record(uint64_t v)
+  {
+    if (v >= (uint64_t(2) << kMaxMsb))
+    {
+      v = (uint64_t(2) << kMaxMsb) - 1;
+      ++m_clamped;
+    }
+    ++m_counts[Index(v)];
+    ++m_total;
+    m_sum += static_cast<double>(v);
+    m_min = std::min(m_min, v);
+    m_max = std::max(m_max, v);
+  }
+
+  void Merge(const LatencyHistogram& o)
+  {
+    for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+      m_counts[i] += o.m_counts[i];
+    }
+    m_total += o.m_total;
+    m_clamped += o.m_clamped;
+    m_sum += o.m_sum;
+    m_min = std::min(m_min, o.m_min);
+    m_max = std::max(m_max, o.m_max);
+  }
+
+  void Reset()
+  {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_total = 0;
+    m_clamped = 0;
+    m_sum = 0.0;
+    m_min = std::numeric_limits<uint64_t>::max();
+    m_max = 0;
+  }
+
+  // q in [0,1]; returns 0 on an empty histogram.
+  uint64_t Quantile(double q) const
+  {
+    if (m_total == 0)
+    {
+      return 0;
+    }
+    q = std::min(std::max(q, 0.0), 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * m_total)));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+      seen += m_counts[i];
+      if (seen >= rank)
+      {
+        return std::min(HighestEquivalent(i), m_max);
+      }
+    }
+    return m_max;
+  }
+
+  uint64_t GetCount() const { return m_total; }
+  uint64_t GetClamped() const { return m_clamped; }
+  uint64_t GetMin() const { return m_total ? m_min : 0; }
+  uint64_t GetMax() const { return m_max; }
+  double   GetMean() const { return m_total ? m_sum / m_total : 0.0; }
+
+  // Raw access for serialisers (bucket i covers [LowestEquivalent(i), HighestEquivalent(i)]).
+  const std::vector<uint64_t>& GetCounts() const { return m_counts; }
+
+  static uint32_t Index(uint64_t v)
+  {
+    if (v < (1u << kLinearBits))
+    {
+      return static_cast<uint32_t>(v);
+    }
+    const uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(v));
+    const uint32_t shift = msb - kSubBits;
+    const uint32_t sub = static_cast<uint32_t>(v >> shift) - (1u << kSubBits);
+    return (1u << kLinearBits) + (msb - kLinearBits) * (1u << kSubBits) + sub;
+  }
+
+  static uint64_t LowestEquivalent(uint32_t i)
+  {
+    if (i < (1u << kLinearBits))
+    {
+      return i;
+    }
+    const uint32_t j = i - (1u << kLinearBits);
+    const uint32_t msb = kLinearBits + j / (1u << kSubBits);
+    const uint64_t sub = (1u << kSubBits) + j % (1u << kSubBits);
+    return sub << (msb - kSubBits);
+  }
+
+  static uint64_t HighestEquivalent(uint32_t i)
+  {
+    if (i < (1u << kLinearBits))
+    {
+      return i;
+    }
+    const uint32_t j = i - (1u << kLinearBits);
+    const uint32_t msb = kLinearBits + j / (1u << kSubBits);
+    return LowestEquivalent(i) + (uint64_t(1) << (msb - kSubBits)) - 1;
+  }
+
+private:
+  std::vector<uint64_t> m_counts;
+  uint64_t m_total{0};
+  uint64_t m_clamped{0};
+  double   m_sum{0.0};
+  uint64_t m_min{std::numeric_limits<uint64_t>::max()};
+  uint64_t m_max{0};
+};
+
+} // namespace ns3
+
+#endif // LAB_LATENCY_HISTOGRAM_H
@@ -0,0 +1,226 @@
+/*
+ * Shared helper — fast LTE downlink link abstraction (SINR → CQI → MCS → TBS)
+ * -------------------------------------------------------------
+ * Lab4_Cpp_LTE.cc normally runs the whole EPC/PDCP/RLC/MAC/PHY stack. For a
+ * throughput-vs-distance or antenna sweep, one UE alone in one cell with a
+ * saturating downlink reaches a steady state that can be computed directly:
+ *
+ *   1. Wideband SINR. The eNB spreads TxPower evenly over the carrier, so
+ *      every RB sees the same SINR. The calculation uses the SAME ns-3
+ *      objects the full run uses:
+ *        rx   = TxPower + G_enb(angle) + G_ue(angle) - PL(d)   (AntennaModel,
+ *               PropagationLossModel at the DL carrier frequency)
+ *        N    = -174 dBm/Hz + 10 log10(nRb * 180 kHz) + UE NoiseFigure
+ *        SINR = rx - N   (single cell: no interference)
+ *   2. CQI, exactly as LteAmc::CreateCqiFeedbacks does for PiroEW2010:
+ *        s = log2(1 + SINR / Γ),  Γ = -ln(5 * BER) / 1.5,  BER = 5e-5;
+ *        CQI = the highest entry of the CQI efficiency table below s.
+ *   3. MCS from CQI, as LteAmc::GetMcsFromCqi does. The single UE gets every
+ *      RB the FF schedulers can allocate: whole RBGs only (36.213 Table
+ *      7.1.6.1-1), i.e. 16 RBGs x 3 = 48 PRBs of 50. TBS is then
+ *      LteAmc::GetDlTbSizeFromMcs(mcs, 48), the scheduler's own table.
+ *   4. Goodput = min(offered, TBS per 1 ms TTI * payload/(payload + IP/UDP +
+ *      PDCP + RLC headers)).
+ *   5. Optional (Config::errorModel = ns3 | exact | fast): the first-transmission
+ *      BLER of that TB from LteMiErrorModel (MIESM), through MiesmCache
+ *      (lab-lte-miesm.h). The PHY rate is scaled by (1 - BLER), i.e. each
+ *      failed TB costs one HARQ retransmission TTI. "none" (default) keeps
+ *      the CQI table's implicit BLER <= 10 % target.
+ *
+ * Not modelled: HARQ retransmissions (the CQI table already targets
+ * BLER <= 10 %), the attach transient, fading (none in the lab setup) and
+ * RLC buffer dynamics. Use --engine=both in the lab program to compare one
+ * point against the full stack.
+ *
+ * Cost: one Evaluate() is a pathloss call, two antenna gains and a few table
+ * look-ups, i.e. microseconds. A 500-point sweep is dominated by printing.
+ */
+
+#ifndef LAB_LTE_LINK_ABSTRACTION_H
+#define LAB_LTE_LINK_ABSTRACTION_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/antenna-module.h"
+#include "ns3/lte-module.h"
+
+#include "lab-lte-miesm.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class LteLinkAbstraction
+{
+public:
+  struct Config
+  {
+    std::string pathlossType{"ns3::FriisPropagationLossModel"}; // LteHelper default
+    std::string antennaType{"ns3::IsotropicAntennaModel"};
+    double   enbOrientationDeg{0.0};
+    double   ueOrientationDeg{0.0};
+    double   txPowerDbm{30.0};       // LteEnbPhy::TxPower default
+    double   noiseFigureDb{9.0};     // LteUePhy::NoiseFigure default
+    uint16_t dlEarfcn{100};
+    uint16_t nRb{50};
+    double   ber{0.00005};           // LteAmc::Ber default
+    uint32_t payloadBytes{1024};     // OnOff PacketSize
+    uint32_t overheadBytes{20 + 8 + 2 + 2}; // IPv4 + UDP + PDCP + RLC UM (1 SDU/PDU)
+    std::string errorModel{"none"};  // none | ns3 | exact | fast (MIESM BLER, step 5)
+    double   errorStepDb{0.25};      // SINR quantisation of errorModel=fast
+  };
+
+  struct Point
+  {
+    double   distanceM{0};
+    double   rxPowerDbm{0};
+    double   sinrDb{0};
+    int      cqi{0};
+    int      mcs{0};
+    uint32_t tbsBits{0};
+    double   bler{0};         // MIESM first-transmission BLER (errorModel != none)
+    double   phyRateBps{0};   // TBS per TTI
+    double   goodputBps{0};   // application payload, capped at the offered rate
+  };
+
+  explicit LteLinkAbstraction(const Config& c)
+    : m_cfg(c)
+  {
+    const double fc = LteSpectrumValueHelper::GetCarrierFrequency(c.dlEarfcn);
+
+    ObjectFactory lossF(c.pathlossType);
+    m_loss = lossF.Create<PropagationLossModel>();
+    m_loss->SetAttributeFailSafe("Frequency", DoubleValue(fc)); // as LteHelper does
+
+    ObjectFactory antF(c.antennaType);
+    m_enbAnt = antF.Create<AntennaModel>();
+    m_ueAnt = antF.Create<AntennaModel>();
+    m_enbAnt->SetAttributeFailSafe("Orientation", DoubleValue(c.enbOrientationDeg));
+    m_ueAnt->SetAttributeFailSafe("Orientation", DoubleValue(c.ueOrientationDeg));
+
+    m_enbMob = CreateObject<ConstantPositionMobilityModel>();
+    m_ueMob = CreateObject<ConstantPositionMobilityModel>();
+
+    m_noiseDbm = -174.0 + 10.0 * std::log10(c.nRb * 180e3) + c.noiseFigureDb;
+
+    if (c.errorModel != "none")
+    {
+      MiesmCache::Mode mode;
+      NS_ABORT_MSG_IF(!MiesmCache::ParseMode(c.errorModel, mode),
+                      "LteLinkAbstraction: errorModel must be none, ns3, exact or fast");
+      m_miesm = std::make_unique<MiesmCache>(mode, c.errorStepDb);
+      m_rbModel = LteSpectrumValueHelper::GetSpectrumModel(c.dlEarfcn, c.nRb);
+      m_allRbs.resize(AllocatablePrbs(c.nRb)); // the RBs the TB is sent on
+      std::iota(m_allRbs.begin(), m_allRbs.end(), 0);
+    }
+  }
+
+  // Not const: moves the two mobility models and fills the MIESM cache.
+  Point Evaluate(const Vector& enbPos, const Vector& uePos, double offeredBps)
+  {
+    m_enbMob->SetPosition(enbPos);
+    m_ueMob->SetPosition(uePos);
+
+    Point p;
+    p.distanceM = m_enbMob->GetDistanceFrom(m_ueMob);
+    const double gEnb = m_enbAnt->GetGainDb(Angles(uePos, enbPos));
+    const double gUe = m_ueAnt->GetGainDb(Angles(enbPos, uePos));
+    p.rxPowerDbm = m_loss->CalcRxPower(m_cfg.txPowerDbm + gEnb + gUe, m_enbMob, m_ueMob);
+    p.sinrDb = p.rxPowerDbm - m_noiseDbm;
+
+    p.cqi = CqiFromSinr(std::pow(10.0, p.sinrDb / 10.0), m_cfg.ber);
+    if (p.cqi == 0)
+    {
+      return p; // out of range: the scheduler does not allocate
+    }
+    p.mcs = McsFromCqi(p.cqi);
+    p.tbsBits = TbsBits(p.mcs, m_cfg.nRb);
+    p.phyRateBps = p.tbsBits * 1000.0;
+    if (m_miesm)
+    {
+      SpectrumValue sinr(m_rbModel);
+      sinr = std::pow(10.0, p.sinrDb / 10.0); // flat: same SINR on every RB
+      p.bler = m_miesm->GetTbDecodificationStats(sinr, m_allRbs, p.tbsBits / 8, p.mcs, {}).tbler;
+      p.phyRateBps *= 1.0 - p.bler;
+    }
+    const double eff =
+        double(m_cfg.payloadBytes) / (m_cfg.payloadBytes + m_cfg.overheadBytes);
+    p.goodputBps = std::min(offeredBps, p.phyRateBps * eff);
+    return p;
+  }
+
+  double GetNoiseDbm() const { return m_noiseDbm; }
+
+  // nullptr unless Config::errorModel != "none".
+  const MiesmCache* GetMiesm() const { return m_miesm.get(); }
+
+  // ---- the LteAmc tables (lte-amc.cc, ns-3.40) ----
+
+  static int CqiFromSinr(double sinrLinear, double ber)
+  {
+    const double s = std::log2(1.0 + sinrLinear / (-std::log(5.0 * ber) / 1.5));
+    int cqi = 0;
+    while (cqi < 15 && kCqiEfficiency[cqi + 1] < s)
+    {
+      ++cqi;
+    }
+    return cqi;
+  }
+
+  static int McsFromCqi(int cqi)
+  {
+    const double se = kCqiEfficiency[cqi];
+    int mcs = 0;
+    while (mcs < 28 && kMcsEfficiency[mcs + 1] <= se)
+    {
+      ++mcs;
+    }
+    return mcs;
+  }
+
+  // PRBs an FF scheduler hands out with type-0 allocation: whole RBGs only.
+  // RBG size as in the ns-3 schedulers (Type0AllocationRbg = {10, 26, 63, 110}).
+  static constexpr uint16_t AllocatablePrbs(uint16_t nRb)
+  {
+    const uint16_t rbg = nRb < 10 ? 1 : nRb < 26 ? 2 : nRb < 63 ? 3 : 4;
+    return nRb / rbg * rbg;
+  }
+
+  // TB size (bits) for 'mcs' over all allocatable PRBs of an nRb carrier.
+  static uint32_t TbsBits(int mcs, uint16_t nRb)
+  {
+    static const Ptr<LteAmc> amc = CreateObject<LteAmc>();
+    return static_cast<uint32_t>(amc->GetDlTbSizeFromMcs(mcs, AllocatablePrbs(nRb)));
+  }
+
+private:
+  static constexpr std::array<double, 16> kCqiEfficiency = {
+      0.0,  0.15, 0.23, 0.38, 0.6,  0.88, 1.18, 1.48,
+      1.91, 2.41, 2.73, 3.32, 3.9,  4.52, 5.12, 5.55};
+  static constexpr std::array<double, 29> kMcsEfficiency = {
+      0.15, 0.19, 0.23, 0.31, 0.38, 0.49, 0.6,  0.74, 0.88, 1.03,
+      1.18, 1.33, 1.48, 1.7,  1.91, 2.16, 2.41, 2.57, 2.73, 3.03,
+      3.32, 3.61, 3.9,  4.21, 4.52, 4.82, 5.12, 5.33, 5.55};
+
+  Config m_cfg;
+  double m_noiseDbm{0};
+  Ptr<PropagationLossModel> m_loss;
+  Ptr<AntennaModel> m_enbAnt;
+  Ptr<AntennaModel> m_ueAnt;
+  Ptr<ConstantPositionMobilityModel> m_enbMob;
+  Ptr<ConstantPositionMobilityModel> m_ueMob;
+  std::unique_ptr<MiesmCache> m_miesm;  // nullptr: errorModel none
+  Ptr<const SpectrumModel> m_rbModel;
+  std::vector<int> m_allRbs;
+};
+
+} // namespace ns3
+
+#endif // LAB_LTE_LINK_ABSTRACTION_H
@@ -0,0 +1,230 @@
+/*
+ * Shared helper — memoised MIESM (LteMiErrorModel) transport-block evaluation
+ * -------------------------------------------------------------
+ * LteMiErrorModel::GetTbDecodificationStats() maps the SINR of every allocated
+ * RB to mutual information, averages it, and looks the result up on the ECR
+ * BLER curves (one erf per code-block size). When the same SINR vector and MCS
+ * come back over and over, as in the link abstraction's distance sweeps and
+ * PhyBench's static workload, most of that work is repeated.
+ *
+ * MiesmCache returns the same TbStats_t through a hash table. The key is:
+ *
+ *   exact : MCS, TB size, the exact bits of the SINR on each allocated RB in
+ *           allocation order, and the HARQ history (MI, RV, info/code bits).
+ *           The function is pure, so a hit is bit-identical to a fresh call.
+ *   fast  : MCS, TB size, the HARQ history, and the allocated RBs' SINR
+ *           quantised to stepDb (default 0.25 dB), as a sorted list of
+ *           (level, count). MIESM averages the MI over RBs, so the order does
+ *           not matter, and a flat 50-RB allocation is one (level, 50) pair.
+ *           On a miss, ns-3 is called with every RB at its level's centre. The
+ *           result is therefore exactly the ns-3 BLER at an SINR within
+ *           stepDb/2 of the true one on every RB. Lab4_Cpp_PhyBench
+ *           --bench=miesm reports the resulting |ΔBLER|.
+ *   ns3   : no cache (reference / timing baseline).
+ *
+ * A hit costs one pass over the allocated RBs (a gather, plus one log10 per
+ * RB in fast mode), a hash and a compare. A miss costs one ns-3 call plus an
+ * insert. The table is cleared when it reaches maxEntries, which bounds memory.
+ *
+ * Scope: the full-stack data path in ns-3.40 (LteSpectrumPhy::EndRxData) calls
+ * LteMiErrorModel directly and cannot be redirected here. This cache serves
+ * only the lab code that evaluates TBs itself: Lab4_Cpp_LTE --engine=abstract
+ * --errorModel and Lab4_Cpp_PhyBench --bench=miesm. It does not make the full
+ * Lab4_Cpp_LTE, MultiCell or Sharded simulations any faster.
+ *
+ * Not implemented: a vectorised per-RB SINR -> MI mapping. The MI tables
+ * (MI_map_qpsk/16qam/64qam) and ECR curves are file-static in ns-3.40's
+ * lte-mi-error-model.cc, so the only way to evaluate a miss without copying
+ * those tables into the lab tree is LteMiErrorModel's own scalar loop, which
+ * also copies the SpectrumValue. The cache removes REPEATED evaluations only;
+ * a miss costs exactly one ns-3 call, and a workload with no repeated
+ * (SINR, MCS) states sees no gain (PhyBench's many-state case shows it).
+ */
+
+#ifndef LAB_LTE_MIESM_H
+#define LAB_LTE_MIESM_H
+
+#include "ns3/core-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/lte-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class MiesmCache
+{
+public:
+  enum Mode
+  {
+    NS3,
+    EXACT,
+    FAST
+  };
+
+  // "ns3" | "exact" | "fast"; returns false for anything else.
+  static bool ParseMode(const std::string& s, Mode& m)
+  {
+    if (s == "ns3")   { m = NS3;   return true; }
+    if (s == "exact") { m = EXACT; return true; }
+    if (s == "fast")  { m = FAST;  return true; }
+    return false;
+  }
+
+  explicit MiesmCache(Mode mode = EXACT, double stepDb = 0.25, size_t maxEntries = 1 << 16)
+    : m_mode(mode),
+      m_stepDb(stepDb),
+      m_invStep(1.0 / stepDb),
+      m_maxEntries(maxEntries)
+  {
+  }
+
+  TbStats_t GetTbDecodificationStats(const SpectrumValue& sinr, const std::vector<int>& map,
+                                     uint16_t size, uint8_t mcs,
+                                     const HarqProcessInfoList_t& history)
+  {
+    ++m_calls;
+    if (m_mode == NS3)
+    {
+      return LteMiErrorModel::GetTbDecodificationStats(sinr, map, size, mcs, history);
+    }
+
+    BuildKey(sinr, map, size, mcs, history);
+    auto it = m_table.find(m_key);
+    if (it != m_table.end())
+    {
+      ++m_hits;
+      return it->second;
+    }
+
+    TbStats_t s;
+    if (m_mode == EXACT)
+    {
+      s = LteMiErrorModel::GetTbDecodificationStats(sinr, map, size, mcs, history);
+    }
+    else
+    {
+      // Every allocated RB at the centre of its SINR level
+      SpectrumValue rep(sinr.GetSpectrumModel());
+      Values::iterator v = rep.ValuesBegin();
+      for (size_t i = 0; i < map.size(); ++i)
+      {
+        v[map[i]] = std::pow(10.0, m_levels[i] * m_stepDb / 10.0);
+      }
+      s = LteMiErrorModel::GetTbDecodificationStats(rep, map, size, mcs, history);
+    }
+    if (m_table.size() >= m_maxEntries)
+    {
+      m_table.clear();
+    }
+    m_table.emplace(m_key, s);
+    return s;
+  }
+
+  Mode     GetMode() const { return m_mode; }
+  double   GetStepDb() const { return m_stepDb; }
+  uint64_t GetCalls() const { return m_calls; }
+  uint64_t GetHits() const { return m_hits; }
+  double   GetHitRate() const { return m_calls ? double(m_hits) / m_calls : 0.0; }
+  size_t   GetEntries() const { return m_table.size(); }
+
+private:
+  using Key = std::vector<uint64_t>;
+
+  struct KeyHash
+  {
+    size_t operator()(const Key& k) const
+    {
+      uint64_t h = 1469598103934665603ULL; // FNV-1a over 64-bit words
+      for (uint64_t w : k)
+      {
+        h = (h ^ w) * 1099511628211ULL;
+      }
+      return static_cast<size_t>(h ^ (h >> 32));
+    }
+  };
+
+  static uint64_t Bits(double v)
+  {
+    uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+  }
+
+  void BuildKey(const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size,
+                uint8_t mcs, const HarqProcessInfoList_t& history)
+  {
+    const size_t n = map.size();
+    m_key.clear();
+    m_key.push_back(uint64_t(mcs) | (uint64_t(size) << 8) | (uint64_t(history.size()) << 24) |
+                    (uint64_t(n) << 32));
+    for (const HarqProcessInfoElement_t& h : history)
+    {
+      m_key.push_back(Bits(h.m_mi));
+      m_key.push_back(uint64_t(h.m_rv) | (uint64_t(h.m_infoBits) << 8) |
+                      (uint64_t(h.m_codeBits) << 24));
+    }
+
+    // Gather the allocated RBs first: one contiguous loop over doubles
+    m_gather.resize(n);
+    Values::const_iterator v = sinr.ConstValuesBegin();
+    for (size_t i = 0; i < n; ++i)
+    {
+      m_gather[i] = v[map[i]];
+    }
+    if (m_mode == EXACT)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        m_key.push_back(Bits(m_gather[i]));
+      }
+      return;
+    }
+
+    // FAST: quantised dB levels, then a sorted run-length list
+    m_levels.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double db = 10.0 * std::log10(std::max(m_gather[i], 1e-30));
+      m_levels[i] = static_cast<int32_t>(std::lround(db * m_invStep));
+    }
+    m_sorted = m_levels;
+    std::sort(m_sorted.begin(), m_sorted.end());
+    for (size_t i = 0; i < n;)
+    {
+      size_t j = i;
+      while (j < n && m_sorted[j] == m_sorted[i])
+      {
+        ++j;
+      }
+      m_key.push_back((uint64_t(uint32_t(m_sorted[i])) << 32) | uint64_t(j - i));
+      i = j;
+    }
+  }
+
+  Mode   m_mode;
+  double m_stepDb;
+  double m_invStep;
+  size_t m_maxEntries;
+  std::unordered_map<Key, TbStats_t, KeyHash> m_table;
+  uint64_t m_calls{0};
+  uint64_t m_hits{0};
+
+  // Scratch buffers, reused across calls
+  Key m_key;
+  std::vector<double>  m_gather;
+  std::vector<int32_t> m_levels;
+  std::vector<int32_t> m_sorted;
+};
+
+} // namespace ns3
+
+#endif // LAB_LTE_MIESM_H
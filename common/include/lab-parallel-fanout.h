@@ -0,0 +1,331 @@
+/*
+ * Shared helper — per-receiver loss computation spread over a thread pool
+ * -------------------------------------------------------------
+ * YansWifiChannel::Send loops over every PHY on the channel and, for each
+ * receiver, calls the propagation delay model and the loss chain, then
+ * schedules the reception. In a chain or mesh of hundreds of nodes this
+ * fan-out is O(N) per transmission, and it runs on the simulator thread.
+ *
+ * ParallelFanoutLossModel wraps the channel's loss chain. The first
+ * CalcRxPower() call of a transmission (new sender, time or tx power)
+ * computes the rx power for EVERY receiver on the channel in parallel
+ * (lab-thread-pool.h). The following calls of the same Send loop read their
+ * value from that batch. YansWifiChannel still does the delay, the
+ * scheduling and the event insertion itself, on the simulator thread and in
+ * device order. Every rx power is the inner chain's own result for the same
+ * positions, so a run is bit-identical to a serial one.
+ *
+ * Thread safety (see lab-thread-pool.h):
+ *   - ns-3 Ptr<> reference counts are not atomic. The workers only see
+ *     private ConstantPositionMobilityModel proxies: one per receiver and one
+ *     sender proxy per chunk. Their positions are copied from the real
+ *     mobility models on the simulator thread before each batch. The inner
+ *     chain is called through raw pointers, so no shared count is touched.
+ *   - Only stateless, deterministic models are run in parallel (Friis,
+ *     TwoRayGround, LogDistance, ThreeLogDistance, Range, FixedRss, Cost231,
+ *     OkumuraHata). If the chain contains anything else (Nakagami and Random
+ *     draw from RNG streams, Jakes and Matrix keep per-pair state), the wrapper
+ *     calls the chain serially, as if it were not installed.
+ *   - Channels with fewer than MinReceivers receivers are also served
+ *     serially; waking the pool costs more than it saves there.
+ *
+ * A batch is not free: the positions are copied serially on the simulator
+ * thread and the workers are woken through a condition variable. The chains
+ * above cost a few tens of ns per receiver, so that overhead can eat the gain.
+ * On the first transmission the wrapper therefore times both ways over every
+ * receiver (best of kCalibrationRounds) and keeps the fan-out only when the
+ * batch is at least MinSpeedup times faster than the serial chain. Either way
+ * the results are the same, so the choice only affects speed. The timings are
+ * available through GetSerialBatchUs()/GetParallelBatchUs(), and
+ * Lab3_Cpp_FanoutBench prints them for a range of channel sizes.
+ *
+ *   Ptr<YansWifiChannel> ch = channelHelper.Create();
+ *   InstallParallelFanout(ch, threads);        // threads 0 = all cores
+ *   phy.SetChannel(ch);
+ */
+
+#ifndef LAB_PARALLEL_FANOUT_H
+#define LAB_PARALLEL_FANOUT_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/wifi-module.h"
+
+#include "lab-thread-pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class ParallelFanoutLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+        TypeId("ns3::ParallelFanoutLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<ParallelFanoutLossModel>()
+            .AddAttribute("Threads", "Worker threads including the caller (0 = all cores).",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ParallelFanoutLossModel::m_threads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MinReceivers", "Below this many receivers the chain runs serially.",
+                          UintegerValue(32),
+                          MakeUintegerAccessor(&ParallelFanoutLossModel::m_minReceivers),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MinSpeedup",
+                          "Keep the fan-out only if a timed batch beats the serial chain "
+                          "by this factor.",
+                          DoubleValue(1.2),
+                          MakeDoubleAccessor(&ParallelFanoutLossModel::m_minSpeedup),
+                          MakeDoubleChecker<double>(0.0));
+    return tid;
+  }
+
+  // The chain being wrapped and the channel whose PHYs are the receivers.
+  void Wrap(Ptr<PropagationLossModel> inner, Ptr<YansWifiChannel> channel)
+  {
+    m_inner = inner;
+    m_channel = channel;
+    m_ready = false;
+  }
+
+  static constexpr uint32_t kCalibrationRounds = 16;
+
+  // Whether the last setup chose the parallel batch.
+  bool IsParallel() const { return m_parallel; }
+  // Best serial / parallel time for all receivers of one transmission, in us
+  // (0 when the chain or the channel size ruled out the fan-out before timing).
+  double GetSerialBatchUs() const { return m_serialUs; }
+  double GetParallelBatchUs() const { return m_parallelUs; }
+  uint64_t GetBatches() const { return m_batches; }
+  uint64_t GetServed() const { return m_served; }
+
+  static bool IsThreadSafe(Ptr<PropagationLossModel> chain)
+  {
+    static const char* safe[] = {
+        "ns3::FriisPropagationLossModel",       "ns3::TwoRayGroundPropagationLossModel",
+        "ns3::LogDistancePropagationLossModel", "ns3::ThreeLogDistancePropagationLossModel",
+        "ns3::RangePropagationLossModel",       "ns3::FixedRssLossModel",
+        "ns3::Cost231PropagationLossModel",     "ns3::OkumuraHataPropagationLossModel"};
+    for (Ptr<PropagationLossModel> m = chain; m; m = m->GetNext())
+    {
+      const std::string name = m->GetInstanceTypeId().GetName();
+      if (std::find(std::begin(safe), std::end(safe), name) == std::end(safe))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+protected:
+  void DoDispose() override
+  {
+    m_pool.reset();
+    m_inner = nullptr;
+    m_channel = nullptr;
+    m_rxMob.clear();
+    m_rxProxy.clear();
+    m_txProxy.clear();
+    PropagationLossModel::DoDispose();
+  }
+
+private:
+  double DoCalcRxPower(double txPowerDbm, Ptr<MobilityModel> a,
+                       Ptr<MobilityModel> b) const override
+  {
+    if (!m_ready)
+    {
+      Setup(txPowerDbm, a);
+    }
+    if (!m_parallel)
+    {
+      return m_inner->CalcRxPower(txPowerDbm, a, b);
+    }
+    auto it = m_index.find(PeekPointer(b));
+    if (it == m_index.end())
+    {
+      return m_inner->CalcRxPower(txPowerDbm, a, b);
+    }
+    const size_t j = it->second;
+    if (PeekPointer(a) != m_batchSender || Simulator::Now() != m_batchTime ||
+        txPowerDbm != m_batchTx || m_used[j])
+    {
+      ComputeBatch(txPowerDbm, a);
+    }
+    m_used[j] = 1;
+    ++m_served;
+    return m_rx[j];
+  }
+
+  int64_t DoAssignStreams(int64_t stream) override
+  {
+    return m_inner ? m_inner->AssignStreams(stream) : 0;
+  }
+
+  void Setup(double txPowerDbm, const Ptr<MobilityModel>& a) const
+  {
+    NS_ABORT_MSG_IF(!m_inner || !m_channel, "ParallelFanoutLossModel: call Wrap() first");
+    m_ready = true;
+    m_rxMob.clear();
+    m_index.clear();
+    for (size_t i = 0; i < m_channel->GetNDevices(); ++i)
+    {
+      Ptr<MobilityModel> mob = m_channel->GetDevice(i)->GetNode()->GetObject<MobilityModel>();
+      if (mob && m_index.emplace(PeekPointer(mob), m_rxMob.size()).second)
+      {
+        m_rxMob.push_back(mob);
+      }
+    }
+    m_parallel = IsThreadSafe(m_inner) && m_rxMob.size() >= m_minReceivers;
+    if (!m_parallel)
+    {
+      return;
+    }
+    m_pool = std::make_unique<ThreadPool>(m_threads);
+    m_parallel = m_pool->GetThreads() > 1;
+    const size_t n = m_rxMob.size();
+    m_chunks = std::min<size_t>(n, 4 * m_pool->GetThreads());
+    m_grain = (n + m_chunks - 1) / m_chunks;
+    m_rxProxy.resize(n);
+    for (Ptr<MobilityModel>& p : m_rxProxy)
+    {
+      p = CreateObject<ConstantPositionMobilityModel>();
+    }
+    m_txProxy.resize(m_chunks);
+    for (Ptr<MobilityModel>& p : m_txProxy)
+    {
+      p = CreateObject<ConstantPositionMobilityModel>();
+    }
+    m_rx.assign(n, 0.0);
+    m_used.assign(n, 1);
+    if (m_parallel)
+    {
+      Calibrate(txPowerDbm, a);
+    }
+  }
+
+  // Times the serial chain and a parallel batch on the first transmission and
+  // keeps the fan-out only if it wins by MinSpeedup (see the header comment).
+  void Calibrate(double txPowerDbm, const Ptr<MobilityModel>& a) const
+  {
+    using Clock = std::chrono::steady_clock;
+    PropagationLossModel* inner = PeekPointer(m_inner);
+    const size_t n = m_rxMob.size();
+    double serial = 1e300;
+    double parallel = 1e300;
+    for (uint32_t r = 0; r < kCalibrationRounds; ++r)
+    {
+      const Clock::time_point t0 = Clock::now();
+      for (size_t j = 0; j < n; ++j)
+      {
+        if (m_rxMob[j] != a)
+        {
+          m_rx[j] = inner->CalcRxPower(txPowerDbm, a, m_rxMob[j]);
+        }
+      }
+      const Clock::time_point t1 = Clock::now();
+      ComputeBatch(txPowerDbm, a);
+      const Clock::time_point t2 = Clock::now();
+      serial = std::min(serial, std::chrono::duration<double, std::micro>(t1 - t0).count());
+      parallel = std::min(parallel, std::chrono::duration<double, std::micro>(t2 - t1).count());
+    }
+    m_serialUs = serial;
+    m_parallelUs = parallel;
+    m_batches = 0;
+    m_used.assign(n, 1); // the real Send loop starts a fresh batch
+    m_parallel = parallel * m_minSpeedup <= serial;
+    if (!m_parallel)
+    {
+      m_pool.reset();
+    }
+  }
+
+  void ComputeBatch(double txPowerDbm, const Ptr<MobilityModel>& a) const
+  {
+    // Simulator thread: copy every position into the private proxies
+    const Vector txPos = a->GetPosition();
+    for (Ptr<MobilityModel>& p : m_txProxy)
+    {
+      p->SetPosition(txPos);
+    }
+    const size_t n = m_rxMob.size();
+    for (size_t j = 0; j < n; ++j)
+    {
+      m_rxProxy[j]->SetPosition(m_rxMob[j]->GetPosition());
+    }
+    m_batchSender = PeekPointer(a);
+    m_batchTime = Simulator::Now();
+    m_batchTx = txPowerDbm;
+    std::fill(m_used.begin(), m_used.end(), 0);
+
+    PropagationLossModel* inner = PeekPointer(m_inner);
+    const MobilityModel* sender = PeekPointer(a);
+    m_pool->ParallelFor(n, m_grain, [&](size_t lo, size_t hi) {
+      const Ptr<MobilityModel>& tx = m_txProxy[lo / m_grain]; // one chunk, one thread
+      for (size_t j = lo; j < hi; ++j)
+      {
+        if (PeekPointer(m_rxMob[j]) != sender)
+        {
+          m_rx[j] = inner->CalcRxPower(txPowerDbm, tx, m_rxProxy[j]);
+        }
+      }
+    });
+    ++m_batches;
+  }
+
+  uint32_t m_threads{0};
+  uint32_t m_minReceivers{32};
+  double m_minSpeedup{1.2};
+  Ptr<PropagationLossModel> m_inner;
+  Ptr<YansWifiChannel> m_channel;
+
+  mutable bool m_ready{false};
+  mutable bool m_parallel{false};
+  mutable std::unique_ptr<ThreadPool> m_pool;
+  mutable size_t m_chunks{1};
+  mutable size_t m_grain{1};
+  mutable std::vector<Ptr<MobilityModel>> m_rxMob;   // receivers, channel order
+  mutable std::unordered_map<const MobilityModel*, size_t> m_index;
+  mutable std::vector<Ptr<MobilityModel>> m_rxProxy; // private copies for the workers
+  mutable std::vector<Ptr<MobilityModel>> m_txProxy; // one per chunk
+  mutable std::vector<double> m_rx;                  // last batch, dBm
+  mutable std::vector<char> m_used;
+  mutable const MobilityModel* m_batchSender{nullptr};
+  mutable Time m_batchTime{Seconds(-1)};
+  mutable double m_batchTx{0.0};
+  mutable uint64_t m_batches{0};
+  mutable uint64_t m_served{0};
+  mutable double m_serialUs{0.0};
+  mutable double m_parallelUs{0.0};
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ParallelFanoutLossModel);
+
+// Puts a ParallelFanoutLossModel in front of the channel's loss chain.
+inline Ptr<ParallelFanoutLossModel>
+InstallParallelFanout(Ptr<YansWifiChannel> channel, uint32_t threads, uint32_t minReceivers = 32)
+{
+  PointerValue pv;
+  channel->GetAttribute("PropagationLossModel", pv);
+  Ptr<ParallelFanoutLossModel> fanout = CreateObjectWithAttributes<ParallelFanoutLossModel>(
+      "Threads", UintegerValue(threads), "MinReceivers", UintegerValue(minReceivers));
+  fanout->Wrap(pv.Get<PropagationLossModel>(), channel);
+  channel->SetPropagationLossModel(fanout);
+  return fanout;
+}
+
+} // namespace ns3
+
+#endif // LAB_PARALLEL_FANOUT_H
@@ -0,0 +1,87 @@
+/*
+ * Shared helper — process wall clock and memory statistics (Linux /proc)
+ * -------------------------------------------------------------
+ * Tiny, dependency-free readers used by the lab programs to report how much
+ * wall time and resident memory a run (or one case of a sweep) costs.
+ *
+ *  - GetWallClockSeconds() : monotonic wall clock in seconds.
+ *  - GetCurrentRssKb()     : VmRSS from /proc/self/status (KiB).
+ *  - GetPeakRssKb()        : VmHWM (high-water mark) from /proc/self/status (KiB).
+ *  - ResetPeakRss()        : resets VmHWM so the NEXT case of a sweep reports its
+ *                            own peak instead of the process-lifetime peak.
+ *
+ * On non-Linux hosts the readers return 0 and ResetPeakRss() is a no-op, so the
+ * callers never need an #ifdef.
+ *
+ * Usage: copy this header next to the lab .cc (scratch/ or exec/), or use
+ *        scripts/stage_scratch.sh which copies common/include/ for you.
+ */
+
+#ifndef LAB_PROC_STATS_H
+#define LAB_PROC_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace ns3
+{
+
+// Monotonic wall clock (seconds since an arbitrary epoch).
+inline double
+GetWallClockSeconds()
+{
+  using Clock = std::chrono::steady_clock;
+  return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+// Read one "Key:   1234 kB" line from /proc/self/status. Returns 0 if absent.
+inline uint64_t
+ReadProcStatusKb(const char* key)
+{
+  std::ifstream in("/proc/self/status");
+  if (!in.is_open())
+  {
+    return 0;
+  }
+  const std::size_t keyLen = std::strlen(key);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.compare(0, keyLen, key) == 0)
+    {
+      return std::strtoull(line.c_str() + keyLen, nullptr, 10);
+    }
+  }
+  return 0;
+}
+
+inline uint64_t
+GetCurrentRssKb()
+{
+  return ReadProcStatusKb("VmRSS:");
+}
+
+inline uint64_t
+GetPeakRssKb()
+{
+  return ReadProcStatusKb("VmHWM:");
+}
+
+// Writing "5" to clear_refs resets VmHWM to the current RSS (Linux >= 4.0).
+inline void
+ResetPeakRss()
+{
+  std::ofstream out("/proc/self/clear_refs");
+  if (out.is_open())
+  {
+    out << "5";
+  }
+}
+
+} // namespace ns3
+
+#endif // LAB_PROC_STATS_H
@@ -0,0 +1,207 @@
+/*
+ * Shared helper — progress / ETA reporting and per-case wall/memory budget
+ * -------------------------------------------------------------
+ * ProgressMonitor schedules ONE recurring simulator event that prints
+ *
+ *   [progress] sim 7.250/22.000 s (33%)  wall 41.2 s  1.93e+05 ev/s  ETA 84 s  rss 412 MiB
+ *
+ * to stderr (stdout stays clean for CSV), and enforces an optional budget:
+ *
+ *   - maxWallSeconds : wall time for this case; exceeding it stops the simulator
+ *                      and Status() becomes "timeout";
+ *   - maxRssMb       : resident set size; exceeding it stops the simulator and
+ *                      Status() becomes "memory".
+ *
+ * The simulator is stopped with Simulator::Stop(), so the case still unwinds
+ * through the normal Run() → metrics → Destroy() path. The caller writes its CSV
+ * row as usual, with Status() in a status column instead of "ok".
+ *
+ * Cost: the check event reads a steady clock and Simulator::GetEventCount().
+ * Its SIMULATED period adapts so that it fires about 10 times per WALL second:
+ * the period doubles when checks come too often and halves when they come too
+ * rarely. A run of millions of events therefore executes only a few hundred
+ * extra events. /proc is read at most once per wall second, and only if a
+ * memory budget is set or a line is printed.
+ *
+ * The period is capped at kMaxPeriod (100 ms simulated) and the last check is
+ * clamped to simEnd, so a cheap warm-up (e.g. LTE attach before any traffic)
+ * cannot stretch it past the expensive part of the run. The budget is checked
+ * at event boundaries: it is overshot by at most the wall time of one period.
+ *
+ * Usage:
+ *   ProgressMonitor progress(Seconds(simStop));
+ *   progress.SetReportInterval(5.0);      // wall seconds between lines (0 = silent)
+ *   progress.SetBudget(600.0, 4096);      // 10 min, 4 GiB (0 = unlimited)
+ *   progress.Start();
+ *   Simulator::Run();
+ *   ... progress.Status() ...             // "ok" | "timeout" | "memory"
+ */
+
+#ifndef LAB_PROGRESS_H
+#define LAB_PROGRESS_H
+
+#include "ns3/core-module.h"
+
+#include "lab-proc-stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace ns3
+{
+
+class ProgressMonitor
+{
+public:
+  explicit ProgressMonitor(Time simEnd, const std::string& label = "")
+    : m_simEnd(simEnd),
+      m_label(label)
+  {
+  }
+
+  void SetReportInterval(double wallSeconds) { m_reportEvery = wallSeconds; }
+
+  void SetBudget(double maxWallSeconds, uint64_t maxRssMb)
+  {
+    m_maxWall = maxWallSeconds;
+    m_maxRssKb = maxRssMb * 1024;
+  }
+
+  // Nothing is scheduled when neither reporting nor a budget is requested.
+  void Start()
+  {
+    m_status = "ok";
+    if (m_reportEvery <= 0.0 && m_maxWall <= 0.0 && m_maxRssKb == 0)
+    {
+      return;
+    }
+    m_wallStart = GetWallClockSeconds();
+    m_lastCheckWall = m_wallStart;
+    m_lastReportWall = m_wallStart;
+    m_lastMemWall = m_wallStart;
+    m_lastReportSim = Simulator::Now().GetSeconds();
+    m_lastReportEvents = Simulator::GetEventCount();
+    m_period = MilliSeconds(10);
+    Simulator::Schedule(m_period, &ProgressMonitor::Check, this);
+  }
+
+  const std::string& Status() const { return m_status; }
+  bool   Aborted() const { return m_status != "ok"; }
+  double GetWallSeconds() const { return GetWallClockSeconds() - m_wallStart; }
+
+private:
+  static constexpr double kTargetCheckWall = 0.1; // ~10 checks per wall second
+  static constexpr int64_t kMaxPeriodMs = 100;    // simulated
+
+  void Check()
+  {
+    const double wall = GetWallClockSeconds();
+    const double sinceCheck = wall - m_lastCheckWall;
+    m_lastCheckWall = wall;
+
+    // Adapt the simulated period towards ~kTargetCheckWall of wall time.
+    if (sinceCheck < kTargetCheckWall / 2)
+    {
+      m_period = std::min(NanoSeconds(m_period.GetNanoSeconds() * 2), MilliSeconds(kMaxPeriodMs));
+    }
+    else if (sinceCheck > kTargetCheckWall * 2 && m_period > MicroSeconds(1))
+    {
+      m_period = NanoSeconds(m_period.GetNanoSeconds() / 2);
+    }
+
+    const double elapsed = wall - m_wallStart;
+    if (m_maxWall > 0.0 && elapsed > m_maxWall)
+    {
+      Abort("timeout", elapsed);
+      return;
+    }
+
+    uint64_t rssKb = 0;
+    const bool wantReport = m_reportEvery > 0.0 && wall - m_lastReportWall >= m_reportEvery;
+    if ((m_maxRssKb > 0 && wall - m_lastMemWall >= 1.0) || wantReport)
+    {
+      rssKb = GetCurrentRssKb();
+      m_lastMemWall = wall;
+      if (m_maxRssKb > 0 && rssKb > m_maxRssKb)
+      {
+        Abort("memory", elapsed);
+        return;
+      }
+    }
+    if (wantReport)
+    {
+      Report(wall, rssKb);
+    }
+    const Time left = m_simEnd - Simulator::Now();
+    if (left.IsStrictlyPositive())
+    {
+      Simulator::Schedule(std::min(m_period, left), &ProgressMonitor::Check, this);
+    }
+  }
+
+  void Report(double wall, uint64_t rssKb)
+  {
+    const double sim = Simulator::Now().GetSeconds();
+    const double end = m_simEnd.GetSeconds();
+    const uint64_t events = Simulator::GetEventCount();
+    const double dWall = std::max(wall - m_lastReportWall, 1e-9);
+    const double evRate = (events - m_lastReportEvents) / dWall;
+    const double simRate = (sim - m_lastReportSim) / dWall; // sim s per wall s
+    const double eta = simRate > 0.0 ? (end - sim) / simRate : -1.0;
+
+    std::ostream& os = std::cerr;
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize prec = os.precision();
+    os << "[progress]" << (m_label.empty() ? "" : " " + m_label) << std::fixed
+       << std::setprecision(3) << " sim " << sim << "/" << end << " s ("
+       << std::setprecision(0) << (end > 0 ? 100.0 * sim / end : 0.0) << "%)"
+       << std::setprecision(1) << "  wall " << wall - m_wallStart << " s"
+       << std::scientific << std::setprecision(2) << "  " << evRate << " ev/s"
+       << std::fixed << std::setprecision(0) << "  ETA ";
+    if (eta >= 0.0)
+    {
+      os << eta << " s";
+    }
+    else
+    {
+      os << "?";
+    }
+    os << "  rss " << rssKb / 1024 << " MiB\n";
+    os.flags(flags);
+    os.precision(prec);
+
+    m_lastReportWall = wall;
+    m_lastReportSim = sim;
+    m_lastReportEvents = events;
+  }
+
+  void Abort(const char* why, double elapsed)
+  {
+    m_status = why;
+    std::cerr << "[progress]" << (m_label.empty() ? "" : " " + m_label) << " budget exceeded ("
+              << why << ") at sim " << Simulator::Now().GetSeconds() << " s after " << elapsed
+              << " s wall; stopping this case\n";
+    Simulator::Stop();
+  }
+
+  Time        m_simEnd;
+  std::string m_label;
+  double      m_reportEvery{0.0};
+  double      m_maxWall{0.0};
+  uint64_t    m_maxRssKb{0};
+
+  Time     m_period;
+  double   m_wallStart{0.0};
+  double   m_lastCheckWall{0.0};
+  double   m_lastReportWall{0.0};
+  double   m_lastMemWall{0.0};
+  double   m_lastReportSim{0.0};
+  uint64_t m_lastReportEvents{0};
+  std::string m_status{"ok"};
+};
+
+} // namespace ns3
+
+#endif // LAB_PROGRESS_H
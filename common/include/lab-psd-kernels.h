@@ -0,0 +1,268 @@
+/*
+ * Shared helper — fused, allocation-free PSD kernels for SINR / interference
+ * -------------------------------------------------------------
+ * ns-3 PHY code builds per-RB power spectral densities with SpectrumValue
+ * operators. LteInterference, for instance, evaluates every chunk as
+ *
+ *   SpectrumValue interf = (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+ *   SpectrumValue sinr   = (*m_rxSignal) / interf;
+ *
+ * and the channel hands every receiver a Copy() of the transmit PSD scaled by
+ * the link gain. Each binary operator allocates a new SpectrumValue (a heap
+ * vector) and makes one scalar pass over the bands. The chain above costs
+ * three allocations and three passes for a 50-element result.
+ *
+ * The kernels below do the same arithmetic in one pass over raw doubles, in
+ * place or into a buffer the caller owns:
+ *
+ *   psd::Add(dst, src)              dst += src          (sum of interferers)
+ *   psd::AddScaled(dst, src, g)     dst += g * src      (tx PSD x link gain)
+ *   psd::Sub(dst, src)              dst -= src          (interferer ends)
+ *   psd::Scale(dst, src, g)         dst  = g * src      (received PSD)
+ *   psd::Sinr(out, s, i, n)         out  = s / (i + n)
+ *   psd::SinrFromTotal(out, s, t, n) out = s / (t - s + n)  (LteInterference)
+ *
+ * Every loop is written with __restrict pointers and no loop-carried
+ * dependency, and carries LAB_PSD_SIMD (GCC ivdep / clang vectorize). With
+ * GCC 12 at -O3 all six raw loops vectorise (checked with -fopt-info-vec);
+ * at -O2 none of them do, and at -O0 nothing is vectorised. Use the optimized
+ * build profile (./ns3 configure --build-profile=optimized) for packed code.
+ *
+ * The operations and their order match the SpectrumValue expressions, so the
+ * results are the same except where the compiler contracts a*b+c into an FMA
+ * (AddScaled with -march=native); Lab4_Cpp_PhyBench --bench=psd prints the
+ * largest relative difference.
+ *
+ * Scope: ns-3.40's LteSpectrumPhy owns its LteInterference objects and the
+ * spectrum channel scales PSDs internally, and neither can be swapped for
+ * these kernels from lab code. The kernels are used only by
+ * Lab4_Cpp_PhyBench --bench=psd, which replays the Lab 4 multi-cell SINR
+ * arithmetic outside the simulator. They do not make Lab4_Cpp_LTE,
+ * MultiCell or Sharded any faster.
+ *
+ * PsdInterference is LteInterference's bookkeeping on these kernels: one
+ * running sum of every signal on the air, the noise PSD, and preallocated
+ * output buffers, so a whole receive cycle makes no allocations.
+ *
+ *   PsdInterference rx(model);
+ *   rx.SetNoise(noisePsd);
+ *   rx.AddSignal(txPsd, gain);             // every StartRx
+ *   rx.ComputeSinr(servingRx);             // at every chunk end
+ *   const SpectrumValue& sinr = rx.GetSinr();
+ *   rx.SubtractSignal(txPsd, gain);        // every EndRx
+ */
+
+#ifndef LAB_PSD_KERNELS_H
+#define LAB_PSD_KERNELS_H
+
+#include "ns3/core-module.h"
+#include "ns3/spectrum-module.h"
+
+#include <cstddef>
+
+#if defined(__clang__)
+#define LAB_PSD_SIMD _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define LAB_PSD_SIMD _Pragma("GCC ivdep")
+#else
+#define LAB_PSD_SIMD
+#endif
+
+namespace ns3
+{
+namespace psd
+{
+
+// ---------- Raw kernels (n doubles, no aliasing between dst and sources) ----------
+
+inline void
+Add(double* __restrict dst, const double* __restrict src, size_t n)
+{
+  LAB_PSD_SIMD
+  for (size_t i = 0; i < n; ++i)
+  {
+    dst[i] += src[i];
+  }
+}
+
+inline void
+AddScaled(double* __restrict dst, const double* __restrict src, double g, size_t n)
+{
+  LAB_PSD_SIMD
+  for (size_t i = 0; i < n; ++i)
+  {
+    dst[i] += g * src[i];
+  }
+}
+
+inline void
+Sub(double* __restrict dst, const double* __restrict src, size_t n)
+{
+  LAB_PSD_SIMD
+  for (size_t i = 0; i < n; ++i)
+  {
+    dst[i] -= src[i];
+  }
+}
+
+inline void
+Scale(double* __restrict dst, const double* __restrict src, double g, size_t n)
+{
+  LAB_PSD_SIMD
+  for (size_t i = 0; i < n; ++i)
+  {
+    dst[i] = g * src[i];
+  }
+}
+
+inline void
+Sinr(double* __restrict out, const double* __restrict s, const double* __restrict interf,
+     const double* __restrict noise, size_t n)
+{
+  LAB_PSD_SIMD
+  for (size_t i = 0; i < n; ++i)
+  {
+    out[i] = s[i] / (interf[i] + noise[i]);
+  }
+}
+
+inline void
+SinrFromTotal(double* __restrict out, const double* __restrict s, const double* __restrict total,
+              const double* __restrict noise, size_t n)
+{
+  LAB_PSD_SIMD
+  for (size_t i = 0; i < n; ++i)
+  {
+    out[i] = s[i] / (total[i] - s[i] + noise[i]);
+  }
+}
+
+// ---------- SpectrumValue wrappers (same SpectrumModel required) ----------
+
+inline double*
+Data(SpectrumValue& v)
+{
+  return &*v.ValuesBegin();
+}
+
+inline const double*
+Data(const SpectrumValue& v)
+{
+  return &*v.ConstValuesBegin();
+}
+
+inline void
+CheckModel(const SpectrumValue& a, const SpectrumValue& b)
+{
+  NS_ABORT_MSG_IF(a.GetSpectrumModelUid() != b.GetSpectrumModelUid(),
+                  "psd kernels: SpectrumValues on different SpectrumModels");
+}
+
+inline void
+Add(SpectrumValue& dst, const SpectrumValue& src)
+{
+  CheckModel(dst, src);
+  Add(Data(dst), Data(src), dst.GetValuesN());
+}
+
+inline void
+AddScaled(SpectrumValue& dst, const SpectrumValue& src, double g)
+{
+  CheckModel(dst, src);
+  AddScaled(Data(dst), Data(src), g, dst.GetValuesN());
+}
+
+inline void
+Sub(SpectrumValue& dst, const SpectrumValue& src)
+{
+  CheckModel(dst, src);
+  Sub(Data(dst), Data(src), dst.GetValuesN());
+}
+
+inline void
+Scale(SpectrumValue& dst, const SpectrumValue& src, double g)
+{
+  CheckModel(dst, src);
+  Scale(Data(dst), Data(src), g, dst.GetValuesN());
+}
+
+inline void
+Sinr(SpectrumValue& out, const SpectrumValue& s, const SpectrumValue& interf,
+     const SpectrumValue& noise)
+{
+  CheckModel(out, s);
+  CheckModel(s, interf);
+  CheckModel(s, noise);
+  Sinr(Data(out), Data(s), Data(interf), Data(noise), out.GetValuesN());
+}
+
+inline void
+SinrFromTotal(SpectrumValue& out, const SpectrumValue& s, const SpectrumValue& total,
+              const SpectrumValue& noise)
+{
+  CheckModel(out, s);
+  CheckModel(s, total);
+  CheckModel(s, noise);
+  SinrFromTotal(Data(out), Data(s), Data(total), Data(noise), out.GetValuesN());
+}
+
+} // namespace psd
+
+class PsdInterference
+{
+public:
+  explicit PsdInterference(Ptr<const SpectrumModel> model)
+    : m_all(model),
+      m_noise(model),
+      m_interf(model),
+      m_sinr(model)
+  {
+  }
+
+  void SetNoise(const SpectrumValue& noise)
+  {
+    psd::CheckModel(m_noise, noise);
+    m_noise = noise; // same size: copies into the existing storage
+  }
+
+  // A transmission starts / ends at this receiver: tx PSD times the link gain.
+  void AddSignal(const SpectrumValue& tx, double gain) { psd::AddScaled(m_all, tx, gain); }
+  void SubtractSignal(const SpectrumValue& tx, double gain) { psd::AddScaled(m_all, tx, -gain); }
+  void AddSignal(const SpectrumValue& rx) { psd::Add(m_all, rx); }
+  void SubtractSignal(const SpectrumValue& rx) { psd::Sub(m_all, rx); }
+
+  // SINR of 'rx' (one of the signals already added) against everything else.
+  void ComputeSinr(const SpectrumValue& rx) { psd::SinrFromTotal(m_sinr, rx, m_all, m_noise); }
+
+  // Interference + noise seen by 'rx', for the chunk processors that want it.
+  void ComputeInterference(const SpectrumValue& rx)
+  {
+    psd::CheckModel(m_interf, rx);
+    const size_t n = m_interf.GetValuesN();
+    double* __restrict out = psd::Data(m_interf);
+    const double* __restrict all = psd::Data(m_all);
+    const double* __restrict s = psd::Data(rx);
+    const double* __restrict noise = psd::Data(m_noise);
+    LAB_PSD_SIMD
+    for (size_t i = 0; i < n; ++i)
+    {
+      out[i] = all[i] - s[i] + noise[i];
+    }
+  }
+
+  void Reset() { m_all = 0.0; }
+
+  const SpectrumValue& GetTotal() const { return m_all; }
+  const SpectrumValue& GetSinr() const { return m_sinr; }
+  const SpectrumValue& GetInterference() const { return m_interf; }
+
+private:
+  SpectrumValue m_all;    // every signal currently on the air
+  SpectrumValue m_noise;
+  SpectrumValue m_interf; // scratch outputs, reused every chunk
+  SpectrumValue m_sinr;
+};
+
+} // namespace ns3
+
+#endif // LAB_PSD_KERNELS_H
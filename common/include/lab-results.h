@@ -0,0 +1,298 @@
+/*
+ * Shared helper — concurrency-safe result store (typed rows, .labcol segments)
+ * -------------------------------------------------------------
+ * The lab programs used to append their summary to a CSV file, each in its own
+ * way: Lab4_Cpp_LTE repeated the header on every append, Lab3_Cpp_Hidden wrote
+ * headerless rows, Lab3_Cpp_TCP truncated, Lab 1 printed "CSV," lines to
+ * stdout. Two sweep processes appending to the same file interleave partial
+ * lines, and a script later has to parse all of it back as text.
+ *
+ * ResultsSink writes typed rows into a result DIRECTORY instead:
+ *
+ *   <dir>/<schema>.v<version>.labcol                       merged table
+ *   <dir>/<schema>.v<version>.<host>-<pid>-<n>.seg.labcol  one per writer
+ *   <dir>/.lock                                            flock() for merges
+ *
+ *  - Each sink buffers its rows in a ColumnarTable (lab-columnar.h). Close()
+ *    writes them to a temporary file, fsync()s it and rename()s it to its
+ *    segment name, so a segment is either complete or absent, also after a
+ *    power loss; writers never share a file.
+ *  - Close() then merges the segments of its schema into the merged table
+ *    once there are kMergeSegments of them, under an exclusive flock on
+ *    <dir>/.lock (skipped if another process holds it). The merged table is
+ *    also replaced by rename(). Its "segments" metadata lists what that merge
+ *    took in, so a crash between the rename and the unlinks leaves no
+ *    duplicates: the next merge and the readers skip (and drop) those
+ *    segments. If the merged table exists but cannot be read, the merge is
+ *    abandoned and every segment stays put, rather than replacing the table
+ *    with the segments alone. Merge(dir, ...) forces a full merge, e.g.
+ *    after a sweep.
+ *  - The schema name and version are part of every file name. A program that
+ *    changes its columns bumps the version; old and new rows never mix, and a
+ *    segment whose columns disagree with the merged table is left alone.
+ *
+ * Readers (common/scripts/labcol.py: read_results) take a shared flock, load
+ * the merged table plus the remaining segments and concatenate the columns,
+ * with no text parsing: a million-row table is a handful of array copies.
+ *
+ * Usage:
+ *   ResultsSink results(resultsDir, "lab3-tcp", 1);
+ *   const uint32_t cPkt = results.AddColumn("pkt_size", ColumnarTable::U32);
+ *   const uint32_t cThr = results.AddColumn("throughput_mbps", ColumnarTable::F64);
+ *   results.Set(cPkt, uint64_t(pktSize)); results.Set(cThr, thr); results.EndRow();
+ *   if (!results.Close()) { ... }
+ *
+ * Linux/POSIX only (flock, rename within one directory).
+ */
+
+#ifndef LAB_RESULTS_H
+#define LAB_RESULTS_H
+
+#include "lab-columnar.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+class ResultsSink
+{
+public:
+  static constexpr uint32_t kMergeSegments = 32;
+
+  ResultsSink(const std::string& dir, const std::string& schema, uint32_t version)
+    : m_dir(dir),
+      m_prefix(schema + ".v" + std::to_string(version))
+  {
+    m_table.SetMeta("schema", schema);
+    m_table.SetMeta("schema_version", std::to_string(version));
+    m_table.SetMeta("created_unix", std::to_string(std::time(nullptr)));
+  }
+
+  ~ResultsSink() { Close(); }
+
+  ResultsSink(const ResultsSink&) = delete;
+  ResultsSink& operator=(const ResultsSink&) = delete;
+
+  uint32_t AddColumn(const std::string& name, ColumnarTable::Type type)
+  {
+    return m_table.AddColumn(name, type);
+  }
+  void SetMeta(const std::string& key, const std::string& value) { m_table.SetMeta(key, value); }
+
+  void Set(uint32_t col, uint64_t v) { m_table.Set(col, v); }
+  void Set(uint32_t col, double v) { m_table.Set(col, v); }
+  void Set(uint32_t col, const std::string& v) { m_table.Set(col, v); }
+  void EndRow() { m_table.EndRow(); }
+
+  uint64_t GetRows() const { return m_table.GetRows(); }
+  // File the rows went to (valid after a successful Close()).
+  const std::string& GetSegmentPath() const { return m_segment; }
+
+  // Publishes the rows as one segment and merges if enough have piled up.
+  // Idempotent; a sink without rows writes nothing.
+  bool Close()
+  {
+    if (m_closed)
+    {
+      return m_ok;
+    }
+    m_closed = true;
+    if (m_table.GetRows() == 0)
+    {
+      return m_ok = true;
+    }
+    if (::mkdir(m_dir.c_str(), 0777) != 0 && errno != EEXIST)
+    {
+      return m_ok = false;
+    }
+
+    static std::atomic<uint32_t> seq{0};
+    char host[64] = "host";
+    ::gethostname(host, sizeof(host) - 1);
+    std::replace(host, host + std::strlen(host), '.', '_'); // '.' separates the name fields
+    std::ostringstream id;
+    id << host << "-" << ::getpid() << "-" << seq++;
+    const std::string tmp = m_dir + "/.tmp-" + id.str();
+    m_segment = m_dir + "/" + m_prefix + "." + id.str() + kSegmentSuffix;
+    m_table.SetMeta("writer", id.str());
+    if (!m_table.Write(tmp) || !SyncFile(tmp) || std::rename(tmp.c_str(), m_segment.c_str()) != 0)
+    {
+      std::remove(tmp.c_str());
+      return m_ok = false;
+    }
+    MergeLocked(m_dir, m_prefix, kMergeSegments, false);
+    return m_ok = true;
+  }
+
+  // Merges every segment of schema/version in 'dir' now (waits for the lock).
+  static bool Merge(const std::string& dir, const std::string& schema, uint32_t version)
+  {
+    return MergeLocked(dir, schema + ".v" + std::to_string(version), 1, true);
+  }
+
+private:
+  static constexpr const char* kSegmentSuffix = ".seg.labcol";
+
+  static bool EndsWith(const std::string& s, const std::string& tail)
+  {
+    return s.size() >= tail.size() && s.compare(s.size() - tail.size(), tail.size(), tail) == 0;
+  }
+
+  // Flushes a freshly written file to disk, so a rename() never publishes a
+  // name whose data is still only in the page cache.
+  static bool SyncFile(const std::string& path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      return false;
+    }
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+  }
+
+  static std::vector<std::string> ListSegments(const std::string& dir, const std::string& prefix)
+  {
+    std::vector<std::string> names;
+    if (DIR* d = ::opendir(dir.c_str()))
+    {
+      while (dirent* e = ::readdir(d))
+      {
+        const std::string n = e->d_name;
+        if (n.compare(0, prefix.size() + 1, prefix + ".") == 0 && EndsWith(n, kSegmentSuffix))
+        {
+          names.push_back(n);
+        }
+      }
+      ::closedir(d);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+  static bool MergeLocked(const std::string& dir, const std::string& prefix, uint32_t minSegments,
+                          bool wait)
+  {
+    std::vector<std::string> segs = ListSegments(dir, prefix);
+    if (segs.size() < minSegments)
+    {
+      return true;
+    }
+    const int fd = ::open((dir + "/.lock").c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd < 0)
+    {
+      return false;
+    }
+    if (::flock(fd, LOCK_EX | (wait ? 0 : LOCK_NB)) != 0)
+    {
+      ::close(fd);
+      return !wait; // someone else is merging
+    }
+
+    const std::string mergedPath = dir + "/" + prefix + ".labcol";
+    ColumnarTable merged;
+    struct stat st;
+    const bool haveMerged = ::stat(mergedPath.c_str(), &st) == 0;
+    if ((!haveMerged && errno != ENOENT) || (haveMerged && !ColumnarTable::Read(mergedPath, merged)))
+    {
+      // Present but unreadable: merging would replace it with the segments alone.
+      ::flock(fd, LOCK_UN);
+      ::close(fd);
+      return false;
+    }
+
+    // Segments the last merge took in but did not get to delete.
+    std::set<std::string> done;
+    std::istringstream prev(haveMerged ? merged.GetMeta("segments") : "");
+    for (std::string s; std::getline(prev, s, ',');)
+    {
+      done.insert(s);
+    }
+
+    segs = ListSegments(dir, prefix);
+    std::vector<std::string> taken;
+    bool ok = true;
+    bool first = !haveMerged;
+    for (const std::string& s : segs)
+    {
+      if (done.count(s))
+      {
+        std::remove((dir + "/" + s).c_str());
+        continue;
+      }
+      ColumnarTable t;
+      if (!ColumnarTable::Read(dir + "/" + s, t))
+      {
+        ok = false;
+        continue;
+      }
+      if (first)
+      {
+        merged = std::move(t);
+        first = false;
+      }
+      else if (!merged.Append(t))
+      {
+        ok = false; // columns differ: leave the segment where it is
+        continue;
+      }
+      taken.push_back(s);
+    }
+
+    if (!taken.empty())
+    {
+      std::string list;
+      for (const std::string& s : taken)
+      {
+        list += (list.empty() ? "" : ",") + s;
+      }
+      merged.SetMeta("segments", list);
+      merged.SetMeta("writer", "merged");
+      const std::string tmp = mergedPath + ".tmp";
+      if (merged.Write(tmp) && SyncFile(tmp) && std::rename(tmp.c_str(), mergedPath.c_str()) == 0)
+      {
+        for (const std::string& s : taken)
+        {
+          std::remove((dir + "/" + s).c_str());
+        }
+      }
+      else
+      {
+        std::remove(tmp.c_str());
+        ok = false;
+      }
+    }
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+    return ok;
+  }
+
+  std::string   m_dir;
+  std::string   m_prefix;   // "<schema>.v<version>"
+  std::string   m_segment;
+  ColumnarTable m_table;
+  bool          m_closed{false};
+  bool          m_ok{false};
+};
+
+} // namespace ns3
+
+#endif // LAB_RESULTS_H
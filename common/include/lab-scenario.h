@@ -0,0 +1,300 @@
+/*
+ * Shared helper — typed scenario building blocks (rates, Wi-Fi BSS, traffic)
+ * -------------------------------------------------------------
+ * The labs describe their setup with attribute strings:
+ *
+ *   "DataMode", StringValue("DsssRate11Mbps")
+ *   "OnTime",   StringValue("ns3::ConstantRandomVariable[Constant=1]")
+ *   "DataRate", StringValue("100Mbps")
+ *
+ * Each string is parsed at run time. A WifiMode name is looked up by a linear
+ * search of every registered mode. A random-variable string goes through
+ * ObjectFactory parsing, a TypeId lookup and a second attribute parse. A typo
+ * ("DsssRate11Mpbs") or a mode of the wrong standard (an OFDM rate on an
+ * 802.11b PHY) is only found when the case runs, or worse, deep inside the
+ * first transmission.
+ *
+ * This header replaces those strings with typed values:
+ *
+ *   - LabRate is a constexpr table of the 802.11b DSSS/CCK and 802.11a OFDM
+ *     rates (standard, Mbps, ns-3 name). DsssRateAtLeast(mbps) is the
+ *     constexpr form of the old per-file ModeForB(). ToWifiMode() returns the
+ *     PHY's own static WifiMode (DsssPhy/OfdmPhy), with no name lookup.
+ *   - LabWifiBss<Standard> configures channel, PHY, station manager and MAC
+ *     for one BSS. Only the template form Rates<Data, Control>() is checked
+ *     at compile time (static_assert), so
+ *     LabWifiBss<LabStandard::k80211b>().Rates<LabRate::Ofdm54>() does not
+ *     compile. Rates picked at run time go through Rates(data, control),
+ *     which checks the pair when it is called and aborts before anything is
+ *     installed. Scenario 1/2 and the lab2-bss batch kernel take --rate, so
+ *     they use the runtime overload; for them a wrong standard is a run-time
+ *     abort, not a compile error.
+ *   - ConstantRv() / SaturatingOnOff() build the "always on" OnOff source
+ *     from objects and typed values.
+ *
+ *   LabWifiBss<LabStandard::k80211b> bss("lab2-ssid");
+ *   bss.Rates(DsssRateAtLeast(rate), DsssRateAtLeast(rate));
+ *   NetDeviceContainer staDevs = bss.InstallSta(staNodes);
+ *   NetDeviceContainer apDev   = bss.InstallAp(apNode);
+ *   OnOffHelper onoff = SaturatingOnOff(InetSocketAddress(dst, 9), DataRate(100000000), 1000);
+ *
+ * The ns-3 helpers still name the station manager and MAC types by TypeId
+ * name (a hash lookup, not a parse); all attribute VALUES are typed.
+ *
+ * Runs are NOT guaranteed to match the string forms bit for bit, and this has
+ * not been checked. SaturatingOnOff() creates its two ConstantRandomVariables
+ * once, where the string form made them when the attribute was set and again
+ * for every installed application. Every RandomVariableStream takes the next
+ * automatic stream number when it is created, so a different count shifts the
+ * streams of variables created after it that AssignStreams() does not fix.
+ * Results are statistically equivalent; compare distributions, not digits.
+ */
+
+#ifndef LAB_SCENARIO_H
+#define LAB_SCENARIO_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/applications-module.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+namespace ns3
+{
+
+// ---------- constexpr rate table ----------
+
+enum class LabStandard : uint8_t
+{
+  k80211b,
+  k80211a,
+};
+
+enum class LabRate : uint8_t
+{
+  Dsss1, Dsss2, Dsss5_5, Dsss11,
+  Ofdm6, Ofdm9, Ofdm12, Ofdm18, Ofdm24, Ofdm36, Ofdm48, Ofdm54,
+};
+
+struct LabRateInfo
+{
+  LabRate     rate;
+  LabStandard standard;
+  double      mbps;
+  const char* name;  // WifiMode unique name
+};
+
+constexpr LabRateInfo kLabRates[] = {
+  {LabRate::Dsss1,   LabStandard::k80211b,  1.0, "DsssRate1Mbps"},
+  {LabRate::Dsss2,   LabStandard::k80211b,  2.0, "DsssRate2Mbps"},
+  {LabRate::Dsss5_5, LabStandard::k80211b,  5.5, "DsssRate5_5Mbps"},
+  {LabRate::Dsss11,  LabStandard::k80211b, 11.0, "DsssRate11Mbps"},
+  {LabRate::Ofdm6,   LabStandard::k80211a,  6.0, "OfdmRate6Mbps"},
+  {LabRate::Ofdm9,   LabStandard::k80211a,  9.0, "OfdmRate9Mbps"},
+  {LabRate::Ofdm12,  LabStandard::k80211a, 12.0, "OfdmRate12Mbps"},
+  {LabRate::Ofdm18,  LabStandard::k80211a, 18.0, "OfdmRate18Mbps"},
+  {LabRate::Ofdm24,  LabStandard::k80211a, 24.0, "OfdmRate24Mbps"},
+  {LabRate::Ofdm36,  LabStandard::k80211a, 36.0, "OfdmRate36Mbps"},
+  {LabRate::Ofdm48,  LabStandard::k80211a, 48.0, "OfdmRate48Mbps"},
+  {LabRate::Ofdm54,  LabStandard::k80211a, 54.0, "OfdmRate54Mbps"},
+};
+
+constexpr const LabRateInfo&
+Info(LabRate r)
+{
+  return kLabRates[static_cast<size_t>(r)];
+}
+
+constexpr bool
+LabRateTableInOrder()
+{
+  for (size_t i = 0; i < sizeof(kLabRates) / sizeof(kLabRates[0]); ++i)
+  {
+    if (static_cast<size_t>(kLabRates[i].rate) != i)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(LabRateTableInOrder(), "kLabRates must be indexed by LabRate");
+
+constexpr bool
+RateAllowed(LabStandard s, LabRate r)
+{
+  return Info(r).standard == s;
+}
+
+// Lowest 802.11b rate >= mbps (11 Mbps above that), as Lab 2 always did.
+constexpr LabRate
+DsssRateAtLeast(double mbps)
+{
+  return mbps <= 1.0 ? LabRate::Dsss1
+       : mbps <= 2.0 ? LabRate::Dsss2
+       : mbps <= 5.5 ? LabRate::Dsss5_5
+       :               LabRate::Dsss11;
+}
+static_assert(DsssRateAtLeast(5.0) == LabRate::Dsss5_5, "DsssRateAtLeast");
+
+// Lowest 802.11a rate >= mbps (54 Mbps above that).
+constexpr LabRate
+OfdmRateAtLeast(double mbps)
+{
+  for (LabRate r : {LabRate::Ofdm6, LabRate::Ofdm9, LabRate::Ofdm12, LabRate::Ofdm18,
+                    LabRate::Ofdm24, LabRate::Ofdm36, LabRate::Ofdm48})
+  {
+    if (mbps <= Info(r).mbps)
+    {
+      return r;
+    }
+  }
+  return LabRate::Ofdm54;
+}
+static_assert(OfdmRateAtLeast(20.0) == LabRate::Ofdm24, "OfdmRateAtLeast");
+
+inline WifiStandard
+ToWifiStandard(LabStandard s)
+{
+  return s == LabStandard::k80211b ? WIFI_STANDARD_80211b : WIFI_STANDARD_80211a;
+}
+
+inline WifiMode
+ToWifiMode(LabRate r)
+{
+  switch (r)
+  {
+  case LabRate::Dsss1:   return DsssPhy::GetDsssRate1Mbps();
+  case LabRate::Dsss2:   return DsssPhy::GetDsssRate2Mbps();
+  case LabRate::Dsss5_5: return DsssPhy::GetDsssRate5_5Mbps();
+  case LabRate::Dsss11:  return DsssPhy::GetDsssRate11Mbps();
+  case LabRate::Ofdm6:   return OfdmPhy::GetOfdmRate6Mbps();
+  case LabRate::Ofdm9:   return OfdmPhy::GetOfdmRate9Mbps();
+  case LabRate::Ofdm12:  return OfdmPhy::GetOfdmRate12Mbps();
+  case LabRate::Ofdm18:  return OfdmPhy::GetOfdmRate18Mbps();
+  case LabRate::Ofdm24:  return OfdmPhy::GetOfdmRate24Mbps();
+  case LabRate::Ofdm36:  return OfdmPhy::GetOfdmRate36Mbps();
+  case LabRate::Ofdm48:  return OfdmPhy::GetOfdmRate48Mbps();
+  case LabRate::Ofdm54:  return OfdmPhy::GetOfdmRate54Mbps();
+  }
+  NS_FATAL_ERROR("unknown LabRate");
+  return WifiMode();
+}
+
+// ---------- One infrastructure BSS on a Yans channel ----------
+
+template <LabStandard S>
+class LabWifiBss
+{
+public:
+  explicit LabWifiBss(const std::string& ssid = "lab-ssid")
+    : m_ssid(ssid)
+  {
+  }
+
+  // Constant Data/Control rates, checked against the standard at compile time.
+  template <LabRate Data, LabRate Control = Data>
+  LabWifiBss& Rates()
+  {
+    static_assert(RateAllowed(S, Data), "data rate is not defined for this standard");
+    static_assert(RateAllowed(S, Control), "control rate is not defined for this standard");
+    return Rates(Data, Control);
+  }
+
+  // Same check at run time (abort), for rates picked from the command line.
+  LabWifiBss& Rates(LabRate data, LabRate control)
+  {
+    NS_ABORT_MSG_IF(!RateAllowed(S, data) || !RateAllowed(S, control),
+                    "LabWifiBss: " << Info(data).name << "/" << Info(control).name
+                                   << " is not a rate of this standard");
+    NS_ABORT_MSG_IF(m_configured, "LabWifiBss: Rates() after the first Install");
+    m_data = data;
+    m_control = control;
+    return *this;
+  }
+
+  // Share a channel with other BSSs (default: a new log-distance channel).
+  LabWifiBss& Channel(Ptr<YansWifiChannel> channel)
+  {
+    m_channel = channel;
+    return *this;
+  }
+
+  NetDeviceContainer InstallSta(const NodeContainer& nodes)
+  {
+    Configure();
+    m_mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(m_ssid));
+    return m_wifi.Install(m_phy, m_mac, nodes);
+  }
+
+  NetDeviceContainer InstallAp(const NodeContainer& nodes)
+  {
+    Configure();
+    m_mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(m_ssid));
+    return m_wifi.Install(m_phy, m_mac, nodes);
+  }
+
+  Ptr<YansWifiChannel> GetChannel() const { return m_channel; }
+  YansWifiPhyHelper& GetPhyHelper() { return m_phy; }
+
+private:
+  void Configure()
+  {
+    if (m_configured)
+    {
+      return;
+    }
+    m_configured = true;
+    if (!m_channel)
+    {
+      // What YansWifiChannelHelper::Default() builds.
+      m_channel = CreateObject<YansWifiChannel>();
+      m_channel->SetPropagationLossModel(CreateObject<LogDistancePropagationLossModel>());
+      m_channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+    }
+    m_phy.SetChannel(m_channel);
+    m_wifi.SetStandard(ToWifiStandard(S));
+    m_wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                   "DataMode",    WifiModeValue(ToWifiMode(m_data)),
+                                   "ControlMode", WifiModeValue(ToWifiMode(m_control)));
+  }
+
+  Ssid                 m_ssid;
+  LabRate              m_data{S == LabStandard::k80211b ? LabRate::Dsss11 : LabRate::Ofdm54};
+  LabRate              m_control{S == LabStandard::k80211b ? LabRate::Dsss1 : LabRate::Ofdm6};
+  bool                 m_configured{false};
+  Ptr<YansWifiChannel> m_channel;
+  YansWifiPhyHelper    m_phy;
+  WifiHelper           m_wifi;
+  WifiMacHelper        m_mac;
+};
+
+// ---------- Traffic ----------
+
+inline Ptr<ConstantRandomVariable>
+ConstantRv(double value)
+{
+  Ptr<ConstantRandomVariable> rv = CreateObject<ConstantRandomVariable>();
+  rv->SetAttribute("Constant", DoubleValue(value));
+  return rv;
+}
+
+// UDP OnOff source that is always on at 'rate' with 'packetSize'-byte packets.
+inline OnOffHelper
+SaturatingOnOff(const Address& dst, DataRate rate, uint32_t packetSize)
+{
+  OnOffHelper onoff("ns3::UdpSocketFactory", dst);
+  onoff.SetAttribute("DataRate",   DataRateValue(rate));
+  onoff.SetAttribute("PacketSize", UintegerValue(packetSize));
+  onoff.SetAttribute("OnTime",     PointerValue(ConstantRv(1.0)));
+  onoff.SetAttribute("OffTime",    PointerValue(ConstantRv(0.0)));
+  return onoff;
+}
+
+} // namespace ns3
+
+#endif // LAB_SCENARIO_H
@@ -0,0 +1,443 @@
+/*
+ * Shared helper — per-TTI cost instrumentation for LTE FF MAC schedulers
+ * -------------------------------------------------------------
+ * InstrumentedFfMacScheduler is an FfMacScheduler that owns a real scheduler
+ * (attribute "Scheduler", e.g. ns3::PfFfMacScheduler) and sits between it and
+ * LteEnbMac on both SAPs:
+ *
+ *   LteEnbMac --SchedDlTriggerReq--> probe --> inner scheduler
+ *   LteEnbMac <--SchedDlConfigInd--- probe <-- inner scheduler
+ *
+ * For every SchedDlTriggerReq / SchedUlTriggerReq it records:
+ *   - allocation wall time: from the trigger to the inner scheduler's
+ *     ConfigInd. The MAC's own processing of the allocation is excluded;
+ *   - UEs considered: UEs with a backlog the scheduler knows about (DL from
+ *     SchedDlRlcBufferReq, UL from SR/BSR);
+ *   - UEs scheduled: DL BuildDataList entries / UL DCIs;
+ *   - resources: DL RBGs (bits of the DCI bitmap), UL RBs (DCI rbLen).
+ * The cost goes into a LatencyHistogram (ns), so mean/p99/max per TTI come at
+ * fixed memory. Only counters are kept; nothing is written per TTI.
+ *
+ * The inner scheduler is built with its own attribute defaults. Set them with
+ * Config::SetDefault("ns3::PfFfMacScheduler::...") rather than
+ * LteHelper::SetSchedulerAttribute, which only reaches the probe.
+ *
+ * Usage:
+ *   lte->SetSchedulerType("ns3::InstrumentedFfMacScheduler");
+ *   lte->SetSchedulerAttribute("Scheduler", StringValue(ResolveSchedulerTypeId("pf")));
+ *   ... install, run ...
+ *   SchedulerProbeStats dl, ul;
+ *   CollectSchedulerProbes(enbDevs, dl, ul);
+ *   dl.Report(std::cout, "DL");
+ */
+
+#ifndef LAB_SCHEDULER_PROBE_H
+#define LAB_SCHEDULER_PROBE_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-module.h"
+
+#include "lab-latency-histogram.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+
+namespace ns3
+{
+
+// Short names used by the lab CLIs; anything else is taken as a TypeId name.
+inline std::string
+ResolveSchedulerTypeId(const std::string& user)
+{
+  static const std::map<std::string, std::string> names = {
+      {"pf", "ns3::PfFfMacScheduler"},       {"rr", "ns3::RrFfMacScheduler"},
+      {"tdmt", "ns3::TdMtFfMacScheduler"},   {"fdmt", "ns3::FdMtFfMacScheduler"},
+      {"tta", "ns3::TtaFfMacScheduler"},     {"tdbet", "ns3::TdBetFfMacScheduler"},
+      {"fdbet", "ns3::FdBetFfMacScheduler"}, {"tdtbfq", "ns3::TdTbfqFfMacScheduler"},
+      {"fdtbfq", "ns3::FdTbfqFfMacScheduler"}, {"pss", "ns3::PssFfMacScheduler"},
+      {"cqa", "ns3::CqaFfMacScheduler"}};
+  std::string s = user;
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return std::tolower(c); });
+  auto it = names.find(s);
+  return it != names.end() ? it->second : user;
+}
+
+struct SchedulerProbeStats
+{
+  uint64_t ttis{0};            // trigger requests
+  uint64_t busyTtis{0};        // ... with at least one UE considered
+  uint64_t uesConsidered{0};   // summed over TTIs
+  uint64_t uesScheduled{0};
+  uint64_t resources{0};       // DL RBGs / UL RBs
+  LatencyHistogram costNs;     // allocation wall time per TTI
+
+  void Merge(const SchedulerProbeStats& o)
+  {
+    ttis += o.ttis;
+    busyTtis += o.busyTtis;
+    uesConsidered += o.uesConsidered;
+    uesScheduled += o.uesScheduled;
+    resources += o.resources;
+    costNs.Merge(o.costNs);
+  }
+
+  double TotalCostSeconds() const { return costNs.GetMean() * costNs.GetCount() * 1e-9; }
+
+  void Report(std::ostream& os, const std::string& dir) const
+  {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize prec = os.precision();
+    const double busy = busyTtis ? double(busyTtis) : 1.0;
+    os << std::fixed << std::setprecision(2) << "[sched " << dir << "] ttis=" << ttis
+       << " busy=" << busyTtis << "  UEs considered/TTI=" << uesConsidered / busy
+       << " scheduled/TTI=" << uesScheduled / busy
+       << (dir == "UL" ? " RBs/TTI=" : " RBGs/TTI=") << resources / busy
+       << "  cost/TTI mean=" << costNs.GetMean() / 1e3 << " us p99="
+       << costNs.Quantile(0.99) / 1e3 << " us max=" << costNs.GetMax() / 1e3 << " us"
+       << "  total=" << std::setprecision(3) << TotalCostSeconds() << " s\n";
+    os.flags(flags);
+    os.precision(prec);
+  }
+};
+
+class InstrumentedFfMacScheduler : public FfMacScheduler
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+        TypeId("ns3::InstrumentedFfMacScheduler")
+            .SetParent<FfMacScheduler>()
+            .SetGroupName("Lte")
+            .AddConstructor<InstrumentedFfMacScheduler>()
+            .AddAttribute("Scheduler",
+                          "TypeId of the FF MAC scheduler being measured.",
+                          StringValue("ns3::PfFfMacScheduler"),
+                          MakeStringAccessor(&InstrumentedFfMacScheduler::m_innerType),
+                          MakeStringChecker());
+    return tid;
+  }
+
+  InstrumentedFfMacScheduler()
+    : m_schedProvider(this),
+      m_schedUser(this),
+      m_cschedProvider(this)
+  {
+  }
+
+  // ---- FfMacScheduler ----
+  void SetFfMacCschedSapUser(FfMacCschedSapUser* s) override
+  {
+    Inner()->SetFfMacCschedSapUser(s);
+  }
+
+  void SetFfMacSchedSapUser(FfMacSchedSapUser* s) override
+  {
+    m_macSchedUser = s;
+    Inner()->SetFfMacSchedSapUser(&m_schedUser);
+  }
+
+  FfMacCschedSapProvider* GetFfMacCschedSapProvider() override
+  {
+    m_innerCsched = Inner()->GetFfMacCschedSapProvider();
+    return &m_cschedProvider;
+  }
+
+  FfMacSchedSapProvider* GetFfMacSchedSapProvider() override
+  {
+    m_innerSched = Inner()->GetFfMacSchedSapProvider();
+    return &m_schedProvider;
+  }
+
+  void SetLteFfrSapProvider(LteFfrSapProvider* s) override { Inner()->SetLteFfrSapProvider(s); }
+  LteFfrSapUser* GetLteFfrSapUser() override { return Inner()->GetLteFfrSapUser(); }
+
+  const SchedulerProbeStats& GetDlStats() const { return m_dl; }
+  const SchedulerProbeStats& GetUlStats() const { return m_ul; }
+  Ptr<FfMacScheduler> GetInnerScheduler() const { return m_inner; }
+
+protected:
+  void DoDispose() override
+  {
+    if (m_inner)
+    {
+      m_inner->Dispose();
+      m_inner = nullptr;
+    }
+    FfMacScheduler::DoDispose();
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  // LteHelper asks for the SAPs right after Create(), so build on first use.
+  Ptr<FfMacScheduler> Inner()
+  {
+    if (!m_inner)
+    {
+      ObjectFactory f(m_innerType);
+      m_inner = f.Create<FfMacScheduler>();
+    }
+    return m_inner;
+  }
+
+  // ---- backlog book-keeping (UEs "considered") ----
+  void DlBuffer(const FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& p)
+  {
+    const uint32_t key = (uint32_t(p.m_rnti) << 8) | p.m_logicalChannelIdentity;
+    const bool now = p.m_rlcTransmissionQueueSize + p.m_rlcRetransmissionQueueSize +
+                         p.m_rlcStatusPduSize > 0;
+    if (now)
+    {
+      if (m_dlBackloggedLcs.insert(key).second)
+      {
+        ++m_dlBackloggedUes[p.m_rnti];
+      }
+    }
+    else if (m_dlBackloggedLcs.erase(key) && --m_dlBackloggedUes[p.m_rnti] == 0)
+    {
+      m_dlBackloggedUes.erase(p.m_rnti);
+    }
+  }
+
+  void UlBsr(const FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& p)
+  {
+    for (const MacCeListElement_s& ce : p.m_macCeList)
+    {
+      if (ce.m_macCeType != MacCeListElement_s::BSR)
+      {
+        continue;
+      }
+      const bool any = std::any_of(ce.m_macCeValue.m_bufferStatus.begin(),
+                                   ce.m_macCeValue.m_bufferStatus.end(),
+                                   [](uint8_t b) { return b > 0; });
+      if (any)
+      {
+        m_ulBacklog.insert(ce.m_rnti);
+      }
+      else
+      {
+        m_ulBacklog.erase(ce.m_rnti);
+      }
+    }
+  }
+
+  void ForgetUe(uint16_t rnti)
+  {
+    m_dlBackloggedUes.erase(rnti);
+    m_ulBacklog.erase(rnti);
+    for (auto it = m_dlBackloggedLcs.lower_bound(uint32_t(rnti) << 8);
+         it != m_dlBackloggedLcs.end() && (*it >> 8) == rnti;)
+    {
+      it = m_dlBackloggedLcs.erase(it);
+    }
+  }
+
+  // ---- timing ----
+  void BeginTti(SchedulerProbeStats& st, size_t considered)
+  {
+    ++st.ttis;
+    st.uesConsidered += considered;
+    if (considered > 0)
+    {
+      ++st.busyTtis;
+    }
+    m_t0 = Clock::now();
+    m_pending = true;
+  }
+
+  void EndTti(SchedulerProbeStats& st, uint32_t ues, uint32_t resources)
+  {
+    if (!m_pending)
+    {
+      return; // ConfigInd outside a trigger (should not happen)
+    }
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_t0);
+    st.costNs.Record(static_cast<uint64_t>(ns.count()));
+    st.uesScheduled += ues;
+    st.resources += resources;
+    m_pending = false;
+  }
+
+  // ---- SAP shims ----
+  class SchedProvider : public FfMacSchedSapProvider
+  {
+  public:
+    explicit SchedProvider(InstrumentedFfMacScheduler* p) : m_p(p) {}
+
+    void SchedDlRlcBufferReq(const SchedDlRlcBufferReqParameters& q) override
+    {
+      m_p->DlBuffer(q);
+      m_p->m_innerSched->SchedDlRlcBufferReq(q);
+    }
+    void SchedDlPagingBufferReq(const SchedDlPagingBufferReqParameters& q) override
+    {
+      m_p->m_innerSched->SchedDlPagingBufferReq(q);
+    }
+    void SchedDlMacBufferReq(const SchedDlMacBufferReqParameters& q) override
+    {
+      m_p->m_innerSched->SchedDlMacBufferReq(q);
+    }
+    void SchedDlTriggerReq(const SchedDlTriggerReqParameters& q) override
+    {
+      m_p->BeginTti(m_p->m_dl, m_p->m_dlBackloggedUes.size());
+      m_p->m_innerSched->SchedDlTriggerReq(q);
+      m_p->EndTti(m_p->m_dl, 0, 0); // no ConfigInd: count the whole call
+    }
+    void SchedDlRachInfoReq(const SchedDlRachInfoReqParameters& q) override
+    {
+      m_p->m_innerSched->SchedDlRachInfoReq(q);
+    }
+    void SchedDlCqiInfoReq(const SchedDlCqiInfoReqParameters& q) override
+    {
+      m_p->m_innerSched->SchedDlCqiInfoReq(q);
+    }
+    void SchedUlTriggerReq(const SchedUlTriggerReqParameters& q) override
+    {
+      m_p->BeginTti(m_p->m_ul, m_p->m_ulBacklog.size());
+      m_p->m_innerSched->SchedUlTriggerReq(q);
+      m_p->EndTti(m_p->m_ul, 0, 0);
+    }
+    void SchedUlNoiseInterferenceReq(const SchedUlNoiseInterferenceReqParameters& q) override
+    {
+      m_p->m_innerSched->SchedUlNoiseInterferenceReq(q);
+    }
+    void SchedUlSrInfoReq(const SchedUlSrInfoReqParameters& q) override
+    {
+      for (const SrListElement_s& sr : q.m_srList)
+      {
+        m_p->m_ulBacklog.insert(sr.m_rnti);
+      }
+      m_p->m_innerSched->SchedUlSrInfoReq(q);
+    }
+    void SchedUlMacCtrlInfoReq(const SchedUlMacCtrlInfoReqParameters& q) override
+    {
+      m_p->UlBsr(q);
+      m_p->m_innerSched->SchedUlMacCtrlInfoReq(q);
+    }
+    void SchedUlCqiInfoReq(const SchedUlCqiInfoReqParameters& q) override
+    {
+      m_p->m_innerSched->SchedUlCqiInfoReq(q);
+    }
+
+  private:
+    InstrumentedFfMacScheduler* m_p;
+  };
+
+  class SchedUser : public FfMacSchedSapUser
+  {
+  public:
+    explicit SchedUser(InstrumentedFfMacScheduler* p) : m_p(p) {}
+
+    void SchedDlConfigInd(const SchedDlConfigIndParameters& q) override
+    {
+      uint32_t rbgs = 0;
+      for (const BuildDataListElement_s& d : q.m_buildDataList)
+      {
+        rbgs += std::bitset<32>(d.m_dci.m_rbBitmap).count();
+      }
+      m_p->EndTti(m_p->m_dl, q.m_buildDataList.size(), rbgs);
+      m_p->m_macSchedUser->SchedDlConfigInd(q);
+    }
+    void SchedUlConfigInd(const SchedUlConfigIndParameters& q) override
+    {
+      uint32_t rbs = 0;
+      for (const UlDciListElement_s& d : q.m_dciList)
+      {
+        rbs += d.m_rbLen;
+      }
+      m_p->EndTti(m_p->m_ul, q.m_dciList.size(), rbs);
+      m_p->m_macSchedUser->SchedUlConfigInd(q);
+    }
+
+  private:
+    InstrumentedFfMacScheduler* m_p;
+  };
+
+  class CschedProvider : public FfMacCschedSapProvider
+  {
+  public:
+    explicit CschedProvider(InstrumentedFfMacScheduler* p) : m_p(p) {}
+
+    void CschedCellConfigReq(const CschedCellConfigReqParameters& q) override
+    {
+      m_p->m_innerCsched->CschedCellConfigReq(q);
+    }
+    void CschedUeConfigReq(const CschedUeConfigReqParameters& q) override
+    {
+      m_p->m_innerCsched->CschedUeConfigReq(q);
+    }
+    void CschedLcConfigReq(const CschedLcConfigReqParameters& q) override
+    {
+      m_p->m_innerCsched->CschedLcConfigReq(q);
+    }
+    void CschedLcReleaseReq(const CschedLcReleaseReqParameters& q) override
+    {
+      m_p->m_innerCsched->CschedLcReleaseReq(q);
+    }
+    void CschedUeReleaseReq(const CschedUeReleaseReqParameters& q) override
+    {
+      m_p->ForgetUe(q.m_rnti);
+      m_p->m_innerCsched->CschedUeReleaseReq(q);
+    }
+
+  private:
+    InstrumentedFfMacScheduler* m_p;
+  };
+
+  std::string m_innerType{"ns3::PfFfMacScheduler"};
+  Ptr<FfMacScheduler> m_inner;
+  FfMacSchedSapProvider*  m_innerSched{nullptr};
+  FfMacCschedSapProvider* m_innerCsched{nullptr};
+  FfMacSchedSapUser*      m_macSchedUser{nullptr};
+
+  SchedProvider  m_schedProvider;
+  SchedUser      m_schedUser;
+  CschedProvider m_cschedProvider;
+
+  std::set<uint32_t> m_dlBackloggedLcs;            // (rnti << 8) | lcid with data
+  std::map<uint16_t, uint32_t> m_dlBackloggedUes;  // rnti → backlogged LCs
+  std::set<uint16_t> m_ulBacklog;                  // rnti with SR / non-empty BSR
+
+  SchedulerProbeStats m_dl;
+  SchedulerProbeStats m_ul;
+  Clock::time_point m_t0;
+  bool m_pending{false};
+};
+
+NS_OBJECT_ENSURE_REGISTERED(InstrumentedFfMacScheduler);
+
+// Sum the probes of all eNBs in 'enbDevs' (devices without a probe are skipped).
+inline uint32_t
+CollectSchedulerProbes(const NetDeviceContainer& enbDevs,
+                       SchedulerProbeStats& dl,
+                       SchedulerProbeStats& ul)
+{
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < enbDevs.GetN(); ++i)
+  {
+    Ptr<LteEnbNetDevice> enb = DynamicCast<LteEnbNetDevice>(enbDevs.Get(i));
+    Ptr<InstrumentedFfMacScheduler> probe =
+        enb ? DynamicCast<InstrumentedFfMacScheduler>(enb->GetFfMacScheduler())
+            : Ptr<InstrumentedFfMacScheduler>();
+    if (probe)
+    {
+      dl.Merge(probe->GetDlStats());
+      ul.Merge(probe->GetUlStats());
+      ++found;
+    }
+  }
+  return found;
+}
+
+} // namespace ns3
+
+#endif // LAB_SCHEDULER_PROBE_H
@@ -0,0 +1,284 @@
+/*
+ * Shared helper — startup-time breakdown (load, static init, CLI, build, first event)
+ * -------------------------------------------------------------
+ * A short sweep case spends a noticeable part of its wall time before the
+ * first simulated event:
+ *
+ *   load        exec() until the dynamic loader has mapped and relocated every
+ *               shared object (a default ns-3 build links each scratch
+ *               program against every enabled module, ~40 libns3 libraries);
+ *   static-init constructors of all those libraries: every TypeId, attribute,
+ *               trace source and log component of every module registers
+ *               itself, whether the program uses the module or not;
+ *   cli         main() up to the end of CommandLine::Parse;
+ *   build       topology, helpers (LteHelper / PointToPointEpcHelper in
+ *               Lab 4), devices, applications;
+ *   first-event Simulator::Run() until the t = 0 initialisation events
+ *               (Object::Initialize of every node and device) have run.
+ *
+ * The phase boundaries are taken with no work on the hot path:
+ *   - an entry in the program's .preinit_array runs after relocation and
+ *     before ANY library constructor, which separates load from static-init;
+ *   - a default-priority constructor of the program runs after all library
+ *     constructors;
+ *   - StartupProfiler::Mark("cli") after cmd.Parse(), and
+ *     StartupProfiler::Running() just before Simulator::Run(). Running()
+ *     schedules a marker event at t = 0 behind everything already scheduled.
+ * The exec time comes from LAB_EXEC_MONO_NS (CLOCK_MONOTONIC ns, set by a
+ * driver right before it starts the process, e.g. lab_startup.py) or, if
+ * that is absent, /proc/self/stat (10 ms resolution).
+ *
+ * Nothing is reported unless LAB_STARTUP_PROFILE is set (not "0"). Then one
+ * line goes to stderr at the first event, or at exit for programs that never
+ * call Running():
+ *
+ *   [startup] Lab4_Cpp_LTE load=0.071 static-init=0.093 cli=0.001 build=0.412 first-event=0.038 total=0.615 s  (52 objects, 38 libns3, 2211 TypeIds)
+ *
+ * LAB_STARTUP_CSV=<path> appends the same numbers as a CSV row.
+ *
+ * The program includes this header from its single translation unit (a
+ * .preinit_array entry is only honoured in the executable).
+ */
+
+#ifndef LAB_STARTUP_PROFILER_H
+#define LAB_STARTUP_PROFILER_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <link.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+class StartupProfiler
+{
+public:
+  // Records the end of a phase named 'name' (e.g. "cli"). Cheap; no-op when disabled.
+  static void Mark(const char* name)
+  {
+    State& s = Get();
+    if (s.enabled && s.marks < kMaxMarks)
+    {
+      s.markName[s.marks] = name;
+      s.markNs[s.marks++] = MonoNs();
+    }
+  }
+
+  // Call right before Simulator::Run(): ends "build" and reports at the first event.
+  static void Running()
+  {
+    State& s = Get();
+    if (!s.enabled || s.running)
+    {
+      return;
+    }
+    s.running = true;
+    Mark("build");
+    Simulator::ScheduleNow(&StartupProfiler::FirstEvent);
+  }
+
+  // Called from the .preinit_array entry below.
+  static void Preinit(int argc, char** argv, char** envp)
+  {
+    State& s = Get();
+    s.preinitNs = MonoNs();
+    s.preinitBootNs = ClockNs(CLOCK_BOOTTIME);
+    s.program = (argc > 0 && argv[0]) ? argv[0] : "?";
+    for (char** e = envp; e && *e; ++e)
+    {
+      if (std::strncmp(*e, "LAB_STARTUP_PROFILE=", 20) == 0)
+      {
+        s.enabled = (*e)[20] != '\0' && std::strcmp(*e + 20, "0") != 0;
+      }
+      else if (std::strncmp(*e, "LAB_EXEC_MONO_NS=", 17) == 0)
+      {
+        s.execNs = std::strtoll(*e + 17, nullptr, 10);
+      }
+    }
+  }
+
+  // Called from the default-priority constructor below.
+  static void StaticInitDone()
+  {
+    State& s = Get();
+    s.staticNs = MonoNs();
+    if (s.enabled)
+    {
+      std::atexit(&StartupProfiler::AtExit);
+    }
+  }
+
+private:
+  static constexpr int kMaxMarks = 8;
+
+  // Plain data: written from .preinit_array, before any constructor runs.
+  struct State
+  {
+    bool        enabled;
+    bool        running;
+    bool        reported;
+    const char* program;
+    int64_t     execNs;         // CLOCK_MONOTONIC at exec (0 = unknown)
+    int64_t     preinitNs;
+    int64_t     preinitBootNs;  // CLOCK_BOOTTIME at preinit, for /proc/self/stat
+    int64_t     staticNs;
+    int         marks;
+    const char* markName[kMaxMarks];
+    int64_t     markNs[kMaxMarks];
+  };
+
+  static State& Get()
+  {
+    static State s; // zero-initialised, so usable from .preinit_array
+    return s;
+  }
+
+  static int64_t ClockNs(clockid_t id)
+  {
+    timespec ts;
+    clock_gettime(id, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  static int64_t MonoNs() { return ClockNs(CLOCK_MONOTONIC); }
+
+  // Seconds from exec to preinit, from LAB_EXEC_MONO_NS or /proc/self/stat.
+  static double LoadSeconds(const State& s)
+  {
+    if (s.execNs > 0)
+    {
+      return (s.preinitNs - s.execNs) * 1e-9;
+    }
+    std::ifstream in("/proc/self/stat");
+    std::string stat((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const size_t paren = stat.rfind(')');
+    if (paren == std::string::npos)
+    {
+      return -1.0;
+    }
+    // Field 22 (starttime) is the 20th after the command name.
+    std::istringstream fields(stat.substr(paren + 2));
+    std::string f;
+    for (int i = 0; i < 20 && fields >> f; ++i)
+    {
+    }
+    const double startBoot = std::strtod(f.c_str(), nullptr) / sysconf(_SC_CLK_TCK);
+    return s.preinitBootNs * 1e-9 - startBoot;
+  }
+
+  static void FirstEvent()
+  {
+    Mark("first-event");
+    Report();
+  }
+
+  static void AtExit()
+  {
+    Mark("exit");
+    Report();
+  }
+
+  // Seconds of the phase ending at mark 'name', or -1 if it was not marked.
+  static double Phase(const State& s, const char* name)
+  {
+    int64_t prev = s.staticNs;
+    for (int i = 0; i < s.marks; ++i)
+    {
+      if (std::strcmp(s.markName[i], name) == 0)
+      {
+        return (s.markNs[i] - prev) * 1e-9;
+      }
+      prev = s.markNs[i];
+    }
+    return -1.0;
+  }
+
+  static void Report()
+  {
+    State& s = Get();
+    if (!s.enabled || s.reported)
+    {
+      return;
+    }
+    s.reported = true;
+
+    int counts[2] = {0, 0}; // shared objects, libns3*
+    dl_iterate_phdr(
+        [](dl_phdr_info* info, size_t, void* data) {
+          int* n = static_cast<int*>(data);
+          ++n[0];
+          n[1] += (info->dlpi_name && std::strstr(info->dlpi_name, "libns3")) ? 1 : 0;
+          return 0;
+        },
+        counts);
+    const uint32_t typeIds = TypeId::GetRegisteredN();
+
+    const char* slash = std::strrchr(s.program, '/');
+    const std::string prog = slash ? slash + 1 : s.program;
+    const double load = LoadSeconds(s);
+    const double staticInit = (s.staticNs - s.preinitNs) * 1e-9;
+    const int64_t last = s.marks > 0 ? s.markNs[s.marks - 1] : s.staticNs;
+    const double total = std::max(load, 0.0) + (last - s.preinitNs) * 1e-9;
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3) << "[startup] " << prog << " load=" << load
+         << " static-init=" << staticInit;
+    int64_t prev = s.staticNs;
+    for (int i = 0; i < s.marks; ++i)
+    {
+      line << " " << s.markName[i] << "=" << (s.markNs[i] - prev) * 1e-9;
+      prev = s.markNs[i];
+    }
+    line << " total=" << total << " s  (" << counts[0] << " objects, " << counts[1]
+         << " libns3, " << typeIds << " TypeIds)";
+
+    // program,load_s,static_init_s,cli_s,build_s,first_event_s,total_s,objects,libns3,typeids
+    // (-1 = phase not marked by the program)
+    // Written and closed BEFORE the stderr line: lab_startup.py kills the
+    // process as soon as it reads that line.
+    if (const char* csv = std::getenv("LAB_STARTUP_CSV"))
+    {
+      std::ofstream out(csv, std::ios::app);
+      out << prog << "," << load << "," << staticInit << "," << Phase(s, "cli") << ","
+          << Phase(s, "build") << "," << Phase(s, "first-event") << "," << total << ","
+          << counts[0] << "," << counts[1] << "," << typeIds << "\n";
+      out.close();
+    }
+    std::cerr << line.str() << std::endl;
+  }
+};
+
+namespace startup_detail
+{
+static void
+Preinit(int argc, char** argv, char** envp)
+{
+  StartupProfiler::Preinit(argc, argv, envp);
+}
+
+__attribute__((section(".preinit_array"), used)) static void (*const kPreinit)(int, char**, char**) =
+    &Preinit;
+
+__attribute__((constructor)) static void
+StaticInitDone()
+{
+  StartupProfiler::StaticInitDone();
+}
+} // namespace startup_detail
+
+} // namespace ns3
+
+#endif // LAB_STARTUP_PROFILER_H
@@ -0,0 +1,369 @@
+/*
+ * Shared helper — precomputed gain tables for the analytic antenna patterns
+ * -------------------------------------------------------------
+ * CosineAntennaModel and ParabolicAntennaModel evaluate pow/cos/log10 on every
+ * GetGainDb() call. The spectrum channel calls it twice (tx and rx) for every
+ * receiver of every transmission, so in a multi-cell run the antenna
+ * arithmetic grows with cells x UEs x TTIs.
+ *
+ * Both patterns are separable in dB, relative to the boresight:
+ *
+ *   G(phi, theta) = H(phi - orientation) + V(theta)
+ *
+ * AntennaGainTable samples H on a uniform azimuth grid and V on a uniform
+ * inclination grid. A lookup is then a wrap, one multiply and (with
+ * interpolation) a linear blend. Build() refines the grid until the table is
+ * within maxErrorDb of the analytic pattern at every bin midpoint (the worst
+ * case for interpolation) and at 4096 random directions (which also checks
+ * separability); a sampled check, not a proof. Gains more than floorDb below
+ * the peak are clamped to that level in both the table and the check (default
+ * 60 dB).
+ * The cosine pattern falls to -inf dB at the back lobe, while real sector
+ * antennas have a 20-30 dB front-to-back ratio. The bins hold the pattern down
+ * to a further 100 dB below the floor, and the clamp is applied after
+ * interpolation, so the steep slope into the back lobe does not add a kink.
+ *
+ * TabulatedAntennaModel is the ns-3 AntennaModel front end. It builds the
+ * analytic model named by "Pattern" with Orientation 0, tabulates it on first
+ * use, and applies "Orientation" as an offset, so rotating a sector never
+ * rebuilds the table. Tables are shared by every antenna in the process whose
+ * Pattern / Beamwidth / VerticalBeamwidth / MaxAttenuation / Step /
+ * Interpolate / MaxError / Floor match, so the 21 sectors of a 7-site drop
+ * build one table between them:
+ *
+ *   lte->SetEnbAntennaModelType("ns3::TabulatedAntennaModel");
+ *   lte->SetEnbAntennaModelAttribute("Pattern",   StringValue("ns3::ParabolicAntennaModel"));
+ *   lte->SetEnbAntennaModelAttribute("Beamwidth", DoubleValue(70.0));
+ *   lte->SetEnbAntennaModelAttribute("Step",      DoubleValue(1.0));   // initial grid, degrees
+ *   lte->SetEnbAntennaModelAttribute("MaxError",  DoubleValue(0.05));  // dB
+ *
+ * Beamwidth, VerticalBeamwidth and MaxAttenuation left at 0 keep the analytic
+ * model's own defaults, so a tabulated antenna is the same antenna as the
+ * analytic one with the same attributes.
+ */
+
+#ifndef LAB_TABULATED_ANTENNA_H
+#define LAB_TABULATED_ANTENNA_H
+
+#include "ns3/core-module.h"
+#include "ns3/antenna-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------- Pure table (no ns-3 objects; usable from worker threads) ----------
+class AntennaGainTable
+{
+public:
+  // gain(azimuth, inclination) in dB, radians, boresight at azimuth 0.
+  using Pattern = std::function<double(double, double)>;
+
+  static constexpr double kMinStepDeg = 0.01;
+
+  // Returns false when even kMinStepDeg does not meet maxErrorDb (e.g. a
+  // non-separable pattern); the table then holds the finest grid tried.
+  bool Build(const Pattern& pattern, double stepDeg, bool interpolate,
+             double maxErrorDb, double floorDb = 60.0)
+  {
+    m_interpolate = interpolate;
+    m_peak = pattern(0.0, M_PI / 2);
+    m_floor = m_peak - floorDb;
+    m_store = m_floor - 100.0;
+    double step = std::max(stepDeg, kMinStepDeg);
+    for (;;)
+    {
+      Fill(pattern, step);
+      m_maxError = MeasureError(pattern);
+      if (m_maxError <= maxErrorDb)
+      {
+        return true;
+      }
+      if (step <= kMinStepDeg)
+      {
+        return false;
+      }
+      step = std::max(step / 2, kMinStepDeg);
+    }
+  }
+
+  // az relative to boresight (any range), inclination in [0, pi].
+  double GainDb(double az, double incl) const
+  {
+    double x = az * m_hInv + m_hOrigin;
+    x -= m_hN * std::floor(x * m_hNInv);   // wrap into [0, nh)
+    const double g = Lookup(m_h, x, m_hN) +
+                     (m_flatV ? 0.0 : Lookup(m_v, incl * m_vInv, m_vN));
+    return std::max(g, m_floor);
+  }
+
+  double   GetStepDeg() const { return m_stepDeg; }
+  double   GetMaxErrorDb() const { return m_maxError; }
+  size_t   GetEntries() const { return m_h.size() + m_v.size(); }
+  size_t   GetMemoryBytes() const { return GetEntries() * sizeof(double); }
+
+private:
+  void Fill(const Pattern& pattern, double stepDeg)
+  {
+    const size_t nh = static_cast<size_t>(std::ceil(360.0 / stepDeg));
+    const size_t nv = static_cast<size_t>(std::ceil(180.0 / stepDeg));
+    m_stepDeg = 360.0 / nh;
+    m_hInv = nh / (2 * M_PI);
+    m_hOrigin = nh / 2.0;            // index of azimuth 0
+    m_vInv = nv / M_PI;
+    m_hN = static_cast<double>(nh);
+    m_hNInv = 1.0 / nh;
+    m_vN = static_cast<double>(nv);
+
+    // H over [-pi, pi] at the horizon; entry nh closes the circle.
+    m_h.resize(nh + 1);
+    for (size_t i = 0; i <= nh; ++i)
+    {
+      const double az = -M_PI + 2 * M_PI * i / nh;
+      m_h[i] = std::max(pattern(az, M_PI / 2), m_store);
+    }
+    // V over [0, pi] on boresight, relative to the horizon.
+    m_v.resize(nv + 1);
+    m_flatV = true;
+    for (size_t j = 0; j <= nv; ++j)
+    {
+      m_v[j] = std::max(pattern(0.0, M_PI * j / nv), m_store) - m_peak;
+      m_flatV = m_flatV && m_v[j] == 0.0;
+    }
+  }
+
+  double MeasureError(const Pattern& pattern) const
+  {
+    double worst = 0.0;
+    auto check = [&](double az, double incl) {
+      const double ref = std::max(pattern(az, incl), m_floor);
+      worst = std::max(worst, std::abs(GainDb(az, incl) - ref));
+    };
+    const size_t nh = m_h.size() - 1;
+    for (size_t i = 0; i < nh; ++i)
+    {
+      check(-M_PI + 2 * M_PI * (i + 0.5) / nh, M_PI / 2);
+    }
+    const size_t nv = m_v.size() - 1;
+    for (size_t j = 0; j < nv; ++j)
+    {
+      check(0.0, M_PI * (j + 0.5) / nv);
+    }
+    std::mt19937_64 rng(12345);      // fixed: independent of the ns-3 RNG streams
+    std::uniform_real_distribution<double> uAz(-M_PI, M_PI), uIncl(0.0, M_PI);
+    for (int k = 0; k < 4096; ++k)
+    {
+      check(uAz(rng), uIncl(rng));
+    }
+    return worst;
+  }
+
+  // x is the fractional index into t (n + 1 entries), clamped to [0, n].
+  double Lookup(const std::vector<double>& t, double x, double n) const
+  {
+    x = std::min(std::max(x, 0.0), n);
+    if (!m_interpolate)
+    {
+      return t[static_cast<size_t>(x + 0.5)];
+    }
+    const size_t i = std::min(static_cast<size_t>(x), t.size() - 2);
+    const double f = x - i;
+    return t[i] + f * (t[i + 1] - t[i]);
+  }
+
+  std::vector<double> m_h, m_v;
+  double m_hInv{0.0}, m_hOrigin{0.0}, m_vInv{0.0}, m_hN{1.0}, m_hNInv{1.0}, m_vN{1.0};
+  double m_peak{0.0}, m_floor{-std::numeric_limits<double>::infinity()}, m_store{0.0};
+  double m_stepDeg{0.0}, m_maxError{0.0};
+  bool   m_interpolate{true};
+  bool   m_flatV{true};
+};
+
+// ---------- ns-3 AntennaModel front end ----------
+class TabulatedAntennaModel : public AntennaModel
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+        TypeId("ns3::TabulatedAntennaModel")
+            .SetParent<AntennaModel>()
+            .SetGroupName("Antenna")
+            .AddConstructor<TabulatedAntennaModel>()
+            .AddAttribute("Pattern",
+                          "TypeId of the analytic antenna model being tabulated.",
+                          StringValue("ns3::ParabolicAntennaModel"),
+                          MakeStringAccessor(&TabulatedAntennaModel::SetPattern,
+                                             &TabulatedAntennaModel::GetPattern),
+                          MakeStringChecker())
+            .AddAttribute("Orientation",
+                          "Boresight azimuth in degrees (applied as a table offset).",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetOrientation,
+                                             &TabulatedAntennaModel::GetOrientation),
+                          MakeDoubleChecker<double>(-360.0, 360.0))
+            .AddAttribute("Beamwidth",
+                          "Horizontal 3 dB beamwidth in degrees (0 = pattern default).",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetBeamwidth,
+                                             &TabulatedAntennaModel::GetBeamwidth),
+                          MakeDoubleChecker<double>(0.0, 360.0))
+            .AddAttribute("VerticalBeamwidth",
+                          "Cosine pattern only: vertical beamwidth in degrees (0 = default).",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetVerticalBeamwidth,
+                                             &TabulatedAntennaModel::GetVerticalBeamwidth),
+                          MakeDoubleChecker<double>(0.0, 360.0))
+            .AddAttribute("MaxAttenuation",
+                          "Parabolic pattern only: attenuation floor in dB (0 = default).",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetMaxAttenuation,
+                                             &TabulatedAntennaModel::GetMaxAttenuation),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Step",
+                          "Initial angular grid in degrees; refined until MaxError holds.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetStep,
+                                             &TabulatedAntennaModel::GetStep),
+                          MakeDoubleChecker<double>(AntennaGainTable::kMinStepDeg, 90.0))
+            .AddAttribute("Interpolate",
+                          "Blend linearly between bins (false = nearest bin).",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&TabulatedAntennaModel::SetInterpolate,
+                                              &TabulatedAntennaModel::GetInterpolate),
+                          MakeBooleanChecker())
+            .AddAttribute("MaxError",
+                          "Largest allowed |table - analytic| in dB.",
+                          DoubleValue(0.05),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetMaxError,
+                                             &TabulatedAntennaModel::GetMaxError),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Floor",
+                          "Gains more than this many dB below the peak are clamped.",
+                          DoubleValue(60.0),
+                          MakeDoubleAccessor(&TabulatedAntennaModel::SetFloor,
+                                             &TabulatedAntennaModel::GetFloor),
+                          MakeDoubleChecker<double>(1.0));
+    return tid;
+  }
+
+  double GetGainDb(Angles a) override
+  {
+    if (m_dirty)
+    {
+      Build();
+    }
+    return m_table->GainDb(a.GetAzimuth() - m_orientationRad, a.GetInclination());
+  }
+
+  // The analytic model with the same shape, oriented at 0 degrees.
+  Ptr<AntennaModel> CreateAnalytic() const
+  {
+    ObjectFactory f(m_pattern);
+    if (m_pattern == "ns3::CosineAntennaModel")
+    {
+      if (m_beamwidth > 0)  f.Set("HorizontalBeamwidth", DoubleValue(m_beamwidth));
+      if (m_vBeamwidth > 0) f.Set("VerticalBeamwidth", DoubleValue(m_vBeamwidth));
+    }
+    else if (m_pattern == "ns3::ParabolicAntennaModel")
+    {
+      if (m_beamwidth > 0)  f.Set("Beamwidth", DoubleValue(m_beamwidth));
+      if (m_maxAtt > 0)     f.Set("MaxAttenuation", DoubleValue(m_maxAtt));
+    }
+    return f.Create<AntennaModel>();
+  }
+
+  // Forces the table now (the first GetGainDb would otherwise do it).
+  const AntennaGainTable& GetTable()
+  {
+    if (m_dirty)
+    {
+      Build();
+    }
+    return *m_table;
+  }
+
+  // Tables built so far in this process (all antennas).
+  static size_t GetSharedTables() { return Registry().size(); }
+
+private:
+  // Finds the shared table for the current shape, or builds it.
+  void Build()
+  {
+    std::ostringstream key;
+    key.precision(17);
+    key << m_pattern << "|" << m_beamwidth << "|" << m_vBeamwidth << "|" << m_maxAtt << "|"
+        << m_step << "|" << m_interpolate << "|" << m_maxError << "|" << m_floorDb;
+    std::shared_ptr<const AntennaGainTable>& shared = Registry()[key.str()];
+    if (!shared)
+    {
+      Ptr<AntennaModel> ref = CreateAnalytic();
+      auto table = std::make_shared<AntennaGainTable>();
+      const bool ok = table->Build(
+          [&ref](double az, double incl) { return ref->GetGainDb(Angles(az, incl)); },
+          m_step, m_interpolate, m_maxError, m_floorDb);
+      NS_ABORT_MSG_IF(!ok, "TabulatedAntennaModel: " << m_pattern << " misses MaxError="
+                           << m_maxError << " dB even at " << AntennaGainTable::kMinStepDeg
+                           << " deg (error " << table->GetMaxErrorDb() << " dB)");
+      shared = table;
+    }
+    m_table = shared;
+    m_dirty = false;
+  }
+
+  static std::map<std::string, std::shared_ptr<const AntennaGainTable>>& Registry()
+  {
+    static std::map<std::string, std::shared_ptr<const AntennaGainTable>> tables;
+    return tables;
+  }
+
+  void SetPattern(std::string v) { m_pattern = v; m_dirty = true; }
+  std::string GetPattern() const { return m_pattern; }
+  void SetOrientation(double deg) { m_orientationDeg = deg; m_orientationRad = deg * M_PI / 180.0; }
+  double GetOrientation() const { return m_orientationDeg; }
+  void SetBeamwidth(double v) { m_beamwidth = v; m_dirty = true; }
+  double GetBeamwidth() const { return m_beamwidth; }
+  void SetVerticalBeamwidth(double v) { m_vBeamwidth = v; m_dirty = true; }
+  double GetVerticalBeamwidth() const { return m_vBeamwidth; }
+  void SetMaxAttenuation(double v) { m_maxAtt = v; m_dirty = true; }
+  double GetMaxAttenuation() const { return m_maxAtt; }
+  void SetStep(double v) { m_step = v; m_dirty = true; }
+  double GetStep() const { return m_step; }
+  void SetInterpolate(bool v) { m_interpolate = v; m_dirty = true; }
+  bool GetInterpolate() const { return m_interpolate; }
+  void SetMaxError(double v) { m_maxError = v; m_dirty = true; }
+  double GetMaxError() const { return m_maxError; }
+  void SetFloor(double v) { m_floorDb = v; m_dirty = true; }
+  double GetFloor() const { return m_floorDb; }
+
+  std::string m_pattern{"ns3::ParabolicAntennaModel"};
+  double m_orientationDeg{0.0};
+  double m_orientationRad{0.0};
+  double m_beamwidth{0.0};
+  double m_vBeamwidth{0.0};
+  double m_maxAtt{0.0};
+  double m_step{1.0};
+  bool   m_interpolate{true};
+  double m_maxError{0.05};
+  double m_floorDb{60.0};
+
+  std::shared_ptr<const AntennaGainTable> m_table;
+  bool m_dirty{true};
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TabulatedAntennaModel);
+
+} // namespace ns3
+
+#endif // LAB_TABULATED_ANTENNA_H
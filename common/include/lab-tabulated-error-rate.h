@@ -0,0 +1,400 @@
+/*
+ * Shared helper — tabulated Wi-Fi chunk success rate (NIST / DSSS models)
+ * -------------------------------------------------------------
+ * The Yans/Spectrum PHY asks the ErrorRateModel for the success rate of every
+ * SNR chunk of every received frame. NistErrorRateModel answers with an erfc
+ * for the uncoded BER plus the convolutional-code union bound: about ten pow()
+ * calls for rate 1/2, more for 2/3 and 3/4. DsssErrorRateModel does exp/pow
+ * per chunk, or a GSL integral for CCK. In a dense, saturated BSS every
+ * station hears every frame, so this math runs for every (frame, receiver)
+ * pair.
+ *
+ * These models are per-bit independent:
+ *
+ *   csr(snr, nbits) = (1 - pe(snr))^nbits = exp(nbits * f(snr)),  f = log(1 - pe)
+ *
+ * ErrorRateTable samples pe once per WifiMode on a uniform SNR grid in dB,
+ * over [MinSnr, MaxSnr], and interpolates log(pe) linearly. log(pe) is smooth
+ * where pe falls over hundreds of decades (high SNR), and near pe = 1 (low
+ * SNR) it is about -(1 - pe), so it also follows the per-bit success rate
+ * there. NIST clamps the union bound with min(pe, 1); Fill() locates the SNR
+ * where the clamp releases by bisection and the lookup interpolates from that
+ * point, so the kink does not fall inside a bin.
+ * A lookup is then log10 + blend + exp + log1p + exp. Outside the grid the
+ * reference model is called directly.
+ *
+ * Build() halves the grid until, at every bin midpoint and at 4096 random
+ * SNRs, the chunk success rate is within MaxError (absolute) of the reference
+ * for EVERY chunk length up to kMaxBits. For two per-bit values f and f',
+ * |exp(n f) - exp(n f')| has a single maximum over n at
+ * n* = log(f'/f) / (f - f'), and that maximum is the error that is checked.
+ * The check is exact in the chunk length but sampled in SNR: MaxError is a
+ * validated target, not a proven bound, and an SNR between the samples can
+ * miss it. GetMaxError() is the largest error the samples found.
+ *
+ * TabulatedErrorRateModel is the ns-3 ErrorRateModel front end. "Reference"
+ * names the analytic model (default ns3::NistErrorRateModel). Tables are built
+ * on the first chunk of each mode and shared by every device in the process
+ * whose Reference / MinSnr / MaxSnr / Step / MaxError match, per mode, channel
+ * width and number of spatial streams (the reference model may use the
+ * TXVECTOR). Installing it on 100 stations builds each mode's table once:
+ *
+ *   phy.SetErrorRateModel("ns3::TabulatedErrorRateModel",
+ *                         "Reference", StringValue("ns3::NistErrorRateModel"),
+ *                         "MaxError",  DoubleValue(1e-4));
+ *
+ * DSSS / HR-DSSS (802.11b): in ns-3.40, ErrorRateModel::GetChunkSuccessRate()
+ * sends these modes straight to the DsssErrorRateModel functions, before
+ * DoGetChunkSuccessRate() is called. The simulation therefore uses the table
+ * for OFDM/ERP-OFDM modes only. Lookup() serves every mode, including DSSS,
+ * and is what the benchmark (Lab2_Cpp_ErrorRateBench) times.
+ */
+
+#ifndef LAB_TABULATED_ERROR_RATE_H
+#define LAB_TABULATED_ERROR_RATE_H
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------- Pure table (no ns-3 objects) ----------
+class ErrorRateTable
+{
+public:
+  // f(snrLinear) = log(per-bit success rate), <= 0.
+  using PerBit = std::function<double(double)>;
+
+  static constexpr double kMinStepDb = 0.001;
+  static constexpr double kMaxBits = 8.0 * 65535; // largest chunk the bound covers
+  static constexpr double kMinPe = 1e-300;        // below: stored as kMinPe
+  static constexpr double kMinF = -700.0;         // per-bit success exp(-700): csr 0
+
+  // Returns false when even kMinStepDb does not meet maxError; the table then
+  // holds the finest grid tried.
+  bool Build(const PerBit& perBit, double minDb, double maxDb, double stepDb, double maxError)
+  {
+    m_minDb = minDb;
+    m_maxDb = maxDb;
+    double step = std::max(stepDb, kMinStepDb);
+    for (;;)
+    {
+      Fill(perBit, step);
+      m_maxError = MeasureError(perBit);
+      if (m_maxError <= maxError)
+      {
+        return true;
+      }
+      if (step <= kMinStepDb)
+      {
+        return false;
+      }
+      step = std::max(step / 2, kMinStepDb);
+    }
+  }
+
+  bool Covers(double snr) const { return snr >= m_minLin && snr <= m_maxLin; }
+
+  // Only for Covers(snr).
+  double PerBitLog(double snr) const
+  {
+    double x = (10.0 * std::log10(snr) - m_minDb) * m_inv;
+    x = std::min(std::max(x, 0.0), m_n);
+    if (x <= m_kinkX)
+    {
+      return kMinF; // pe clamped to 1
+    }
+    const size_t i = std::min(static_cast<size_t>(x), m_h.size() - 2);
+    double h;
+    if (i < m_kinkX)
+    {
+      h = (x - m_kinkX) / (i + 1 - m_kinkX) * m_h[i + 1]; // from log(1) = 0 at the kink
+    }
+    else
+    {
+      h = m_h[i] + (x - i) * (m_h[i + 1] - m_h[i]);
+    }
+    return std::max(std::log1p(-std::exp(h)), kMinF);
+  }
+
+  double ChunkSuccessRate(double snr, uint64_t nbits) const
+  {
+    return std::exp(static_cast<double>(nbits) * PerBitLog(snr));
+  }
+
+  // Largest |exp(n a) - exp(n b)| over 1 <= n <= kMaxBits.
+  static double ChunkErrorBound(double a, double b)
+  {
+    if (a == b)
+    {
+      return 0.0;
+    }
+    double n = kMaxBits;
+    if (a < 0 && b < 0)
+    {
+      n = std::min(std::max(std::log(b / a) / (a - b), 1.0), kMaxBits);
+    }
+    return std::abs(std::exp(n * a) - std::exp(n * b));
+  }
+
+  double GetStepDb() const { return m_stepDb; }
+  double GetMaxError() const { return m_maxError; }
+  size_t GetEntries() const { return m_h.size(); }
+  size_t GetMemoryBytes() const { return m_h.size() * sizeof(double); }
+
+private:
+  // log(pe) from f = log(1 - pe)
+  static double Store(double f) { return std::log(std::min(std::max(-std::expm1(f), kMinPe), 1.0)); }
+
+  void Fill(const PerBit& perBit, double stepDb)
+  {
+    const size_t n = static_cast<size_t>(std::ceil((m_maxDb - m_minDb) / stepDb));
+    m_stepDb = (m_maxDb - m_minDb) / n;
+    m_inv = 1.0 / m_stepDb;
+    m_n = static_cast<double>(n);
+    m_minLin = std::pow(10.0, m_minDb / 10.0);
+    m_maxLin = std::pow(10.0, m_maxDb / 10.0);
+    m_h.resize(n + 1);
+    for (size_t i = 0; i <= n; ++i)
+    {
+      m_h[i] = Store(perBit(std::pow(10.0, (m_minDb + i * m_stepDb) / 10.0)));
+    }
+
+    // Highest SNR where pe is still clamped to 1, if any
+    m_kinkX = -1.0;
+    size_t k = n;
+    while (k > 0 && m_h[k - 1] < 0.0)
+    {
+      --k;
+    }
+    if (k > 0 && k <= n && m_h[k] < 0.0)
+    {
+      double lo = m_minDb + (k - 1) * m_stepDb, hi = m_minDb + k * m_stepDb;
+      for (int it = 0; it < 60; ++it)
+      {
+        const double mid = 0.5 * (lo + hi);
+        (Store(perBit(std::pow(10.0, mid / 10.0))) >= 0.0 ? lo : hi) = mid;
+      }
+      m_kinkX = (lo - m_minDb) * m_inv;
+    }
+  }
+
+  double MeasureError(const PerBit& perBit) const
+  {
+    double worst = 0.0;
+    auto check = [&](double db) {
+      const double snr = std::pow(10.0, db / 10.0);
+      // Same clamps as the bins
+      const double ref = std::max(std::log1p(-std::exp(Store(perBit(snr)))), kMinF);
+      worst = std::max(worst, ChunkErrorBound(PerBitLog(snr), ref));
+    };
+    const size_t n = m_h.size() - 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+      check(m_minDb + (i + 0.5) * m_stepDb);
+    }
+    std::mt19937_64 rng(12345); // fixed: independent of the ns-3 RNG streams
+    std::uniform_real_distribution<double> u(m_minDb, m_maxDb);
+    for (int k = 0; k < 4096; ++k)
+    {
+      check(u(rng));
+    }
+    return worst;
+  }
+
+  std::vector<double> m_h; // log(pe) at m_minDb + i * m_stepDb
+  double m_minDb{0.0}, m_maxDb{0.0}, m_stepDb{0.0}, m_inv{1.0}, m_n{1.0};
+  double m_minLin{0.0}, m_maxLin{0.0};
+  double m_kinkX{-1.0};    // fractional index of the pe = 1 clamp (-1: none)
+  double m_maxError{0.0};
+};
+
+// ---------- ns-3 ErrorRateModel front end ----------
+class TabulatedErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+        TypeId("ns3::TabulatedErrorRateModel")
+            .SetParent<ErrorRateModel>()
+            .SetGroupName("Wifi")
+            .AddConstructor<TabulatedErrorRateModel>()
+            .AddAttribute("Reference",
+                          "TypeId of the analytic error-rate model being tabulated.",
+                          StringValue("ns3::NistErrorRateModel"),
+                          MakeStringAccessor(&TabulatedErrorRateModel::SetReference,
+                                             &TabulatedErrorRateModel::GetReference),
+                          MakeStringChecker())
+            .AddAttribute("MinSnr",
+                          "Lower end of the table in dB (below: reference model).",
+                          DoubleValue(-20.0),
+                          MakeDoubleAccessor(&TabulatedErrorRateModel::SetMinSnr,
+                                             &TabulatedErrorRateModel::GetMinSnr),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MaxSnr",
+                          "Upper end of the table in dB (above: reference model).",
+                          DoubleValue(40.0),
+                          MakeDoubleAccessor(&TabulatedErrorRateModel::SetMaxSnr,
+                                             &TabulatedErrorRateModel::GetMaxSnr),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Step",
+                          "Initial SNR grid in dB; refined until MaxError holds.",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&TabulatedErrorRateModel::SetStep,
+                                             &TabulatedErrorRateModel::GetStep),
+                          MakeDoubleChecker<double>(ErrorRateTable::kMinStepDb, 10.0))
+            .AddAttribute("MaxError",
+                          "Largest |table - reference| chunk success rate allowed at the "
+                          "SNRs Build() samples.",
+                          DoubleValue(1e-4),
+                          MakeDoubleAccessor(&TabulatedErrorRateModel::SetMaxError,
+                                             &TabulatedErrorRateModel::GetMaxError),
+                          MakeDoubleChecker<double>(0.0, 1.0));
+    return tid;
+  }
+
+  // Chunk success rate for any mode, DSSS included; what the PHY gets for
+  // OFDM modes.
+  double Lookup(WifiMode mode, const WifiTxVector& txVector, double snr, uint64_t nbits,
+                uint8_t numRxAntennas = 1, WifiPpduField field = WIFI_PPDU_FIELD_DATA,
+                uint16_t staId = SU_STA_ID) const
+  {
+    const ErrorRateTable& t = GetTable(mode, txVector);
+    if (!t.Covers(snr))
+    {
+      return GetRef()->GetChunkSuccessRate(mode, txVector, snr, nbits, numRxAntennas, field,
+                                           staId);
+    }
+    return t.ChunkSuccessRate(snr, nbits);
+  }
+
+  // Builds (or finds) the shared table of 'mode' at the TXVECTOR's channel
+  // width and number of spatial streams.
+  const ErrorRateTable& GetTable(WifiMode mode, const WifiTxVector& txVector) const
+  {
+    const uint64_t local = (static_cast<uint64_t>(mode.GetUid()) << 32) |
+                           (static_cast<uint64_t>(txVector.GetChannelWidth()) << 8) |
+                           txVector.GetNss();
+    auto it = m_byMode.find(local);
+    if (it != m_byMode.end())
+    {
+      return *it->second;
+    }
+    std::ostringstream key;
+    key.precision(17);
+    key << m_reference << "|" << mode.GetUniqueName() << "|" << txVector.GetChannelWidth() << "|"
+        << static_cast<uint32_t>(txVector.GetNss()) << "|" << m_minDb << "|" << m_maxDb << "|"
+        << m_stepDb << "|" << m_maxError;
+    std::shared_ptr<const ErrorRateTable>& shared = Registry()[key.str()];
+    if (!shared)
+    {
+      Ptr<ErrorRateModel> ref = GetRef();
+      auto table = std::make_shared<ErrorRateTable>();
+      const bool ok = table->Build(
+          [&](double snr) {
+            return std::log(ref->GetChunkSuccessRate(mode, txVector, snr, 1));
+          },
+          m_minDb, m_maxDb, m_stepDb, m_maxError);
+      NS_ABORT_MSG_IF(!ok, "TabulatedErrorRateModel: " << mode.GetUniqueName() << " misses MaxError="
+                           << m_maxError << " even at " << ErrorRateTable::kMinStepDb
+                           << " dB (error " << table->GetMaxError() << ")");
+      shared = table;
+    }
+    m_byMode.emplace(local, shared);
+    return *shared;
+  }
+
+  // Tables built so far in this process (all models).
+  static size_t GetSharedTables() { return Registry().size(); }
+
+private:
+  double DoGetChunkSuccessRate(WifiMode mode, const WifiTxVector& txVector, double snr,
+                               uint64_t nbits, uint8_t numRxAntennas, WifiPpduField field,
+                               uint16_t staId) const override
+  {
+    return Lookup(mode, txVector, snr, nbits, numRxAntennas, field, staId);
+  }
+
+  static std::map<std::string, std::shared_ptr<const ErrorRateTable>>& Registry()
+  {
+    static std::map<std::string, std::shared_ptr<const ErrorRateTable>> tables;
+    return tables;
+  }
+
+  Ptr<ErrorRateModel> GetRef() const
+  {
+    if (!m_ref)
+    {
+      m_ref = ObjectFactory(m_reference).Create<ErrorRateModel>();
+    }
+    return m_ref;
+  }
+
+  void SetReference(std::string v)
+  {
+    m_reference = v;
+    m_ref = nullptr;
+    m_byMode.clear();
+  }
+  std::string GetReference() const { return m_reference; }
+
+  // Every field of the registry key goes through a setter that drops the
+  // per-model cache, so a change after the first lookup takes effect.
+  void SetMinSnr(double v)
+  {
+    m_minDb = v;
+    m_byMode.clear();
+  }
+  double GetMinSnr() const { return m_minDb; }
+
+  void SetMaxSnr(double v)
+  {
+    m_maxDb = v;
+    m_byMode.clear();
+  }
+  double GetMaxSnr() const { return m_maxDb; }
+
+  void SetStep(double v)
+  {
+    m_stepDb = v;
+    m_byMode.clear();
+  }
+  double GetStep() const { return m_stepDb; }
+
+  void SetMaxError(double v)
+  {
+    m_maxError = v;
+    m_byMode.clear();
+  }
+  double GetMaxError() const { return m_maxError; }
+
+  std::string m_reference{"ns3::NistErrorRateModel"};
+  double m_minDb{-20.0};
+  double m_maxDb{40.0};
+  double m_stepDb{0.1};
+  double m_maxError{1e-4};
+
+  mutable Ptr<ErrorRateModel> m_ref;
+  // (mode uid, channel width, NSS) -> table
+  mutable std::unordered_map<uint64_t, std::shared_ptr<const ErrorRateTable>> m_byMode;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TabulatedErrorRateModel);
+
+} // namespace ns3
+
+#endif // LAB_TABULATED_ERROR_RATE_H
@@ -0,0 +1,158 @@
+/*
+ * Shared helper — small fork/join thread pool for data-parallel loops
+ * -------------------------------------------------------------
+ * ns-3 itself is single-threaded; the labs use this pool only for pure,
+ * side-effect-free number crunching outside the event loop (coverage maps,
+ * per-receiver loss computation). The worker threads are started once and
+ * sleep on a condition variable between jobs.
+ *
+ *   ThreadPool pool(0);                        // 0 → std::thread::hardware_concurrency()
+ *   pool.ParallelFor(rows, 1, [&](size_t lo, size_t hi) {
+ *     for (size_t r = lo; r < hi; ++r) { ... }
+ *   });
+ *
+ * ParallelFor hands out chunks of 'grain' indices from an atomic counter, so
+ * uneven chunks balance themselves. The calling thread works too, and the call
+ * returns once every chunk is done. fn must not touch ns-3 objects that are
+ * not thread-safe: Ptr<> reference counts, the simulator and the RNG streams
+ * all count.
+ *
+ * With threads == 1 (or n <= grain) the loop runs inline with no
+ * synchronisation.
+ */
+
+#ifndef LAB_THREAD_POOL_H
+#define LAB_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+class ThreadPool
+{
+public:
+  explicit ThreadPool(unsigned threads = 0)
+  {
+    if (threads == 0)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_workers.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i)
+    {
+      m_workers.emplace_back(&ThreadPool::Worker, this);
+    }
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_workers)
+    {
+      t.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  unsigned GetThreads() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+  // Run fn(lo, hi) over [0, n) in chunks of 'grain'; blocks until all are done.
+  void ParallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& fn)
+  {
+    if (n == 0)
+    {
+      return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (m_workers.empty() || n <= grain)
+    {
+      fn(0, n);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_fn = &fn;
+      m_n = n;
+      m_grain = grain;
+      m_next.store(0, std::memory_order_relaxed);
+      m_pending = m_workers.size();
+      ++m_generation;
+    }
+    m_wake.notify_all();
+    RunChunks();
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_done.wait(lk, [this] { return m_pending == 0; });
+    m_fn = nullptr;
+  }
+
+private:
+  void Worker()
+  {
+    uint64_t seen = 0;
+    for (;;)
+    {
+      {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_wake.wait(lk, [&] { return m_stop || m_generation != seen; });
+        if (m_stop)
+        {
+          return;
+        }
+        seen = m_generation;
+      }
+      RunChunks();
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (--m_pending == 0)
+        {
+          m_done.notify_one();
+        }
+      }
+    }
+  }
+
+  void RunChunks()
+  {
+    for (;;)
+    {
+      const size_t lo = m_next.fetch_add(m_grain, std::memory_order_relaxed);
+      if (lo >= m_n)
+      {
+        return;
+      }
+      (*m_fn)(lo, std::min(lo + m_grain, m_n));
+    }
+  }
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  bool m_stop{false};
+  uint64_t m_generation{0};
+  size_t m_pending{0};
+
+  const std::function<void(size_t, size_t)>* m_fn{nullptr};
+  size_t m_n{0};
+  size_t m_grain{1};
+  std::atomic<size_t> m_next{0};
+};
+
+} // namespace ns3
+
+#endif // LAB_THREAD_POOL_H
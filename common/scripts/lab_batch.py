@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+# Utility: lab_batch
+# Runs a table of lab cases through common/include/lab-batch.h from Python:
+# the parameters go to C++ as one float64 NumPy array, the cases run on
+# forked ns-3 worker processes, and the results come back as NumPy columns.
+# No per-case cppyy calls and no stdout parsing.
+# Usage: lab_batch.py <kernel> --set name=v1,v2,... --set name=start:stop:step ...
+#                     [--workers N] [--csv out.csv]      (all combinations of the --set values)
+#        lab_batch.py --list
+#   e.g.: lab_batch.py lab1-link --set model=0,1,2,3 --set distance_m=10:400:10 \
+#                      --set ant_height_m=1.5 --set seed=1,2,3
+#   from Python:  from lab_batch import run_batch, grid
+#                 res = run_batch("lab1-link", grid(model=[0, 3], distance_m=np.arange(10, 400, 10),
+#                                                   ant_height_m=1.5, seed=[1, 2]))
+#                 res["throughput_bps"]      # or run_batch(..., as_frame=True) for a DataFrame
+
+import argparse
+import os
+import sys
+
+import numpy as np
+
+_INCLUDE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include")
+_lab_batch = None
+
+
+def _cpp():
+    """ns3::LabBatch, compiled into the running cppyy/ns-3 session on first use."""
+    global _lab_batch
+    if _lab_batch is None:
+        from ns import ns
+
+        ns.cppyy.add_include_path(os.path.normpath(_INCLUDE))
+        ns.cppyy.include("lab-batch.h")
+        _lab_batch = ns.cppyy.gbl.ns3.LabBatch
+    return _lab_batch
+
+
+def kernels():
+    return [str(k) for k in _cpp().Kernels()]
+
+
+def kernel_columns(kernel):
+    """(parameter names, output names) of a kernel."""
+    lb = _cpp()
+    params = [str(p) for p in lb.Params(kernel)]
+    if not params:
+        raise KeyError(f"unknown kernel {kernel!r}; known: {', '.join(kernels())}")
+    return params, [str(o) for o in lb.Outputs(kernel)]
+
+
+def grid(**values):
+    """Every combination of the given values, as a dict of equal-length arrays."""
+    axes = [np.atleast_1d(np.asarray(v, dtype=np.float64)) for v in values.values()]
+    mesh = np.meshgrid(*axes, indexing="ij")
+    return {k: m.ravel() for k, m in zip(values, mesh)}
+
+
+def _param_matrix(params, names):
+    """rows x len(names) C-contiguous float64 array from a dict, DataFrame,
+    structured array or plain 2-D array (columns in kernel order)."""
+    if isinstance(params, np.ndarray) and params.dtype.names is None:
+        arr = np.ascontiguousarray(np.atleast_2d(params), dtype=np.float64)
+        if arr.shape[1] != len(names):
+            raise ValueError(f"expected {len(names)} columns ({', '.join(names)}), got {arr.shape[1]}")
+        return arr
+    if isinstance(params, np.ndarray):
+        cols = {n: params[n] for n in params.dtype.names}
+    else:
+        cols = {n: params[n] for n in params.keys()}  # dict or DataFrame
+    missing = [n for n in names if n not in cols]
+    if missing:
+        raise KeyError(f"missing parameters: {', '.join(missing)}")
+    unused = [n for n in cols if n not in names]
+    if unused:
+        raise KeyError(f"unknown parameters: {', '.join(unused)} (expected {', '.join(names)})")
+    # Scalars broadcast against the array columns.
+    bcast = np.broadcast_arrays(*[np.asarray(cols[n], dtype=np.float64) for n in names])
+    return np.ascontiguousarray(np.stack([np.ravel(b) for b in bcast], axis=1))
+
+
+def run_batch(kernel, params, workers=None, as_frame=False):
+    """Run every parameter row of 'kernel'; return a dict of NumPy columns.
+
+    The dict holds the parameters, the kernel outputs (NaN where a row failed)
+    and "status" (0 = done). 'workers' defaults to os.cpu_count(); 0 runs the
+    rows in this process.
+    """
+    names, outputs = kernel_columns(kernel)
+    p = _param_matrix(params, names)
+    rows = p.shape[0]
+    out = np.empty((rows, len(outputs)), dtype=np.float64)
+    status = np.empty(rows, dtype=np.int32)
+    if workers is None:
+        workers = os.cpu_count() or 1
+    failed = _cpp().Run(kernel, p, rows, out, status, int(workers))
+    if failed < 0:
+        raise RuntimeError(f"{kernel}: batch could not run (no worker process started)")
+    if failed:
+        print(f"[lab_batch] WARNING: {failed} of {rows} rows failed (status != 0)", file=sys.stderr)
+
+    res = {n: p[:, i] for i, n in enumerate(names)}
+    res.update({n: out[:, i] for i, n in enumerate(outputs)})
+    res["status"] = status
+    if as_frame:
+        import pandas as pd
+
+        return pd.DataFrame(res)
+    return res
+
+
+def _values(spec):
+    """"1,2,5.5" -> list;  "10:400:10" -> 10, 20, ..., 400 (stop included)."""
+    if ":" in spec:
+        start, stop, step = (float(x) for x in spec.split(":"))
+        return np.arange(start, stop + step / 2, step)
+    return [float(x) for x in spec.split(",")]
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Run a lab-batch.h kernel over a parameter grid")
+    ap.add_argument("kernel", nargs="?")
+    ap.add_argument("--set", action="append", default=[], metavar="NAME=VALUES",
+                    help="v1,v2,... or start:stop:step; repeat per parameter")
+    ap.add_argument("--workers", type=int, default=None, help="worker processes (default: all CPUs)")
+    ap.add_argument("--csv", default=None, help="write the result table here")
+    ap.add_argument("--list", action="store_true", help="print the kernels and their columns")
+    opt = ap.parse_args()
+
+    if opt.list:
+        for k in kernels():
+            params, outputs = kernel_columns(k)
+            print(f"{k}: {', '.join(params)} -> {', '.join(outputs)}")
+        return
+    if not opt.kernel:
+        ap.error("missing kernel (see --list)")
+
+    values = {}
+    for s in opt.set:
+        name, _, spec = s.partition("=")
+        if not spec:
+            ap.error(f"--set {s}: expected NAME=VALUES")
+        values[name] = _values(spec)
+    df = run_batch(opt.kernel, grid(**values), opt.workers, as_frame=True)
+    if opt.csv:
+        df.to_csv(opt.csv, index=False)
+        print(f"CSV written: {opt.csv} ({len(df)} rows)")
+    else:
+        print(df.to_string(max_rows=40))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# Utility: lab_startup
+# Time-to-first-event of a lab binary, split into the phases reported by
+# common/include/lab-startup-profiler.h: load, static-init, cli, build and
+# first-event. Runs the binary --runs times with LAB_STARTUP_PROFILE=1, passes
+# the exec time (LAB_EXEC_MONO_NS) so "load" is exact, and stops each run at
+# its first event unless --full is given. Prints the median of every phase.
+# --against <binary> runs a second build of the same program with the same
+# flags (e.g. before/after scripts/lab_modules.sh) and prints both medians and
+# the change of each phase.
+# Usage: lab_startup.py [--runs 10] [--full] [--csv out.csv] [--against <binary>] -- <binary> [flags...]
+#   e.g.: lab_startup.py --runs 20 -- build/scratch/ns3.40-Lab4_Cpp_LTE-optimized --simTime=9
+
+import argparse
+import csv
+import os
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+COLUMNS = ["load_s", "static_init_s", "cli_s", "build_s", "first_event_s", "total_s"]
+_PHASE = {"load": "load_s", "static-init": "static_init_s", "cli": "cli_s", "build": "build_s",
+          "first-event": "first_event_s", "total": "total_s"}
+_LINE = re.compile(r"^\[startup\] (?P<prog>\S+) (?P<phases>.*?) s\s+\((?P<objects>\d+) objects, "
+                   r"(?P<libns3>\d+) libns3, (?P<typeids>\d+) TypeIds\)")
+
+
+def parse_line(line):
+    """One run's numbers from the [startup] stderr line (-1 = phase not marked)."""
+    m = _LINE.match(line)
+    if not m:
+        return None
+    row = {"program": m["prog"]}
+    row.update({c: -1.0 for c in COLUMNS})
+    for kv in m["phases"].split():
+        name, _, value = kv.partition("=")
+        if name in _PHASE:
+            row[_PHASE[name]] = float(value)
+    row.update(objects=m["objects"], libns3=m["libns3"], typeids=m["typeids"])
+    return row
+
+
+def run_once(cmd, full):
+    # The stderr line is parsed here, so killing the child right after it
+    # cannot lose the run.
+    env = dict(os.environ, LAB_STARTUP_PROFILE="1")
+    env["LAB_EXEC_MONO_NS"] = str(time.monotonic_ns())
+    proc = subprocess.Popen(cmd, env=env, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                            text=True)
+    row = None
+    for line in proc.stderr:
+        if line.startswith("[startup]"):
+            row = parse_line(line)
+            if not full:
+                proc.kill()
+                break
+    proc.wait()
+    return row
+
+
+def measure(cmd, runs, full):
+    rows = [r for r in (run_once(cmd, full) for _ in range(runs)) if r]
+    if not rows:
+        sys.exit(f"{cmd[0]}: no [startup] report: is lab-startup-profiler.h included?")
+    return rows
+
+
+def medians(rows):
+    out = {}
+    for c in COLUMNS:
+        vals = [float(r[c]) for r in rows if float(r[c]) >= 0]
+        out[c] = (statistics.median(vals), min(vals)) if vals else None
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Startup breakdown of a lab binary")
+    ap.add_argument("--runs", type=int, default=10)
+    ap.add_argument("--full", action="store_true", help="let every run finish")
+    ap.add_argument("--csv", default=None, help="write one row per run here")
+    ap.add_argument("--against", default=None, metavar="BINARY",
+                    help="baseline build of the same program, run with the same flags")
+    ap.add_argument("cmd", nargs=argparse.REMAINDER)
+    opt = ap.parse_args()
+    cmd = opt.cmd[1:] if opt.cmd[:1] == ["--"] else opt.cmd
+    if not cmd:
+        ap.error("missing binary")
+
+    runs = measure(cmd, opt.runs, opt.full)
+    base = measure([opt.against] + cmd[1:], opt.runs, opt.full) if opt.against else None
+
+    print(f"{runs[0]['program']}: {len(runs)} runs, {runs[0]['objects']} shared objects "
+          f"({runs[0]['libns3']} libns3), {runs[0]['typeids']} TypeIds")
+    if base:
+        print(f"baseline {opt.against}: {base[0]['objects']} shared objects "
+              f"({base[0]['libns3']} libns3), {base[0]['typeids']} TypeIds")
+    med = medians(runs)
+    bmed = medians(base) if base else {}
+    for c in COLUMNS:
+        if med[c] is None:
+            continue
+        line = f"  {c:<14} median {med[c][0] * 1e3:9.1f} ms   min {med[c][1] * 1e3:9.1f} ms"
+        if bmed.get(c):
+            b = bmed[c][0]
+            change = f"{(med[c][0] - b) / b * 100:+6.1f} %" if b > 0 else "   n/a"
+            line += f"   baseline {b * 1e3:9.1f} ms  {change}"
+        print(line)
+    if opt.csv:
+        with open(opt.csv, "w", newline="") as fh:
+            w = csv.DictWriter(fh, fieldnames=["build"] + list(runs[0].keys()))
+            w.writeheader()
+            w.writerows(dict(r, build="target") for r in runs)
+            w.writerows(dict(r, build="baseline") for r in base or [])
+        print(f"CSV written: {opt.csv}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# Utility: labcol
+# Reads the columnar binary tables written by common/include/lab-columnar.h
+# (e.g. LteBearerStats.labcol from Lab 4), and result directories written by
+# common/include/lab-results.h (--results=<dir>): the merged table of a schema
+# plus its not-yet-merged segments, under a shared lock, as one DataFrame.
+# Usage: labcol.py <file.labcol | results dir> [--schema lab3-tcp] [--csv out.csv]
+#   from Python:  from labcol import read_labcol; df, meta = read_labcol("x.labcol")
+#                 from labcol import read_results; df = read_results("res/", "lab3-tcp")
+
+import fcntl
+import os
+import re
+import struct
+import sys
+
+import numpy as np
+
+_TYPES = {1: np.dtype("<u4"), 2: np.dtype("<u8"), 3: np.dtype("<f8"), 4: np.dtype("<u4")}
+_STR = 4
+_SEGMENT = re.compile(r"^(?P<schema>.+)\.v(?P<version>\d+)\.(?P<writer>[^.]+)\.seg\.labcol$")
+_MERGED = re.compile(r"^(?P<schema>.+)\.v(?P<version>\d+)\.labcol$")
+
+
+def read_labcol(path):
+    """Return (pandas.DataFrame, dict of metadata) for a .labcol file."""
+    import pandas as pd
+
+    with open(path, "rb") as f:
+        buf = f.read()
+    if buf[:8] != b"LABCOL01":
+        raise ValueError(f"{path}: not a LABCOL01 file")
+    pos = 8
+
+    def take(fmt):
+        nonlocal pos
+        vals = struct.unpack_from(fmt, buf, pos)
+        pos += struct.calcsize(fmt)
+        return vals[0]
+
+    def take_str(len_fmt):
+        nonlocal pos
+        n = take(len_fmt)
+        s = buf[pos:pos + n].decode()
+        pos += n
+        return s
+
+    meta = {}
+    for _ in range(take("<I")):
+        k = take_str("<H")
+        meta[k] = take_str("<I")
+
+    ncols = take("<I")
+    nrows = take("<Q")
+    cols = []
+    for _ in range(ncols):
+        name = take_str("<H")
+        cols.append((name, take("<B")))
+
+    data = {}
+    for name, t in cols:
+        dt = _TYPES[t]
+        data[name] = np.frombuffer(buf, dtype=dt, count=nrows, offset=pos)
+        pos += nrows * dt.itemsize
+        if t == _STR:
+            values = [take_str("<I") for _ in range(take("<I"))]
+            data[name] = pd.Categorical.from_codes(data[name].astype(np.int64), values)
+    return pd.DataFrame(data), meta
+
+
+def read_results(path, schema=None, version=None):
+    """Return one DataFrame with every row of 'schema' in a lab-results.h directory.
+
+    'version' defaults to the newest one present. Rows of a segment whose
+    columns differ from the merged table are skipped with a warning.
+    """
+    import pandas as pd
+
+    found = {}
+    for n in os.listdir(path):
+        m = _SEGMENT.match(n) or _MERGED.match(n)
+        if m:
+            found.setdefault((m["schema"], int(m["version"])), []).append(n)
+    keys = sorted(k for k in found if schema is None or k[0] == schema)
+    if not keys:
+        raise FileNotFoundError(f"{path}: no results" + (f" for schema {schema}" if schema else ""))
+    if schema is None and len({k[0] for k in keys}) > 1:
+        raise ValueError(f"{path}: several schemas {sorted({k[0] for k in keys})}; pass schema=")
+    key = keys[-1] if version is None else (keys[0][0], int(version))
+    prefix = f"{key[0]}.v{key[1]}"
+
+    with open(os.path.join(path, ".lock"), "a+") as lock:
+        fcntl.flock(lock, fcntl.LOCK_SH)
+        names = [n for n in os.listdir(path) if n.startswith(prefix + ".")]
+        frames, columns, merged_in = [], None, set()
+        merged = os.path.join(path, prefix + ".labcol")
+        if os.path.exists(merged):
+            df, meta = read_labcol(merged)
+            frames.append(df)
+            columns = list(df.columns)
+            merged_in = set(filter(None, meta.get("segments", "").split(",")))
+        for n in sorted(names):
+            if not _SEGMENT.match(n) or n in merged_in:
+                continue
+            df, _ = read_labcol(os.path.join(path, n))
+            if columns is not None and list(df.columns) != columns:
+                print(f"[labcol] WARNING: {n}: columns differ from {prefix}; skipped", file=sys.stderr)
+                continue
+            columns = list(df.columns)
+            frames.append(df)
+    out = pd.concat(frames, ignore_index=True)
+    for c in out.columns:
+        if isinstance(frames[0][c].dtype, pd.CategoricalDtype):
+            out[c] = out[c].astype("category")
+    return out
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Usage: labcol.py <file.labcol | results dir> [--schema name] [--csv out.csv]")
+        sys.exit(1)
+    if os.path.isdir(sys.argv[1]):
+        schema = sys.argv[sys.argv.index("--schema") + 1] if "--schema" in sys.argv else None
+        df = read_results(sys.argv[1], schema)
+        print(f"# rows: {len(df)}")
+    else:
+        df, meta = read_labcol(sys.argv[1])
+        for k, v in meta.items():
+            print(f"# {k}: {v}")
+    if "--csv" in sys.argv:
+        out = sys.argv[sys.argv.index("--csv") + 1]
+        df.to_csv(out, index=False)
+        print(f"CSV written: {out}")
+    else:
+        print(df.to_string(max_rows=40))
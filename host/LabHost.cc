@@ -0,0 +1,288 @@
+/*
+ * Lab host — every Lab 0–4 C++ program in one executable
+ * -------------------------------------------------------------
+ * A sweep starts one process per case. With a default ns-3 build each start
+ * maps and relocates ~40 libns3 shared objects and registers every TypeId
+ * before main() (see lab-startup-profiler.h). lab-host is built once from all
+ * lab sources (host/CMakeLists.txt) and, with ns-3 configured
+ * --enable-static, is one self-contained file: nothing to load at start-up
+ * and a single artifact for a sweep runner to ship.
+ *
+ * It can also run several scenarios back-to-back in one process. Between two
+ * scenarios it restores what a fresh process would see, the same way ns-3's
+ * test runner does between test cases:
+ *  - Simulator::Destroy() (node/channel lists, MAC address allocation);
+ *  - Config::Reset(): attribute defaults and globals (RngSeed, RngRun, ...);
+ *  - RngSeedManager::ResetNextStreamIndex(), so automatic stream numbers, and
+ *    therefore results, match a standalone run of the same command line;
+ *  - Names::Clear(), Ipv4/Ipv6AddressGenerator::Reset();
+ *  - the pool allocator switch (on for programs that install the pool, off
+ *    for the others, as in their own binaries).
+ * A scenario that aborts (NS_FATAL_ERROR, NS_ABORT_MSG) still ends the process.
+ *
+ * Run (examples):
+ *   --run "lab-host --list"
+ *   --run "lab-host --scenario=lab3-chain --numNodes=8 --seed=2"
+ *   --run "lab-host --scenario=lab1-friis,lab1-tworay"         (same flags for each)
+ *   --run "lab-host --batch=runs.txt"
+ *
+ * Batch file: one scenario per line, "<name> [--flag=value ...]", split on
+ * whitespace (no quoting); blank lines and lines starting with '#' are skipped.
+ *
+ * Key CLI flags (everything else is passed to the scenario):
+ *   --scenario : scenario name, or a comma-separated list
+ *   --batch    : file with one "<name> [flags]" line per scenario
+ *   --list     : print the scenario names and exit
+ *
+ * Per scenario, "[host] <name> exit=<code> wall=<s>" goes to stderr, so stdout
+ * of a single scenario is exactly that of the standalone program. The exit
+ * status is 0 only if every scenario returned 0.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+#include "lab-pool-allocator.h"   // operators for all scenarios (LAB_POOL_NO_OPERATORS in each)
+#include "lab-proc-stats.h"       // wall clock per scenario
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+LAB_POOL_INSTALL_OPERATORS()
+
+// ---------- Scenario registry (generated by host/CMakeLists.txt) ----------
+
+#define LAB_SCENARIO(name, symbol, pool) int LabHostEntry_##symbol(int argc, char* argv[]);
+#include "lab-host-scenarios.inc"
+#undef LAB_SCENARIO
+
+namespace
+{
+
+struct ScenarioEntry
+{
+  const char* name;
+  int (*entry)(int, char*[]);
+  bool usesPool;  // the program installs the pool operators itself
+};
+
+const ScenarioEntry kScenarios[] = {
+#define LAB_SCENARIO(name, symbol, pool) {name, &LabHostEntry_##symbol, pool},
+#include "lab-host-scenarios.inc"
+#undef LAB_SCENARIO
+};
+
+// Names used in the lab handouts for programs whose file name differs.
+const struct
+{
+  const char* alias;
+  const char* name;
+} kAliases[] = {
+  {"lab3-chain", "lab3-adhoc"},
+};
+
+struct Job
+{
+  std::string name;
+  std::vector<std::string> args;
+};
+
+const ScenarioEntry*
+Find(std::string name)
+{
+  for (const auto& a : kAliases)
+  {
+    if (name == a.alias)
+    {
+      name = a.name;
+    }
+  }
+  for (const auto& s : kScenarios)
+  {
+    if (name == s.name)
+    {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<std::string>
+Split(const std::string& s, char sep)
+{
+  std::vector<std::string> out;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, sep))
+  {
+    if (!item.empty())
+    {
+      out.push_back(item);
+    }
+  }
+  return out;
+}
+
+// Back to the state of a fresh process (see the header comment).
+void
+ResetBetweenScenarios()
+{
+  Simulator::Destroy();
+  Config::Reset();
+  RngSeedManager::ResetNextStreamIndex();
+  Names::Clear();
+  Ipv4AddressGenerator::Reset();
+  Ipv6AddressGenerator::Reset();
+  PoolAllocator::EndCase();
+}
+
+int
+RunJob(const Job& job, const ScenarioEntry& s)
+{
+  // argv[0] is the scenario name, so --help and error messages name it.
+  std::vector<std::string> words{job.name};
+  words.insert(words.end(), job.args.begin(), job.args.end());
+  std::vector<char*> argv;
+  for (auto& w : words)
+  {
+    argv.push_back(&w[0]);
+  }
+  argv.push_back(nullptr);
+
+  PoolAllocator::SetEnabled(s.usesPool);
+  const double t0 = GetWallClockSeconds();
+  int rc = 1;
+  try
+  {
+    rc = s.entry(static_cast<int>(words.size()), argv.data());
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "ERROR: " << job.name << ": " << e.what() << "\n";
+  }
+  const double wall = GetWallClockSeconds() - t0;
+  ResetBetweenScenarios();
+
+  std::cerr << "[host] " << job.name << " exit=" << rc << " wall=" << std::fixed
+            << std::setprecision(3) << wall << "\n";
+  std::cerr.unsetf(std::ios::floatfield);
+  return rc;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  // -------- Host flags; the rest belongs to the scenario --------
+  std::string scenarios;
+  std::string batchFile;
+  bool list = false;
+  std::vector<std::string> passThrough;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string a = argv[i];
+    if (a.rfind("--scenario=", 0) == 0)
+    {
+      scenarios = a.substr(11);
+    }
+    else if (a.rfind("--batch=", 0) == 0)
+    {
+      batchFile = a.substr(8);
+    }
+    else if (a == "--list")
+    {
+      list = true;
+    }
+    else
+    {
+      passThrough.push_back(a);
+    }
+  }
+
+  if (list)
+  {
+    for (const auto& s : kScenarios)
+    {
+      std::cout << s.name << "\n";
+    }
+    for (const auto& a : kAliases)
+    {
+      std::cout << a.alias << " -> " << a.name << "\n";
+    }
+    return 0;
+  }
+
+  // -------- Job list --------
+  std::vector<Job> jobs;
+  for (const auto& name : Split(scenarios, ','))
+  {
+    jobs.push_back({name, passThrough});
+  }
+  if (!batchFile.empty())
+  {
+    std::ifstream in(batchFile);
+    if (!in)
+    {
+      std::cerr << "ERROR: cannot open --batch file " << batchFile << "\n";
+      return 1;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+      std::istringstream words(line);
+      Job job;
+      if (!(words >> job.name) || job.name[0] == '#')
+      {
+        continue;
+      }
+      for (std::string w; words >> w;)
+      {
+        job.args.push_back(w);
+      }
+      jobs.push_back(job);
+    }
+  }
+  if (jobs.empty())
+  {
+    std::cerr << "ERROR: give --scenario=<name>[,<name>...] or --batch=<file> (--list for names).\n";
+    return 1;
+  }
+  if (!batchFile.empty() && !passThrough.empty())
+  {
+    std::cerr << "ERROR: with --batch, put scenario flags in the batch file.\n";
+    return 1;
+  }
+
+  // Check every name before running anything.
+  for (const auto& job : jobs)
+  {
+    if (Find(job.name) == nullptr)
+    {
+      std::cerr << "ERROR: unknown scenario '" << job.name << "' (see --list).\n";
+      return 1;
+    }
+  }
+
+  // -------- Run back-to-back --------
+  uint32_t failed = 0;
+  const double t0 = GetWallClockSeconds();
+  for (const auto& job : jobs)
+  {
+    failed += RunJob(job, *Find(job.name)) != 0 ? 1 : 0;
+  }
+  if (jobs.size() > 1)
+  {
+    std::cerr << "[host] " << jobs.size() << " scenarios, " << failed << " failed, wall="
+              << std::fixed << std::setprecision(3) << GetWallClockSeconds() - t0 << "\n";
+  }
+  return failed == 0 ? 0 : 1;
+}
@@ -43,6 +43,10 @@ if ($OpenFileDialog.ShowDialog() -eq [System.Windows.Forms.DialogResult]::OK) {
     # Copy the selected file into ./exec/
     Copy-Item -Path $selectedFile -Destination $execDir -Force
     Write-Host "Copied $selectedFile to $execDir"
+
+    # Shared lab headers (lab-*.h) must sit next to the .cc
+    Copy-Item -Path (Join-Path (Get-Location) "common/include/*.h") -Destination $execDir -Force
+    Write-Host "Copied common/include/*.h to $execDir"
 } else {
     Write-Host "No file selected. Exiting script."
     exit
@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+# Utility: lab_modules
+# Lists the ns-3 modules that the given lab programs include, either directly
+# or through common/include/lab-*.h. With --configure it reconfigures $NS3_DIR
+# to build only those modules; ns-3 adds their dependencies itself.
+#
+# A default build links every scratch program against every enabled module.
+# Each run then maps ~40 libns3 libraries and registers every TypeId in them
+# before main(), whether the program uses the module or not. With only the
+# needed modules, fewer libraries are loaded and initialised; measure what that
+# gains on your machine by keeping a copy of the old binary and running
+#   common/scripts/lab_startup.py --against <old binary> -- <new binary> [flags]
+# Stage only programs from the same set: `./ns3 build` compiles everything
+# in scratch/.
+#
+# WARNING: --configure rewrites the configuration of the SHARED ns-3 tree
+# ($NS3_DIR). Every other lab built from that tree afterwards only gets these
+# modules, and programs that need others stop compiling. Put it back with
+#   (cd $NS3_DIR && ./ns3 configure --enable-modules="")
+# or point NS3_DIR at a separate copy of ns-3 for the trimmed build.
+#
+# Usage: scripts/lab_modules.sh <lab.cc>... [--configure]
+#   e.g.: scripts/lab_modules.sh Lab-02-WiFiPerformance/code/*.cc --configure
+set -euo pipefail
+
+repo="$(cd "$(dirname "$0")/.." && pwd)"
+ns3dir="${NS3_DIR:-/opt/ns-allinone-3.40/ns-3.40}"
+configure=0
+queue=()
+
+while [ "$#" -gt 0 ]; do
+  case "$1" in
+    --configure) configure=1; shift;;
+    *) queue+=("$1"); shift;;
+  esac
+done
+
+if [ "${#queue[@]}" -eq 0 ]; then
+  echo "Usage: $0 <lab.cc>... [--configure]"
+  exit 1
+fi
+
+declare -A seen=() modules=()
+while [ "${#queue[@]}" -gt 0 ]; do
+  f="${queue[0]}"
+  queue=("${queue[@]:1}")
+  [ -n "${seen[$f]:-}" ] && continue
+  seen[$f]=1
+  while read -r inc; do
+    case "$inc" in
+      ns3/*-module.h) m="${inc#ns3/}"; modules[${m%-module.h}]=1;;
+      ns3/mpi-interface.h) modules[mpi]=1;;
+      lab-*.h) queue+=("$repo/common/include/$inc");;
+    esac
+  done < <(sed -n 's/^#include "\([^"]*\)".*/\1/p' "$f")
+done
+
+list="$(printf '%s\n' "${!modules[@]}" | sort | paste -sd ';' -)"
+echo "[modules] $list"
+if [ "$configure" -eq 1 ]; then
+  echo "[modules] WARNING: reconfiguring the shared tree $ns3dir: other labs built there"
+  echo "[modules]          lose every module not listed above until you run"
+  echo "[modules]          (cd $ns3dir && ./ns3 configure --enable-modules=\"\")"
+  cd "$ns3dir"
+  ./ns3 configure --enable-modules="$list"
+else
+  echo "[modules] to build only these: (cd $ns3dir && ./ns3 configure --enable-modules=\"$list\")"
+fi
@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+# Utility: stage_scratch
+# Copies one or more lab .cc files PLUS the shared headers in common/include/
+# into an ns-3 scratch directory, so `#include "lab-*.h"` resolves next to the
+# program.
+#
+# Usage: scripts/stage_scratch.sh <lab.cc>... [--dest <dir>]
+#   default dest: $NS3_DIR/scratch
+#   e.g.: scripts/stage_scratch.sh Lab-03-Adhoc/code/Lab3_Cpp_PayloadSweep.cc
+set -euo pipefail
+
+repo="$(cd "$(dirname "$0")/.." && pwd)"
+dest="${NS3_DIR:-/opt/ns-allinone-3.40/ns-3.40}/scratch"
+srcs=()
+
+while [ "$#" -gt 0 ]; do
+  case "$1" in
+    --dest) dest="$2"; shift 2;;
+    *) srcs+=("$1"); shift;;
+  esac
+done
+
+if [ "${#srcs[@]}" -eq 0 ]; then
+  echo "Usage: $0 <lab.cc>... [--dest <dir>]"
+  exit 1
+fi
+
+mkdir -p "$dest"
+cp "$repo"/common/include/*.h "$dest"/
+for s in "${srcs[@]}"; do
+  cp "$s" "$dest"/
+  echo "[stage] $(basename "$s") -> $dest"
+done
+echo "[stage] shared headers -> $dest ($(ls "$repo"/common/include/*.h | wc -l) files)"